@@ -31,6 +31,19 @@ ast_node *ast_node_create_postfix_op(ast_postfix_op_type type,
 	return retval;
 }
 
+ast_node *ast_node_create_prefix_op(ast_prefix_op_type type, ast_node *id)
+{
+	ast_node* retval = malloc(sizeof(ast_node));
+	retval->type = AST_NODE_TYPE_PREFIX;
+	retval->u1.prefix_node.type = type;
+	retval->u1.prefix_node.expr = ast_node_create_binary_op(
+		AST_BINARY_OP_ASSIGN, id, ast_node_create_binary_op(
+			type == AST_PREFIX_OP_INC ? AST_BINARY_OP_ADD : AST_BINARY_OP_MINUS,
+			ast_node_create_id(AST_NODE_AS_ID(id)), 
+			ast_node_create_number(1L)));
+	return retval;
+}
+
 ast_node *ast_node_create_unary_op(ast_unary_op_type type, ast_node *expr)
 {
 	ast_node* retval = malloc(sizeof(ast_node));
@@ -149,6 +162,24 @@ extern ast_node *ast_node_create_for(ast_node *initialization,
 	return retval;	
 }
 
+ast_node *ast_node_create_switch(ast_node *expr, ast_node *cases)
+{
+	ast_node* retval = malloc(sizeof(ast_node));
+	retval->type = AST_NODE_TYPE_SWITCH;
+	retval->u1.switch_node.expr = expr;
+	retval->u1.switch_node.cases = cases;
+	return retval;
+}
+
+ast_node *ast_node_create_case(ast_node *labels, ast_node *body)
+{
+	ast_node* retval = malloc(sizeof(ast_node));
+	retval->type = AST_NODE_TYPE_CASE;
+	retval->u1.case_node.labels = labels;
+	retval->u1.case_node.body = body;
+	return retval;
+}
+
 ast_node* ast_node_create_function(const char* name, ast_node* parameters, ast_node* body)
 {
 	ast_node* retval = malloc(sizeof(ast_node));
@@ -159,6 +190,9 @@ ast_node* ast_node_create_function(const char* name, ast_node* parameters, ast_n
 	memcpy(retval->u1.function_node.name, name, len + 1);
 	retval->u1.function_node.parameter_list = parameters;
 	retval->u1.function_node.body = body;	
+	retval->u1.function_node.nested = NULL;
+	retval->u1.function_node.body_offset = 0;
+	retval->u1.function_node.body_length = 0;
 	return retval;
 }
 
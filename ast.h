@@ -31,13 +31,18 @@ typedef enum {
 	AST_NODE_TYPE_STATEMENT_LIST, AST_NODE_TYPE_BIN_OP,
 	AST_NODE_TYPE_IF, AST_NODE_TYPE_WHILE, AST_NODE_TYPE_FUNC_DECL, 
 	AST_NODE_TYPE_CALL, AST_NODE_TYPE_RET, AST_NODE_TYPE_PRINT,
-	AST_NODE_TYPE_UNARY_OP, AST_NODE_TYPE_POSTFIX,
+	AST_NODE_TYPE_UNARY_OP, AST_NODE_TYPE_POSTFIX, AST_NODE_TYPE_PREFIX,
+	AST_NODE_TYPE_SWITCH, AST_NODE_TYPE_CASE,
 } ast_node_type;
 
 typedef enum {
 	AST_POSTFIX_OP_INC, AST_POSTFIX_OP_DEC,
 } ast_postfix_op_type;
 
+typedef enum {
+	AST_PREFIX_OP_INC, AST_PREFIX_OP_DEC,
+} ast_prefix_op_type;
+
 typedef enum {
 	AST_UNARY_OP_MINUS,
 } ast_unary_op_type;
@@ -81,6 +86,15 @@ typedef struct {
 	ast_node *expr;
 } ast_node_postfix;
 
+/* 
+ * ++i, expr is the assignment i = i + 1 it stands for, whose value is
+ * the value of ++i
+ */
+typedef struct {
+	ast_prefix_op_type type;
+	ast_node *expr;
+} ast_node_prefix;
+
 typedef struct {
 	ast_node* condition;
 	ast_node* b1;
@@ -92,6 +106,21 @@ typedef struct {
 	ast_node* body;
 } ast_node_while;
 
+/* 
+ * switch(expr) { case 1, 2: ... default: ... }, cases is a statement list
+ * of AST_NODE_TYPE_CASE. Only the statements of the matching case run
+ */
+typedef struct {
+	ast_node *expr;
+	ast_node *cases;
+} ast_node_switch;
+
+/* labels is a statement list of numbers and strings, NULL for default */
+typedef struct {
+	ast_node *labels;
+	ast_node *body;
+} ast_node_case;
+
 typedef struct {
 	ast_node *initialization;
 	ast_node *condition;
@@ -105,6 +134,13 @@ typedef struct {
 	size_t name_length;
 	ast_node* parameter_list;
 	ast_node* body;	
+	/* 
+	 * With --lazy the body is dropped once parsed, only its location in the
+	 * source is kept, along with the functions declared inside of it 
+	 */
+	ast_node* nested;
+	size_t body_offset;
+	size_t body_length;
 } ast_node_function;
 
 typedef struct {
@@ -137,11 +173,14 @@ struct ast_node {
 		ast_node_if		      if_node;
 		ast_node_while		  while_node;
 		ast_node_for          for_node;
+		ast_node_switch       switch_node;
+		ast_node_case         case_node;
 		ast_node_function     function_node;
 		ast_node_call         call_node;
 		ast_node_return		  return_node;
 		ast_node_print		  print_node;
 		ast_node_postfix      postfix_node;
+		ast_node_prefix       prefix_node;
 	} u1;
 };
 
@@ -149,6 +188,8 @@ struct ast_node {
 
 extern ast_node *ast_node_create_postfix_op(ast_postfix_op_type type,
 		ast_node *expression);
+extern ast_node *ast_node_create_prefix_op(ast_prefix_op_type type,
+		ast_node *id);
 extern ast_node *ast_node_create_unary_op(ast_unary_op_type, ast_node *);
 extern ast_node *ast_node_create_number(long value);
 extern ast_node *ast_node_create_statement_list(size_t count, ...);
@@ -163,6 +204,9 @@ extern ast_node *ast_node_create_while(ast_node *condition, ast_node *body);
 extern ast_node *ast_node_create_for(ast_node *initialization, 
 		ast_node *condition, ast_node *final_expression, ast_node *body);
 
+extern ast_node *ast_node_create_switch(ast_node *expr, ast_node *cases);
+extern ast_node *ast_node_create_case(ast_node *labels, ast_node *body);
+
 extern ast_node *ast_node_create_function(const char *name, 
 		ast_node *parameters, ast_node *body);
 extern ast_node *ast_node_create_call(ast_node *id, ast_node *arguments, 
@@ -18,6 +18,10 @@ void ast_node_free(ast_node* p)
 			ast_node_free(p->u1.postfix_node.expr);
 			free(p);
 		break;
+		case AST_NODE_TYPE_PREFIX:
+			ast_node_free(p->u1.prefix_node.expr);
+			free(p);
+		break;
 		case AST_NODE_TYPE_WHILE:
 			ast_node_free(p->u1.while_node.condition);
 			ast_node_free(p->u1.while_node.body);
@@ -30,6 +34,16 @@ void ast_node_free(ast_node* p)
 			ast_node_free(p->u1.for_node.body);	
 			free(p);
 		break;
+		case AST_NODE_TYPE_SWITCH:
+			ast_node_free(p->u1.switch_node.expr);
+			ast_node_free(p->u1.switch_node.cases);
+			free(p);
+		break;
+		case AST_NODE_TYPE_CASE:
+			ast_node_free(p->u1.case_node.labels);
+			ast_node_free(p->u1.case_node.body);
+			free(p);
+		break;
 		case AST_NODE_TYPE_STRING:
 			free(p->u1.string_value.value);
 			free(p);
@@ -69,6 +83,7 @@ void ast_node_free(ast_node* p)
 			free(p->u1.function_node.name);
 			ast_node_free(p->u1.function_node.parameter_list);
 			ast_node_free(p->u1.function_node.body);
+			ast_node_free(p->u1.function_node.nested);
 			free(p);		
 		break;
 		case AST_NODE_TYPE_PRINT:
@@ -20,6 +20,7 @@
 #include <easyio.h>
 #include <object.h>
 #include <assert.h>
+#include <unistd.h>
 
 #include "ast.h"
 #include "stack.h"
@@ -33,14 +34,154 @@
 
 int yyparse(ast_node** ast, yyscan_t scanner);
 
+static void usage(const char *name)
+{
+	printf("Usage: %s [options] FILE\n", name);
+	printf("Options:\n");
+	printf("  --stream      execute each top level statement as soon as it is parsed\n");
+	printf("  --lazy        parse and compile function bodies when first called\n");
+	printf("  --lazy-stats  with --lazy, report functions that were never called\n");
+	printf("  --jobs N      compile function bodies on N threads, 0 for one per CPU\n");
+	printf("  --no-quicken  don't specialize instructions for the types they see\n");
+	printf("  --quicken-stats\n");
+	printf("                report generic and quickened executions per opcode\n");
+	printf("  --no-jit      never compile functions to native code\n");
+	printf("  --jit-threshold N\n");
+	printf("                compile a function to native code on its Nth call\n");
+	printf("  --jit-stats   report the functions compiled to native code\n");
+	printf("  --no-trace    never record traces of hot loops\n");
+	printf("  --trace-stats report traces recorded, entered and exited\n");
+	printf("  --emit-c FILE translate the script to C, see libcomo_runtime.a\n");
+	printf("  --engine NAME run the script on the stack VM, \"bytecode\" (the default),\n");
+	printf("                compiled into closures, \"closure\", or on the register\n");
+	printf("                VM, \"register\"\n");
+	printf("  --register-stats\n");
+	printf("                report instructions compiled and executed per function\n");
+	printf("  --register-dump\n");
+	printf("                print the register bytecode before running it\n");
+	printf("  --ssa         with --engine register, optimize functions in SSA form\n");
+	printf("                before generating their code\n");
+	printf("  --ssa-dump    print the optimized SSA form of every function\n");
+	printf("  --dump-types  print the register bytecode with the type --ssa inferred\n");
+	printf("                for the result of every instruction\n");
+	printf("  --inline-limit N\n");
+	printf("                with --ssa, inline functions of up to N instructions,\n");
+	printf("                0 for none (default %d)\n", COMO_DEFAULT_INLINE_LIMIT);
+	printf("  --inline-report\n");
+	printf("                report every call --ssa inlined or didn't, and why\n");
+	printf("  -O0, -O1, -O2 optimize nothing, each function on its own, or the whole\n");
+	printf("                program, only compiling functions it may call (default -O%d)\n",
+		COMO_DEFAULT_OPT_LEVEL);
+	printf("  --time-passes report the time and instructions added or removed per\n");
+	printf("                optimization pass\n");
+	printf("  --profile FILE\n");
+	printf("                start from the type feedback in FILE, and save it there\n");
+}
+
 int main(int argc, char** argv)
 {
-	if(argc < 2) {
-		printf("Usage: ./%s FILE\n", argv[0]);
+	int i;
+	const char *filename = NULL;
+
+	como_options.jit_threshold = COMO_DEFAULT_JIT_THRESHOLD;
+	como_options.inline_limit = COMO_DEFAULT_INLINE_LIMIT;
+	como_options.opt_level = COMO_DEFAULT_OPT_LEVEL;
+
+	for(i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "--stream") == 0) {
+			como_options.stream = 1;
+		} else if(strcmp(argv[i], "--lazy") == 0) {
+			como_options.lazy = 1;
+		} else if(strcmp(argv[i], "--lazy-stats") == 0) {
+			como_options.lazy_stats = 1;
+		} else if(strcmp(argv[i], "--no-quicken") == 0) {
+			como_options.no_quicken = 1;
+		} else if(strcmp(argv[i], "--quicken-stats") == 0) {
+			como_options.quicken_stats = 1;
+		} else if(strcmp(argv[i], "--no-jit") == 0) {
+			como_options.no_jit = 1;
+		} else if(strcmp(argv[i], "--no-trace") == 0) {
+			como_options.no_trace = 1;
+		} else if(strcmp(argv[i], "--trace-stats") == 0) {
+			como_options.trace_stats = 1;
+		} else if(strcmp(argv[i], "--register-stats") == 0) {
+			como_options.register_stats = 1;
+		} else if(strcmp(argv[i], "--register-dump") == 0) {
+			como_options.register_dump = 1;
+		} else if(strcmp(argv[i], "--ssa") == 0) {
+			como_options.ssa = 1;
+		} else if(strcmp(argv[i], "--ssa-dump") == 0) {
+			como_options.ssa_dump = 1;
+		} else if(strcmp(argv[i], "--dump-types") == 0) {
+			como_options.dump_types = 1;
+			como_options.register_dump = 1;
+		} else if(strcmp(argv[i], "--inline-limit") == 0 && i + 1 < argc) {
+			como_options.inline_limit = atol(argv[++i]);
+			if(como_options.inline_limit < 0) {
+				como_options.inline_limit = 0;
+			}
+		} else if(strcmp(argv[i], "--inline-report") == 0) {
+			como_options.inline_report = 1;
+		} else if(strcmp(argv[i], "--jit-stats") == 0) {
+			como_options.jit_stats = 1;
+		} else if(strcmp(argv[i], "--jit-threshold") == 0 && i + 1 < argc) {
+			como_options.jit_threshold = atol(argv[++i]);
+			if(como_options.jit_threshold < 1) {
+				como_options.jit_threshold = 1;
+			}
+		} else if(strcmp(argv[i], "--emit-c") == 0 && i + 1 < argc) {
+			como_options.emit_c = argv[++i];
+		} else if(strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+			i++;
+			if(strcmp(argv[i], "bytecode") == 0) {
+				como_options.engine = COMO_ENGINE_BYTECODE;
+			} else if(strcmp(argv[i], "closure") == 0) {
+				como_options.engine = COMO_ENGINE_CLOSURE;
+			} else if(strcmp(argv[i], "register") == 0) {
+				como_options.engine = COMO_ENGINE_REGISTER;
+			} else {
+				printf("unknown engine '%s'\n", argv[i]);
+				usage(argv[0]);
+				return 1;
+			}
+		} else if(strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+			como_options.profile = argv[++i];
+		} else if(strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+			como_options.jobs = atoi(argv[++i]);
+			if(como_options.jobs <= 0) {
+				como_options.jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+			}
+		} else if(strncmp(argv[i], "-O", 2) == 0) {
+			if(argv[i][2] == '\0') {
+				como_options.opt_level = 1;
+			} else if(strspn(argv[i] + 2, "0123456789") 
+					!= strlen(argv[i] + 2)) {
+				printf("invalid optimization level '%s'\n", argv[i]);
+				usage(argv[0]);
+				return 1;
+			} else {
+				como_options.opt_level = atoi(argv[i] + 2);
+			}
+			if(como_options.opt_level > 2) {
+				como_options.opt_level = 2;
+			}
+		} else if(strcmp(argv[i], "--time-passes") == 0) {
+			como_options.time_passes = 1;
+		} else if(argv[i][0] == '-' && argv[i][1] == '-') {
+			printf("unknown option '%s'\n", argv[i]);
+			usage(argv[0]);
+			return 1;
+		} else {
+			filename = argv[i];
+		}
+	}
+
+	if(filename == NULL) {
+		usage(argv[0]);
 		return 0;
 	}
 
-	return como_ast_create(argv[1]);
+	return como_ast_create(filename);
 }
 
 
@@ -0,0 +1,747 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "ast.h"
+#include "comodebug.h"
+#include "como_runtime.h"
+#include "como_compiler_ex.h"
+
+/*
+ * The closure engine, --engine closure. Instead of bytecode, every node
+ * of the AST is compiled into a ComoClosure: a C function bound to its
+ * children and to whatever it can work out up front. Running the program
+ * is calling the root closure, which calls its children in turn.
+ *
+ * Names are resolved while compiling, the same way --emit-c resolves
+ * them: each name a scope assigns gets a cell, and a closure reading a
+ * name is bound to the cells it can be found in. Function cells outlive
+ * a call, like the symbol table of a ComoFrame does. Operands are read
+ * through accessors specialized on where they come from (a constant, a
+ * function's own cell, a top level cell, or both), and arithmetic and
+ * comparisons on longs are done inline, before falling back to
+ * como_runtime.c for everything else.
+ */
+
+typedef struct ComoClosure ComoClosure;
+
+/* An expression, returns its value */
+typedef Object *(*como_closure_expr_t)(ComoClosure *);
+
+/* A statement, returns 1 once a return statement ran, with its value */
+typedef int (*como_closure_stmt_t)(ComoClosure *, Object **);
+
+struct ComoClosure {
+	como_closure_expr_t   expr;
+	como_closure_stmt_t   stmt;
+	ComoClosure          *a;        /* operands, condition, initialization */
+	ComoClosure          *b;        /* right operand, body, first branch */
+	ComoClosure          *c;        /* else branch, final expression */
+	ComoClosure         **list;     /* statements, call arguments */
+	size_t                count;
+	Object               *value;    /* a constant */
+	long                  lval;     /* a long constant operand */
+	Object              **slot;     /* own cell of a name */
+	Object              **global;   /* top level cell of a name */
+	const char           *name;
+	Object             *(*op)(Object *, Object *);
+};
+
+/* Bound to the name of a function, as a pointer Object */
+typedef struct ComoClosureFunction {
+	const char    *name;
+	size_t         parameters;
+	Object      ***cells;           /* cell of each parameter */
+	Object       **function_name;   /* cell of __FUNCTION__ */
+	Object        *name_value;
+	ComoClosure   *body;
+} ComoClosureFunction;
+
+typedef struct ComoClosureCompiler {
+	Object  *globals;               /* Map, name to its top level cell */
+	Object  *locals;                /* Map, cells of the function compiled */
+	Object  *functions;             /* Array of FUNC_DECL, in binding order */
+	Object  *function_locals;       /* Array, the locals Map of each */
+	Object  *allocations;           /* Array, everything to free at exit */
+} ComoClosureCompiler;
+
+static void *closure_alloc(ComoClosureCompiler *cc, size_t size)
+{
+	void *p = calloc(1, size);
+	arrayPushEx(cc->allocations, newPointer(p));
+	return p;
+}
+
+static ComoClosure *new_closure(ComoClosureCompiler *cc)
+{
+	return closure_alloc(cc, sizeof(ComoClosure));
+}
+
+static Object **cell(ComoClosureCompiler *cc, Object *names, const char *name)
+{
+	Object *value = mapSearch(names, name);
+
+	if(value == NULL) {
+		value = newPointer(closure_alloc(cc, sizeof(Object *)));
+		mapInsertEx(names, name, value);
+	}
+
+	return (Object **)O_PTVAL(value);
+}
+
+static Object **find_cell(Object *names, const char *name)
+{
+	Object *value;
+
+	if(names == NULL || (value = mapSearch(names, name)) == NULL) {
+		return NULL;
+	}
+
+	return (Object **)O_PTVAL(value);
+}
+
+/*
+ * Gives every name a scope assigns its cell, and finds the functions
+ * declared in it. Nested functions are bound before the function
+ * declaring them, like como_compile_function does
+ */
+static void collect(ComoClosureCompiler *cc, ast_node *p, Object *names)
+{
+	size_t i;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				collect(cc, p->u1.statements_node.statement_list[i], names);
+			}
+		break;
+		case AST_NODE_TYPE_BIN_OP:
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				cell(cc, names, AST_NODE_AS_ID(p->u1.binary_node.left));
+			} else {
+				collect(cc, p->u1.binary_node.left, names);
+			}
+			collect(cc, p->u1.binary_node.right, names);
+		break;
+		case AST_NODE_TYPE_POSTFIX:
+			cell(cc, names, AST_NODE_AS_ID(p->u1.postfix_node.expr));
+		break;
+		case AST_NODE_TYPE_PREFIX:
+			collect(cc, p->u1.prefix_node.expr, names);
+		break;
+		case AST_NODE_TYPE_UNARY_OP:
+			collect(cc, p->u1.unary_node.expr, names);
+		break;
+		case AST_NODE_TYPE_CALL:
+			collect(cc, p->u1.call_node.arguments, names);
+		break;
+		case AST_NODE_TYPE_RET:
+			collect(cc, p->u1.return_node.expr, names);
+		break;
+		case AST_NODE_TYPE_PRINT:
+			collect(cc, p->u1.print_node.expr, names);
+		break;
+		case AST_NODE_TYPE_IF:
+			collect(cc, p->u1.if_node.condition, names);
+			collect(cc, p->u1.if_node.b1, names);
+			collect(cc, p->u1.if_node.b2, names);
+		break;
+		case AST_NODE_TYPE_WHILE:
+			collect(cc, p->u1.while_node.condition, names);
+			collect(cc, p->u1.while_node.body, names);
+		break;
+		case AST_NODE_TYPE_FOR:
+			collect(cc, p->u1.for_node.initialization, names);
+			collect(cc, p->u1.for_node.condition, names);
+			collect(cc, p->u1.for_node.final_expression, names);
+			collect(cc, p->u1.for_node.body, names);
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			collect(cc, p->u1.switch_node.expr, names);
+			collect(cc, p->u1.switch_node.cases, names);
+		break;
+		case AST_NODE_TYPE_CASE:
+			collect(cc, p->u1.case_node.body, names);
+		break;
+		case AST_NODE_TYPE_FUNC_DECL: {
+			Object *locals = newMap(8);
+			ast_node *parameters = p->u1.function_node.parameter_list;
+
+			for(i = 0; i < parameters->u1.statements_node.count; i++) {
+				cell(cc, locals, AST_NODE_AS_ID(
+					parameters->u1.statements_node.statement_list[i]));
+			}
+			cell(cc, locals, "__FUNCTION__");
+
+			collect(cc, p->u1.function_node.body, locals);
+
+			arrayPushEx(cc->functions, newPointer((void *)p));
+			arrayPushEx(cc->function_locals, locals);
+			cell(cc, cc->globals, p->u1.function_node.name);
+		}
+		break;
+		default:
+		break;
+	}
+}
+
+/* Operand accessors, LOAD_NAME split up by where the name can be found */
+
+static Object *load_constant(ComoClosure *c)
+{
+	return c->value;
+}
+
+static Object *load_local(ComoClosure *c)
+{
+	return *c->slot != NULL ? *c->slot : como_rt_undefined(c->name);
+}
+
+static Object *load_global(ComoClosure *c)
+{
+	return *c->global != NULL ? *c->global : como_rt_undefined(c->name);
+}
+
+static Object *load_local_or_global(ComoClosure *c)
+{
+	if(*c->slot != NULL) {
+		return *c->slot;
+	}
+	return *c->global != NULL ? *c->global : como_rt_undefined(c->name);
+}
+
+static Object *load_undefined(ComoClosure *c)
+{
+	return como_rt_undefined(c->name);
+}
+
+static Object *store(ComoClosure *c)
+{
+	return *c->slot = c->a->expr(c->a);
+}
+
+static Object *postfix(ComoClosure *c)
+{
+	Object *value = *c->slot;
+	*c->slot = como_rt_step(value, c->lval, c->name);
+	return value;
+}
+
+static Object *unary_minus(ComoClosure *c)
+{
+	return como_rt_unary_minus(c->a->expr(c->a));
+}
+
+static Object *binary(ComoClosure *c)
+{
+	Object *left = c->a->expr(c->a);
+	Object *right = c->b->expr(c->b);
+	return c->op(left, right);
+}
+
+/*
+ * Binary operators with an inline path for two longs. The _k form has a
+ * long constant on the right, taken from lval
+ */
+#define CLOSURE_BINARY_LONG(name, result) \
+static Object *name(ComoClosure *c) \
+{ \
+	Object *left = c->a->expr(c->a); \
+	Object *right = c->b->expr(c->b); \
+	if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) { \
+		long l = O_LVAL(left), r = O_LVAL(right); \
+		return newLong(result); \
+	} \
+	return c->op(left, right); \
+} \
+static Object *name##_k(ComoClosure *c) \
+{ \
+	Object *left = c->a->expr(c->a); \
+	if(O_TYPE(left) == IS_LONG) { \
+		long l = O_LVAL(left), r = c->lval; \
+		return newLong(result); \
+	} \
+	return c->op(left, c->b->value); \
+}
+
+CLOSURE_BINARY_LONG(add_long, l + r)
+CLOSURE_BINARY_LONG(minus_long, l - r)
+CLOSURE_BINARY_LONG(times_long, l * r)
+CLOSURE_BINARY_LONG(less_than_long, (long)(l < r))
+CLOSURE_BINARY_LONG(less_than_or_equal_long, (long)(l <= r))
+CLOSURE_BINARY_LONG(greater_than_long, (long)(l > r))
+CLOSURE_BINARY_LONG(greater_than_or_equal_long, (long)(l >= r))
+CLOSURE_BINARY_LONG(equal_long, (long)(l == r))
+CLOSURE_BINARY_LONG(not_equal_long, (long)(l != r))
+
+static Object *call(ComoClosure *c)
+{
+	Object *args[c->count + 1];
+	ComoClosureFunction *fn;
+	Object *callee, *result = NULL;
+	size_t i;
+
+	for(i = 0; i < c->count; i++) {
+		args[i] = c->list[i]->expr(c->list[i]);
+	}
+
+	callee = c->a->expr(c->a);
+
+	if(O_TYPE(callee) != IS_POINTER) {
+		como_error_noreturn("name '%s' is not callable", c->name);
+	}
+
+	fn = (ComoClosureFunction *)O_PTVAL(callee);
+
+	if(c->count != fn->parameters) {
+		como_error_noreturn("callable '%s' expects %ld arguments, "
+			"but %ld were given", c->name, (long)fn->parameters,
+			(long)c->count);
+	}
+
+	/* CALL_FUNCTION binds the last argument first */
+	for(i = c->count; i-- > 0; ) {
+		*fn->cells[i] = args[i];
+	}
+	*fn->function_name = fn->name_value;
+
+	if(fn->body->stmt(fn->body, &result)) {
+		return result;
+	}
+
+	return newLong(0L);
+}
+
+static int statement_list(ComoClosure *c, Object **result)
+{
+	size_t i;
+
+	for(i = 0; i < c->count; i++) {
+		if(c->list[i]->stmt(c->list[i], result)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int statement_expression(ComoClosure *c, Object **result)
+{
+	(void)result;
+	c->a->expr(c->a);
+	return 0;
+}
+
+static int statement_nothing(ComoClosure *c, Object **result)
+{
+	(void)c;
+	(void)result;
+	return 0;
+}
+
+static int statement_print(ComoClosure *c, Object **result)
+{
+	(void)result;
+	como_rt_print(c->a->expr(c->a));
+	return 0;
+}
+
+static int statement_return(ComoClosure *c, Object **result)
+{
+	*result = c->a != NULL ? c->a->expr(c->a) : newLong(0L);
+	return 1;
+}
+
+static int statement_if(ComoClosure *c, Object **result)
+{
+	if(!como_rt_is_false(c->a->expr(c->a))) {
+		return c->b->stmt(c->b, result);
+	}
+	return c->c != NULL ? c->c->stmt(c->c, result) : 0;
+}
+
+static int statement_while(ComoClosure *c, Object **result)
+{
+	while(!como_rt_is_false(c->a->expr(c->a))) {
+		if(c->b->stmt(c->b, result)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int statement_for(ComoClosure *c, Object **result)
+{
+	if(c->list[0]->stmt(c->list[0], result)) {
+		return 1;
+	}
+	while(!como_rt_is_false(c->a->expr(c->a))) {
+		if(c->b->stmt(c->b, result) || c->c->stmt(c->c, result)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* 
+ * The body of the case como_rt_switch finds in the table in value, or of
+ * the default, whose index is lval, -1 if there is none
+ */
+static int statement_switch(ComoClosure *c, Object **result)
+{
+	long index = como_rt_switch(c->value, c->a->expr(c->a));
+
+	if(index < 0) {
+		index = c->lval;
+	}
+
+	return index >= 0 ? c->list[index]->stmt(c->list[index], result) : 0;
+}
+
+static ComoClosure *compile_expression(ComoClosureCompiler *cc, ast_node *p);
+static ComoClosure *compile_statement(ComoClosureCompiler *cc, ast_node *p);
+
+static ComoClosure *compile_load(ComoClosureCompiler *cc, const char *name)
+{
+	ComoClosure *c = new_closure(cc);
+
+	c->name = name;
+	c->slot = find_cell(cc->locals, name);
+	c->global = find_cell(cc->globals, name);
+
+	if(c->slot != NULL && c->global != NULL) {
+		c->expr = load_local_or_global;
+	} else if(c->slot != NULL) {
+		c->expr = load_local;
+	} else if(c->global != NULL) {
+		c->expr = load_global;
+	} else {
+		c->expr = load_undefined;
+	}
+
+	return c;
+}
+
+/* The cell a name in the scope being compiled is stored to */
+static Object **store_cell(ComoClosureCompiler *cc, const char *name)
+{
+	return cell(cc, cc->locals != NULL ? cc->locals : cc->globals, name);
+}
+
+static void compile_binary(ComoClosureCompiler *cc, ComoClosure *c,
+	ast_node *p)
+{
+	como_closure_expr_t generic = NULL, constant = NULL;
+
+	c->a = compile_expression(cc, p->u1.binary_node.left);
+	c->b = compile_expression(cc, p->u1.binary_node.right);
+
+	switch(p->u1.binary_node.type) {
+		case AST_BINARY_OP_ADD:
+			c->op = como_rt_add;
+			generic = add_long;
+			constant = add_long_k;
+		break;
+		case AST_BINARY_OP_MINUS:
+			c->op = como_rt_minus;
+			generic = minus_long;
+			constant = minus_long_k;
+		break;
+		case AST_BINARY_OP_TIMES:
+			c->op = como_rt_times;
+			generic = times_long;
+			constant = times_long_k;
+		break;
+		case AST_BINARY_OP_DIV:
+			c->op = como_rt_div;
+		break;
+		case AST_BINARY_OP_REM:
+			c->op = como_rt_rem;
+		break;
+		case AST_BINARY_OP_LT:
+			c->op = como_rt_is_less_than;
+			generic = less_than_long;
+			constant = less_than_long_k;
+		break;
+		case AST_BINARY_OP_LTE:
+			c->op = como_rt_is_less_than_or_equal;
+			generic = less_than_or_equal_long;
+			constant = less_than_or_equal_long_k;
+		break;
+		case AST_BINARY_OP_GT:
+			c->op = como_rt_is_greater_than;
+			generic = greater_than_long;
+			constant = greater_than_long_k;
+		break;
+		case AST_BINARY_OP_GTE:
+			c->op = como_rt_is_greater_than_or_equal;
+			generic = greater_than_or_equal_long;
+			constant = greater_than_or_equal_long_k;
+		break;
+		case AST_BINARY_OP_CMP:
+			c->op = como_rt_is_equal;
+			generic = equal_long;
+			constant = equal_long_k;
+		break;
+		case AST_BINARY_OP_NEQ:
+			c->op = como_rt_is_not_equal;
+			generic = not_equal_long;
+			constant = not_equal_long_k;
+		break;
+		default:
+			como_error_noreturn("--engine closure: unknown binary operator %d",
+				p->u1.binary_node.type);
+	}
+
+	if(generic == NULL) {
+		c->expr = binary;
+	} else if(p->u1.binary_node.right->type == AST_NODE_TYPE_NUMBER) {
+		c->lval = p->u1.binary_node.right->u1.number_value;
+		c->expr = constant;
+	} else {
+		c->expr = generic;
+	}
+}
+
+static ComoClosure *compile_expression(ComoClosureCompiler *cc, ast_node *p)
+{
+	ComoClosure *c;
+	size_t i;
+
+	switch(p->type) {
+		case AST_NODE_TYPE_NUMBER:
+			c = new_closure(cc);
+			c->expr = load_constant;
+			c->value = newLong(p->u1.number_value);
+		return c;
+		case AST_NODE_TYPE_STRING:
+			c = new_closure(cc);
+			c->expr = load_constant;
+			c->value = newString(p->u1.string_value.value);
+		return c;
+		case AST_NODE_TYPE_ID:
+			return compile_load(cc, AST_NODE_AS_ID(p));
+		case AST_NODE_TYPE_UNARY_OP:
+			c = new_closure(cc);
+			c->expr = unary_minus;
+			c->a = compile_expression(cc, p->u1.unary_node.expr);
+		return c;
+		case AST_NODE_TYPE_POSTFIX:
+			c = new_closure(cc);
+			c->expr = postfix;
+			c->name = AST_NODE_AS_ID(p->u1.postfix_node.expr);
+			c->slot = store_cell(cc, c->name);
+			c->lval = p->u1.postfix_node.type == AST_POSTFIX_OP_INC ? 1 : -1;
+		return c;
+		case AST_NODE_TYPE_PREFIX:
+			/* The assignment it stands for, store returns what it stored */
+			return compile_expression(cc, p->u1.prefix_node.expr);
+		case AST_NODE_TYPE_BIN_OP:
+			c = new_closure(cc);
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				c->expr = store;
+				c->slot = store_cell(cc, AST_NODE_AS_ID(p->u1.binary_node.left));
+				c->a = compile_expression(cc, p->u1.binary_node.right);
+			} else {
+				compile_binary(cc, c, p);
+			}
+		return c;
+		case AST_NODE_TYPE_CALL: {
+			ast_node_statements *arguments =
+				&p->u1.call_node.arguments->u1.statements_node;
+
+			c = new_closure(cc);
+			c->expr = call;
+			c->name = AST_NODE_AS_ID(p->u1.call_node.id);
+			c->count = arguments->count;
+			c->list = closure_alloc(cc, sizeof(ComoClosure *)
+				* (arguments->count + 1));
+
+			for(i = 0; i < arguments->count; i++) {
+				c->list[i] = compile_expression(cc, arguments->statement_list[i]);
+			}
+
+			c->a = compile_load(cc, c->name);
+			return c;
+		}
+		default:
+			como_error_noreturn("--engine closure: node type %d isn't an "
+				"expression", p->type);
+	}
+}
+
+static ComoClosure *compile_statement(ComoClosureCompiler *cc, ast_node *p)
+{
+	ComoClosure *c = new_closure(cc);
+	size_t i;
+
+	if(p == NULL) {
+		c->stmt = statement_nothing;
+		return c;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			c->stmt = statement_list;
+			c->list = closure_alloc(cc, sizeof(ComoClosure *)
+				* (p->u1.statements_node.count + 1));
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				ast_node *stmt = p->u1.statements_node.statement_list[i];
+				if(stmt != NULL) {
+					c->list[c->count++] = compile_statement(cc, stmt);
+				}
+			}
+		break;
+		/* Bound before the top level code runs, see como_closure_run */
+		case AST_NODE_TYPE_FUNC_DECL:
+			c->stmt = statement_nothing;
+		break;
+		case AST_NODE_TYPE_PRINT:
+			c->stmt = statement_print;
+			c->a = compile_expression(cc, p->u1.print_node.expr);
+		break;
+		case AST_NODE_TYPE_RET:
+			c->stmt = statement_return;
+			if(p->u1.return_node.expr != NULL) {
+				c->a = compile_expression(cc, p->u1.return_node.expr);
+			}
+		break;
+		case AST_NODE_TYPE_IF:
+			c->stmt = statement_if;
+			c->a = compile_expression(cc, p->u1.if_node.condition);
+			c->b = compile_statement(cc, p->u1.if_node.b1);
+			if(p->u1.if_node.b2 != NULL) {
+				c->c = compile_statement(cc, p->u1.if_node.b2);
+			}
+		break;
+		case AST_NODE_TYPE_WHILE:
+			c->stmt = statement_while;
+			c->a = compile_expression(cc, p->u1.while_node.condition);
+			c->b = compile_statement(cc, p->u1.while_node.body);
+		break;
+		case AST_NODE_TYPE_FOR:
+			c->stmt = statement_for;
+			c->list = closure_alloc(cc, sizeof(ComoClosure *));
+			c->list[0] = compile_statement(cc, p->u1.for_node.initialization);
+			c->a = compile_expression(cc, p->u1.for_node.condition);
+			c->b = compile_statement(cc, p->u1.for_node.body);
+			c->c = compile_statement(cc, p->u1.for_node.final_expression);
+		break;
+		case AST_NODE_TYPE_SWITCH: {
+			ast_node_statements *cases =
+				&p->u1.switch_node.cases->u1.statements_node;
+
+			c->stmt = statement_switch;
+			c->a = compile_expression(cc, p->u1.switch_node.expr);
+			c->value = como_switch_table(p->u1.switch_node.cases);
+			c->lval = -1;
+			c->count = cases->count;
+			c->list = closure_alloc(cc, sizeof(ComoClosure *)
+				* (cases->count + 1));
+			for(i = 0; i < cases->count; i++) {
+				ast_node *node = cases->statement_list[i];
+				c->list[i] = compile_statement(cc, node->u1.case_node.body);
+				if(node->u1.case_node.labels == NULL) {
+					c->lval = (long)i;
+				}
+			}
+		}
+		break;
+		default:
+			c->stmt = statement_expression;
+			c->a = compile_expression(cc, p);
+		break;
+	}
+
+	return c;
+}
+
+static ComoClosureFunction *compile_function(ComoClosureCompiler *cc,
+	size_t index)
+{
+	ast_node *p = (ast_node *)O_PTVAL(O_AVAL(cc->functions)->table[index]);
+	ast_node_statements *parameters =
+		&p->u1.function_node.parameter_list->u1.statements_node;
+	ComoClosureFunction *fn = closure_alloc(cc, sizeof(ComoClosureFunction));
+	size_t i;
+
+	cc->locals = O_AVAL(cc->function_locals)->table[index];
+
+	fn->name = p->u1.function_node.name;
+	fn->parameters = parameters->count;
+	fn->cells = closure_alloc(cc, sizeof(Object **) * (parameters->count + 1));
+	for(i = 0; i < parameters->count; i++) {
+		fn->cells[i] = cell(cc, cc->locals,
+			AST_NODE_AS_ID(parameters->statement_list[i]));
+	}
+	fn->function_name = cell(cc, cc->locals, "__FUNCTION__");
+	fn->name_value = newString(fn->name);
+	fn->body = compile_statement(cc, p->u1.function_node.body);
+
+	cc->locals = NULL;
+
+	return fn;
+}
+
+int como_closure_run(ast_node *program)
+{
+	ComoClosureCompiler cc;
+	ComoClosure *main_closure;
+	Object *result = NULL;
+	Array *functions, *allocations;
+	size_t i;
+
+	cc.globals = newMap(16);
+	cc.locals = NULL;
+	cc.functions = newArray(8);
+	cc.function_locals = newArray(8);
+	cc.allocations = newArray(64);
+
+	*cell(&cc, cc.globals, "__FUNCTION__") = newString("__main__");
+	collect(&cc, program, cc.globals);
+
+	functions = O_AVAL(cc.functions);
+	for(i = 0; i < functions->size; i++) {
+		ast_node *p = (ast_node *)O_PTVAL(functions->table[i]);
+		ComoClosureFunction *fn = compile_function(&cc, i);
+		*cell(&cc, cc.globals, p->u1.function_node.name) =
+			newPointer((void *)fn);
+	}
+
+	main_closure = compile_statement(&cc, program);
+	main_closure->stmt(main_closure, &result);
+
+	allocations = O_AVAL(cc.allocations);
+	for(i = 0; i < allocations->size; i++) {
+		free(O_PTVAL(allocations->table[i]));
+	}
+
+	objectDestroy(cc.globals);
+	objectDestroy(cc.functions);
+	objectDestroy(cc.function_locals);
+	objectDestroy(cc.allocations);
+
+	return 0;
+}
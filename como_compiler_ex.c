@@ -4,6 +4,8 @@
 #include <easyio.h>
 #include <object.h>
 #include <assert.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "ast.h"
 #include "stack.h"
@@ -14,69 +16,727 @@
 #include "lexer.h"
 #include "como_compiler_ex.h"
 #include "como_executor.h"
+#include "como_runtime.h"
+#include "como_register.h"
 
 static ComoFrame *global_frame = NULL;
 
+/* 
+ * Top statements waiting for a function they call to be declared,
+ * only used with --stream
+ */
+static ast_node *stream_pending = NULL;
+
+/* 
+ * How many top statements --stream holds back at most. Past that, the 
+ * oldest runs anyway and a call to a function still not declared fails
+ */
+#define COMO_STREAM_WINDOW 64
+
+ComoOptions como_options = { 0 };
+
+/* 
+ * --lazy state, the source is kept for as long as the program runs so
+ * function bodies can be parsed when first called
+ */
+static char *lazy_source = NULL;
+static size_t lazy_parse_base = 0;
+static size_t *lazy_parse_lines = NULL;   /* start of each line being parsed */
+static size_t lazy_parse_line_count = 0;
+static int lazy_materializing = 0;
+static Object *lazy_functions = NULL;     /* every ComoLazyFunction created */
+
+/* Of the source file being run, a --profile only applies to the same source */
+static uint64_t profile_hash = 0;
+
+/* 
+ * Set on --jobs worker threads, an Array of name, function pairs in the 
+ * order they would have been bound by a serial compile
+ */
+static __thread Object *compile_bindings = NULL;
+
+/* 
+ * Every string constant compiled on this thread, identical literals share
+ * one object. Strings are never modified in place
+ */
+static __thread Object *string_constants = NULL;
+
+/* 
+ * Names of the functions something may call, see como_find_live. NULL 
+ * unless the whole program is compiled at once, then only these are
+ */
+static Object *live_functions = NULL;
+
+/* 
+ * Every name the live functions and the top level code read, while the
+ * top level code is compiled, see como_pass_live_functions
+ */
+static Object *program_reads = NULL;
+
+/* 
+ * No bounds checks, como_verify_code proved the stack is balanced and
+ * cf_stack is sized to the deepest point of the code
+ */
 static inline void push(ComoFrame *frame, Object *value) {
-    if(frame->cf_sp >= COMO_DEFAULT_FRAME_STACKSIZE) {
-        como_error_noreturn("error stack overflow tried to push onto #%zu", frame->cf_sp);
-    } else {
-        frame->cf_stack[frame->cf_sp++] = value;
-        frame->cf_stack_size++;
-    }
+    frame->cf_stack[frame->cf_sp++] = value;
 }
 
 static inline Object *pop(ComoFrame *frame) {
-    Object *retval = NULL;
-    if(frame->cf_sp == 0) {
-        como_error_noreturn("stack underflow, tried to go before 0");
-    } else {
-        retval = frame->cf_stack[--frame->cf_sp];
-        --frame->cf_stack_size;
-    }
-    return retval;
+    return frame->cf_stack[--frame->cf_sp];
 }
 
 static ComoOpCode *create_op(unsigned char op, Object *oper) {
     ComoOpCode *ret = malloc(sizeof(ComoOpCode));
     ret->op_code = op;
     ret->operand = oper;
+    ret->op_misses = 0;
+    ret->op_hits = 0;
+    ret->op_trace = NULL;
     return ret;
 }
 
 static ComoFrame *create_frame(Object *code) {
-    size_t i;
     ComoFrame *frame = malloc(sizeof(ComoFrame));
 
     frame->cf_sp = 0;
     frame->cf_stack_size = 0;
-
-    for(i = 0; i < (size_t)COMO_DEFAULT_FRAME_STACKSIZE; i++) {
-        frame->cf_stack[i] = NULL;
-    }
+    frame->cf_stack = NULL;
 
     frame->cf_symtab = newMap(4);
     frame->code = code;
     frame->next = NULL;
     frame->namedparameters = newArray(2);
     frame->filename = NULL;
+    frame->cf_resolved = 0;
+    frame->cf_calls = 0;
+    frame->cf_depth = 0;
+    frame->cf_jit = NULL;
 
     return frame;
 }
 
+static void como_trace_free(struct ComoTrace *trace);
+
+/* 
+ * Releases the instructions of a code array that has finished executing.
+ * A LOAD_CONST operand is only released if it is a long nothing bound,
+ * see COMO_BOUND. Strings are interned, shared by all the code
+ */
+static void como_code_free(Object *code) {
+    size_t i;
+    for(i = 0; i < O_AVAL(code)->size; i++) {
+        ComoOpCode *opcode = (ComoOpCode *)O_PTVAL(O_AVAL(code)->table[i]);
+        if(opcode->operand != NULL && (opcode->op_code != LOAD_CONST 
+                || (O_TYPE(opcode->operand) == IS_LONG 
+                    && !(O_FLG(opcode->operand) & COMO_BOUND)))) {
+            objectDestroy(opcode->operand);
+        }
+        como_trace_free(opcode->op_trace);
+        free(opcode);
+    }
+    objectDestroy(code);
+}
+
+static void como_compile(ast_node* p, ComoFrame *frame);
+static void como_run_code_passes(Object *code, int top_level);
+
+/* 
+ * Binds a compiled function in the global symbol table, or, on a --jobs 
+ * worker thread, records the binding so it can be made in source order
+ */
+static void como_bind_function(const char *name, Object *value) {
+    if(compile_bindings != NULL) {
+        arrayPushEx(compile_bindings, newString(name));
+        arrayPushEx(compile_bindings, value);
+    } else {
+        mapInsertEx(global_frame->cf_symtab, name, value);
+    }
+}
+
+static ComoFrame *como_compile_function(const char *name, 
+    Object *parameters, ast_node *body, Object *filename) 
+{
+    Object *func_decl = newArray(4);
+    ComoFrame *func_decl_frame = create_frame(func_decl);
+    func_decl_frame->namedparameters = parameters;
+    func_decl_frame->filename = filename;
+
+    arrayPushEx(func_decl_frame->code, newPointer((void *)create_op(LOAD_CONST, 
+        newString(name)))); 
+    arrayPushEx(func_decl_frame->code, newPointer((void *)create_op(STORE_NAME, 
+        newString("__FUNCTION__"))));
+
+    como_compile(body, func_decl_frame);
+
+    Array *temp = O_AVAL(func_decl_frame->code);
+    Object *temp2 = temp->table[temp->size - 1];
+
+    ComoOpCode *opcode = (ComoOpCode *)(O_PTVAL(temp2));
+
+    if(opcode->op_code != IRETURN) {
+        //como_debug("automatically inserting IRETURN for function %s", name);
+        arrayPushEx(func_decl_frame->code, newPointer(
+            (void *)create_op(LOAD_CONST, newLong(0L)))); 
+        arrayPushEx(func_decl_frame->code, newPointer(
+            (void *)create_op(IRETURN, newLong(1L))));           
+    } 
+
+    como_run_code_passes(func_decl_frame->code, 0);
+    como_profile_apply(name, func_decl_frame->code);
+
+    /* Each call gets a stack of its own, see CALL_FUNCTION */
+    func_decl_frame->cf_stack_size = como_verify_code(func_decl_frame->code, 
+        name);
+
+    return func_decl_frame;
+}
+
+/* 
+ * Turns a location reported by the lexer into a byte offset of the source
+ * being parsed. The first line starts at column 1, every other one at 0
+ */
+static size_t como_lazy_offset(int line, int column) {
+    size_t start = lazy_parse_lines[line - 1];
+
+    if(line == 1) {
+        return lazy_parse_base + start + (size_t)(column - 1);
+    }
+
+    return lazy_parse_base + start + (size_t)column;
+}
+
+/* Called before every parse of (part of) lazy_source */
+static void como_lazy_begin_parse(size_t base, size_t length) {
+    size_t i, capacity = 16;
+    const char *text = lazy_source + base;
+
+    free(lazy_parse_lines);
+    lazy_parse_lines = malloc(sizeof(size_t) * capacity);
+    lazy_parse_lines[0] = 0;
+    lazy_parse_line_count = 1;
+    lazy_parse_base = base;
+
+    for(i = 0; i < length; i++) {
+        if(text[i] != '\n') {
+            continue;
+        }
+        if(lazy_parse_line_count == capacity) {
+            capacity *= 2;
+            lazy_parse_lines = realloc(lazy_parse_lines, 
+                sizeof(size_t) * capacity);
+        }
+        lazy_parse_lines[lazy_parse_line_count++] = i + 1;
+    }
+}
+
+/* 
+ * Moves every function declared in the body of a lazy function out of it,
+ * they're bound as soon as the enclosing declaration is compiled
+ */
+static void como_lazy_hoist(ast_node *p, ast_node *nested) {
+    size_t i;
+
+    if(p == NULL) {
+        return;
+    }
+
+    switch(p->type) {
+        case AST_NODE_TYPE_STATEMENT_LIST:
+            for(i = 0; i < p->u1.statements_node.count; i++) {
+                ast_node *stmt = p->u1.statements_node.statement_list[i];
+                if(stmt->type == AST_NODE_TYPE_FUNC_DECL) {
+                    ast_node_statement_list_push(nested, stmt);
+                    p->u1.statements_node.statement_list[i] = NULL;
+                } else {
+                    como_lazy_hoist(stmt, nested);
+                }
+            }
+        break;
+        case AST_NODE_TYPE_IF:
+            como_lazy_hoist(p->u1.if_node.b1, nested);
+            como_lazy_hoist(p->u1.if_node.b2, nested);
+        break;
+        case AST_NODE_TYPE_WHILE:
+            como_lazy_hoist(p->u1.while_node.body, nested);
+        break;
+        case AST_NODE_TYPE_FOR:
+            como_lazy_hoist(p->u1.for_node.body, nested);
+        break;
+        case AST_NODE_TYPE_SWITCH:
+            como_lazy_hoist(p->u1.switch_node.cases, nested);
+        break;
+        case AST_NODE_TYPE_CASE:
+            como_lazy_hoist(p->u1.case_node.body, nested);
+        break;
+        default:
+        break;
+    }
+}
+
+void como_lazy_function(ast_node *p, int first_line, int first_column,
+    int last_line, int last_column)
+{
+    ast_node_function *fn = &p->u1.function_node;
+
+    /* Functions the profile saw being called are compiled up front */
+    if(!como_options.lazy || como_profile_calls(fn->name) > 0) {
+        return;
+    }
+
+    fn->body_offset = como_lazy_offset(first_line, first_column);
+    fn->body_length = como_lazy_offset(last_line, last_column) 
+        - fn->body_offset;
+    fn->nested = ast_node_create_statement_list(0);
+
+    como_lazy_hoist(fn->body, fn->nested);
+
+    ast_node_free(fn->body);
+    fn->body = NULL;
+}
+
+static Object *como_lazy_function_create(ast_node *p, Object *parameters,
+    Object *filename)
+{
+    ComoLazyFunction *fn = malloc(sizeof(ComoLazyFunction));
+    Object *retval;
+
+    fn->name = newString(p->u1.function_node.name);
+    fn->parameters = parameters;
+    fn->filename = filename;
+    fn->body_offset = p->u1.function_node.body_offset;
+    fn->body_length = p->u1.function_node.body_length;
+    fn->materialized = 0;
+
+    arrayPushEx(lazy_functions, newPointer((void *)fn));
+
+    retval = newPointer((void *)fn);
+    O_FLG(retval) |= COMO_LAZY_FUNCTION;
+
+    return retval;
+}
+
+/* 
+ * Parses and compiles the body of a lazy function, the pointer bound to its
+ * name is updated in place so every alias of it sees the compiled frame
+ */
+static void como_lazy_materialize(Object *value) {
+    ComoLazyFunction *fn = (ComoLazyFunction *)O_PTVAL(value);
+    ast_node *statements;
+    yyscan_t scanner;
+    YY_BUFFER_STATE state;
+    ComoFrame *frame;
+
+    if(yylex_init(&scanner)) {
+        como_error_noreturn("yylex_init returned NULL");
+    }
+
+    como_lazy_begin_parse(fn->body_offset, fn->body_length);
+
+    state = yy_scan_bytes(lazy_source + fn->body_offset, 
+        (int)fn->body_length, scanner);
+
+    if(yyparse(&statements, scanner)) {
+        como_error_noreturn("yyparse returned NULL");
+    }
+
+    yy_delete_buffer(state, scanner);
+    yylex_destroy(scanner);
+
+    /* The span is a single compound statement */
+    assert(statements->u1.statements_node.count == 1);
+
+    lazy_materializing = 1;
+    frame = como_compile_function(O_SVAL(fn->name)->value, fn->parameters, 
+        statements->u1.statements_node.statement_list[0], fn->filename);
+    lazy_materializing = 0;
+
+    ast_node_free(statements);
+
+    fn->materialized = 1;
+    O_PTVAL(value) = (void *)frame;
+    O_FLG(value) &= ~COMO_LAZY_FUNCTION;
+}
+
+static void como_lazy_print_stats(void) {
+    size_t i, materialized = 0;
+    Array *functions = O_AVAL(lazy_functions);
+
+    for(i = 0; i < functions->size; i++) {
+        if(((ComoLazyFunction *)O_PTVAL(functions->table[i]))->materialized) {
+            materialized++;
+        }
+    }
+
+    fprintf(stderr, "lazy: %zu functions declared, %zu materialized, "
+        "%zu never materialized\n", functions->size, materialized, 
+        functions->size - materialized);
+
+    for(i = 0; i < functions->size; i++) {
+        ComoLazyFunction *fn = O_PTVAL(functions->table[i]);
+        if(!fn->materialized) {
+            fprintf(stderr, "  %s\n", O_SVAL(fn->name)->value);
+        }
+    }
+}
+
+/* Expression statements leave a value that nothing will ever pop */
+static int como_node_has_value(ast_node *p) {
+    switch(p->type) {
+        case AST_NODE_TYPE_NUMBER:
+        case AST_NODE_TYPE_STRING:
+        case AST_NODE_TYPE_ID:
+        case AST_NODE_TYPE_UNARY_OP:
+        case AST_NODE_TYPE_POSTFIX:
+        case AST_NODE_TYPE_PREFIX:
+        case AST_NODE_TYPE_CALL:
+            return 1;
+        case AST_NODE_TYPE_BIN_OP:
+            return p->u1.binary_node.type != AST_BINARY_OP_ASSIGN;
+        default:
+            return 0;
+    }
+}
+
+static void como_compile_statement(ast_node *p, ComoFrame *frame) {
+    /* ++i; is i = i + 1; and has no value to pop */
+    if(p->type == AST_NODE_TYPE_PREFIX) {
+        como_compile(p->u1.prefix_node.expr, frame);
+        return;
+    }
+
+    como_compile(p, frame);
+
+    if(como_node_has_value(p)) {
+        arrayPushEx(frame->code, newPointer((void *)create_op(POP_TOP, NULL)));
+    }
+}
+
+/* Whether evaluating p can assign to a name, or call a function that could */
+static int como_node_has_side_effects(ast_node *p) {
+    switch(p->type) {
+        case AST_NODE_TYPE_NUMBER:
+        case AST_NODE_TYPE_STRING:
+        case AST_NODE_TYPE_ID:
+            return 0;
+        case AST_NODE_TYPE_UNARY_OP:
+            return como_node_has_side_effects(p->u1.unary_node.expr);
+        case AST_NODE_TYPE_BIN_OP:
+            return p->u1.binary_node.type == AST_BINARY_OP_ASSIGN
+                || como_node_has_side_effects(p->u1.binary_node.left)
+                || como_node_has_side_effects(p->u1.binary_node.right);
+        default:
+            return 1;
+    }
+}
+
+/* 
+ * Emits name = name op value, p, as one INPLACE_ instruction if it has
+ * that form. value is then evaluated before name is looked up instead of
+ * after, so it must not be able to change name. Returns whether anything
+ * was emitted
+ */
+static int como_compile_inplace(ast_node *p, ComoFrame *frame) {
+    const char *name = AST_NODE_AS_ID(p->u1.binary_node.left);
+    ast_node *expr = p->u1.binary_node.right;
+    ast_node *left, *right;
+    unsigned char op;
+    uint64_t start;
+
+    if(!como_pass_enabled(COMO_PASS_INPLACE) 
+            || expr->type != AST_NODE_TYPE_BIN_OP) {
+        return 0;
+    }
+
+    start = como_pass_clock();
+
+    left = expr->u1.binary_node.left;
+    right = expr->u1.binary_node.right;
+
+    if(left->type != AST_NODE_TYPE_ID || strcmp(AST_NODE_AS_ID(left), name) != 0
+            || como_node_has_side_effects(right)) {
+        return 0;
+    }
+
+    switch(expr->u1.binary_node.type) {
+        case AST_BINARY_OP_ADD:   op = INPLACE_ADD;   break;
+        case AST_BINARY_OP_MINUS: op = INPLACE_MINUS; break;
+        case AST_BINARY_OP_TIMES: op = INPLACE_TIMES; break;
+        case AST_BINARY_OP_DIV:   op = INPLACE_DIV;   break;
+        case AST_BINARY_OP_REM:   op = INPLACE_REM;   break;
+        default:                  return 0;
+    }
+
+    /* 
+     * One instruction for LOAD_NAME, the operator and STORE_NAME, and for
+     * the LOAD_CONST of 1
+     */
+    if(right->type == AST_NODE_TYPE_NUMBER && right->u1.number_value == 1
+            && (op == INPLACE_ADD || op == INPLACE_MINUS)) {
+        op = op == INPLACE_ADD ? INPLACE_INC : INPLACE_DEC;
+        como_pass_record(COMO_PASS_INPLACE, start, -3L);
+    } else {
+        como_pass_record(COMO_PASS_INPLACE, start, -2L);
+        como_compile(right, frame);
+    }
+
+    arrayPushEx(frame->code, newPointer((void *)create_op(op, 
+        newString(name))));
+
+    return 1;
+}
+
+/* 
+ * The FOR_RANGE test of a loop that steps name and then runs condition,
+ * name compared to a number or another name. 0 if there is none
+ */
+static long como_counted_loop_test(ast_node *condition, const char *name) {
+    ast_node *left, *right;
+
+    if(condition == NULL || condition->type != AST_NODE_TYPE_BIN_OP) {
+        return 0;
+    }
+
+    left = condition->u1.binary_node.left;
+    right = condition->u1.binary_node.right;
+
+    if(left->type != AST_NODE_TYPE_ID 
+            || strcmp(AST_NODE_AS_ID(left), name) != 0) {
+        return 0;
+    }
+
+    if(right->type != AST_NODE_TYPE_NUMBER && (right->type != AST_NODE_TYPE_ID
+            || strcmp(AST_NODE_AS_ID(right), name) == 0)) {
+        return 0;
+    }
+
+    switch(condition->u1.binary_node.type) {
+        case AST_BINARY_OP_LT:  return IS_LESS_THAN;
+        case AST_BINARY_OP_LTE: return IS_LESS_THAN_OR_EQUAL;
+        case AST_BINARY_OP_GT:  return IS_GREATER_THAN;
+        case AST_BINARY_OP_GTE: return IS_GREATER_THAN_OR_EQUAL;
+        case AST_BINARY_OP_CMP: return IS_EQUAL;
+        case AST_BINARY_OP_NEQ: return IS_NOT_EQUAL;
+        default:                return 0;
+    }
+}
+
+/* 
+ * Emits step, i++ or i--, and condition, which loops back while it holds,
+ * as one FOR_RANGE if they form a counted loop, in place of replaced 
+ * instructions. Returns the Long to set to the pc of the LABEL after the 
+ * loop, NULL if nothing was emitted. The counter is still looked up by 
+ * name every iteration, so the body may assign it
+ */
+static Object *como_compile_counted_loop(ast_node *step, ast_node *condition,
+    ComoFrame *frame, long replaced)
+{
+    const char *name;
+    ast_node *right;
+    Object *loop, *target;
+    uint64_t start;
+    long test;
+
+    if(!como_pass_enabled(COMO_PASS_FOR_RANGE) || step == NULL 
+            || step->type != AST_NODE_TYPE_POSTFIX) {
+        return NULL;
+    }
+
+    start = como_pass_clock();
+
+    name = AST_NODE_AS_ID(step->u1.postfix_node.expr);
+    test = como_counted_loop_test(condition, name);
+
+    if(test == 0) {
+        return NULL;
+    }
+
+    right = condition->u1.binary_node.right;
+    target = newLong(0L);
+    loop = newArray(5);
+    arrayPushEx(loop, target);
+    arrayPushEx(loop, newString(name));
+    arrayPushEx(loop, right->type == AST_NODE_TYPE_NUMBER 
+        ? newLong((long)right->u1.number_value) 
+        : newString(AST_NODE_AS_ID(right)));
+    arrayPushEx(loop, newLong(test));
+    arrayPushEx(loop, newLong(
+        step->u1.postfix_node.type == AST_POSTFIX_OP_INC ? 1L : -1L));
+
+    arrayPushEx(frame->code, newPointer((void *)create_op(FOR_RANGE, loop)));
+    como_pass_record(COMO_PASS_FOR_RANGE, start, 1L - replaced);
+
+    return target;
+}
+
+/* The i++ or i-- a while loop's body ends with, NULL if there is none */
+static ast_node *como_while_step(ast_node *body) {
+    ast_node *last;
+
+    if(body == NULL || body->type != AST_NODE_TYPE_STATEMENT_LIST 
+            || body->u1.statements_node.count == 0) {
+        return NULL;
+    }
+
+    last = body->u1.statements_node.statement_list[
+        body->u1.statements_node.count - 1];
+
+    return last->type == AST_NODE_TYPE_POSTFIX ? last : NULL;
+}
+
+/* 
+ * The operand of a SWITCH, see como_opcode.h, with every target 0. Long 
+ * labels go into a table indexed by value when they span at most four 
+ * times as many values as there are of them, and into a sorted array to 
+ * search otherwise. String labels go into a Map
+ */
+Object *como_switch_table(ast_node *cases) {
+    ast_node_statements *list = &cases->u1.statements_node;
+    Object *table = newArray(6);
+    Object *targets = newArray(list->count + 1);
+    Object *dense = newArray(0);
+    Object *keys = newArray(list->count);
+    Object *indices = newArray(list->count);
+    Object *strings = newMap(8);
+    size_t i, j, count = 0;
+    long min = 0, max = 0;
+
+    for(i = 0; i <= list->count; i++) {
+        arrayPushEx(targets, newLong(0L));
+    }
+
+    for(i = 0; i < list->count; i++) {
+        ast_node *labels = list->statement_list[i]->u1.case_node.labels;
+        for(j = 0; labels != NULL && j < labels->u1.statements_node.count; 
+                j++) {
+            ast_node *label = labels->u1.statements_node.statement_list[j];
+            long value;
+            size_t at;
+
+            if(label->type == AST_NODE_TYPE_STRING) {
+                mapInsertEx(strings, label->u1.string_value.value, 
+                    newLong((long)i));
+                continue;
+            }
+
+            value = label->u1.number_value;
+            if(count == 0 || value < min) {
+                min = value;
+            }
+            if(count == 0 || value > max) {
+                max = value;
+            }
+
+            /* Insertion sort, labels are few and often in order already */
+            arrayPushEx(keys, newLong(value));
+            arrayPushEx(indices, newLong((long)i));
+            for(at = count; at > 0 
+                    && O_LVAL(O_AVAL(keys)->table[at - 1]) > value; at--) {
+                O_LVAL(O_AVAL(keys)->table[at]) = 
+                    O_LVAL(O_AVAL(keys)->table[at - 1]);
+                O_LVAL(O_AVAL(indices)->table[at]) = 
+                    O_LVAL(O_AVAL(indices)->table[at - 1]);
+            }
+            O_LVAL(O_AVAL(keys)->table[at]) = value;
+            O_LVAL(O_AVAL(indices)->table[at]) = (long)i;
+            count++;
+        }
+    }
+
+    if(count > 0 && (unsigned long)max - (unsigned long)min < 4 * count) {
+        size_t span = (size_t)((unsigned long)max - (unsigned long)min) + 1;
+        for(i = 0; i < span; i++) {
+            arrayPushEx(dense, newLong(-1L));
+        }
+        for(i = 0; i < count; i++) {
+            O_LVAL(O_AVAL(dense)->table[(unsigned long)O_LVAL(
+                O_AVAL(keys)->table[i]) - (unsigned long)min]) = 
+                O_LVAL(O_AVAL(indices)->table[i]);
+        }
+    }
+
+    arrayPushEx(table, targets);
+    arrayPushEx(table, newLong(min));
+    arrayPushEx(table, dense);
+    arrayPushEx(table, keys);
+    arrayPushEx(table, indices);
+    arrayPushEx(table, strings);
+
+    return table;
+}
+
+/* 
+ * A SWITCH on the value of the expression, then each case as a LABEL, its
+ * body and a JMP past the last one
+ */
+static void como_compile_switch(ast_node *p, ComoFrame *frame) {
+    ast_node_statements *list = &p->u1.switch_node.cases->u1.statements_node;
+    Object *table = como_switch_table(p->u1.switch_node.cases);
+    Array *targets = O_AVAL(O_AVAL(table)->table[SWITCH_TARGETS]);
+    Object **ends = malloc(sizeof(Object *) * (list->count + 1));
+    int has_default = 0;
+    long end;
+    size_t i;
+
+    como_compile(p->u1.switch_node.expr, frame);
+    arrayPushEx(frame->code, newPointer((void *)create_op(SWITCH, table)));
+
+    for(i = 0; i < list->count; i++) {
+        ast_node *node = list->statement_list[i];
+        long pc = (long)(O_AVAL(frame->code)->size);
+
+        O_LVAL(targets->table[i]) = pc;
+        if(node->u1.case_node.labels == NULL) {
+            O_LVAL(targets->table[list->count]) = pc;
+            has_default = 1;
+        }
+
+        arrayPushEx(frame->code, newPointer((void *)create_op(LABEL, 
+            newLong(pc))));
+        como_compile(node->u1.case_node.body, frame);
+
+        ends[i] = newLong(0L);
+        arrayPushEx(frame->code, newPointer((void *)create_op(JMP, ends[i])));
+    }
+
+    end = (long)(O_AVAL(frame->code)->size);
+    arrayPushEx(frame->code, newPointer((void *)create_op(LABEL, 
+        newLong(end))));
+
+    for(i = 0; i < list->count; i++) {
+        O_LVAL(ends[i]) = end;
+    }
+
+    /* Without a default no case matching goes past them all */
+    if(!has_default) {
+        O_LVAL(targets->table[list->count]) = end;
+    }
+
+    free(ends);
+}
 
 static void como_compile(ast_node* p, ComoFrame *frame)
 {
     assert(p);
 
+    if(string_constants == NULL) {
+        string_constants = newMap(16);
+    }
+
     switch(p->type) {
         default:
             printf("%s(): invalid node type(%d)\n", __func__, p->type);
             exit(1);
         break;
-        case AST_NODE_TYPE_STRING:
+        case AST_NODE_TYPE_STRING: {
+            Object *value = mapSearch(string_constants, 
+                p->u1.string_value.value);
+            if(value == NULL) {
+                value = newString(p->u1.string_value.value);
+                mapInsert(string_constants, p->u1.string_value.value, value);
+            }
             arrayPushEx(frame->code, newPointer((void *)create_op(LOAD_CONST, 
-                newString(p->u1.string_value.value)))); 
+                value))); 
+        }
         break;
         case AST_NODE_TYPE_PRINT:
             como_compile(p->u1.print_node.expr, frame);
@@ -105,7 +765,7 @@ static void como_compile(ast_node* p, ComoFrame *frame)
             size_t i;
             for(i = 0; i < p->u1.statements_node.count; i++) {
                 ast_node* stmt = p->u1.statements_node.statement_list[i];
-                como_compile(stmt, frame);
+                como_compile_statement(stmt, frame);
             }
         } 
         break;
@@ -117,9 +777,35 @@ static void como_compile(ast_node* p, ComoFrame *frame)
             como_compile(p->u1.while_node.condition, frame);
             arrayPushEx(frame->code, newPointer((void *)create_op(JZ, l2)));
 
-            como_compile(p->u1.while_node.body, frame);
+            ast_node *body = p->u1.while_node.body;
+            ast_node *step = como_while_step(body);
+            long top = O_LVAL(l);
+            Object *l5 = NULL;
+
+            /* 
+             * A counted loop goes back to after its test, through the
+             * FOR_RANGE in place of the step it ends with
+             */
+            if(step != NULL && como_pass_enabled(COMO_PASS_FOR_RANGE) 
+                    && como_counted_loop_test(p->u1.while_node.condition, 
+                        AST_NODE_AS_ID(step->u1.postfix_node.expr))) {
+                size_t i;
+                top = (long)(O_AVAL(frame->code)->size);
+                arrayPushEx(frame->code, newPointer((void *)create_op(LABEL, 
+                        newLong(top))));
+                for(i = 0; i + 1 < body->u1.statements_node.count; i++) {
+                    como_compile_statement(
+                        body->u1.statements_node.statement_list[i], frame);
+                }
+                /* The step, less the LABEL it goes back to */
+                l5 = como_compile_counted_loop(step, 
+                    p->u1.while_node.condition, frame, 1L);
+            } else {
+                como_compile(body, frame);
+            }
+
             arrayPushEx(frame->code, newPointer((void *)create_op(JMP, 
-                    newLong(O_LVAL(l)))));
+                    newLong(top))));
         
             Object *l3 = newLong((long)(O_AVAL(frame->code)->size));
     
@@ -127,6 +813,9 @@ static void como_compile(ast_node* p, ComoFrame *frame)
                     l3))); 
 
             O_LVAL(l2) = O_LVAL(l3);
+            if(l5 != NULL) {
+                O_LVAL(l5) = O_LVAL(l3);
+            }
         }
         break;
         case AST_NODE_TYPE_FOR: {
@@ -146,12 +835,22 @@ static void como_compile(ast_node* p, ComoFrame *frame)
                     l4)));    
 
             como_compile(p->u1.for_node.body, frame);
-            
-            como_compile(p->u1.for_node.final_expression, frame);
 
-            como_compile(p->u1.for_node.condition, frame);
-            arrayPushEx(frame->code, newPointer((void *)create_op(JZ, 
-                    l2))); 
+            /* The step and its POP_TOP, the condition and its JZ */
+            Object *l5 = como_compile_counted_loop(
+                p->u1.for_node.final_expression, p->u1.for_node.condition, 
+                frame, 6L);
+
+            /* A Long of its own, --stream frees every jump's operand */
+            if(l5 == NULL) {
+                como_compile_statement(p->u1.for_node.final_expression, 
+                    frame);
+
+                como_compile(p->u1.for_node.condition, frame);
+                l5 = newLong(0);
+                arrayPushEx(frame->code, newPointer((void *)create_op(JZ, 
+                        l5))); 
+            }
 
             arrayPushEx(frame->code, newPointer((void *)create_op(JMP, 
                     newLong(O_LVAL(l4))))); 
@@ -162,8 +861,14 @@ static void como_compile(ast_node* p, ComoFrame *frame)
                 l3))); 
         
             O_LVAL(l2) = O_LVAL(l3);
+            if(l5 != NULL) {
+                O_LVAL(l5) = O_LVAL(l3);
+            }
         }
         break;
+        case AST_NODE_TYPE_SWITCH:
+            como_compile_switch(p, frame);
+        break;
         case AST_NODE_TYPE_IF: {
             Object *l2 = newLong(0);
             Object *l4 = newLong(0);
@@ -197,15 +902,22 @@ static void como_compile(ast_node* p, ComoFrame *frame)
         break;
         case AST_NODE_TYPE_FUNC_DECL: { 
             const char *name = p->u1.function_node.name;
-            Object *func_decl = newArray(4);
             Object *func_decl_parameters = newArray(2);
-            ComoFrame *func_decl_frame = create_frame(func_decl);
-            func_decl_frame->namedparameters = func_decl_parameters;
+            Object *filename;
+
+            /* Already bound when the enclosing lazy function was declared */
+            if(lazy_materializing) {
+                break;
+            }
+
+            if(live_functions != NULL && mapSearch(live_functions, name) == NULL) {
+                break;
+            }
 
             if(frame->filename != NULL) {
-                func_decl_frame->filename = copyObject(frame->filename);
+                filename = copyObject(frame->filename);
             } else {
-                func_decl_frame->filename = newString("<unknown>");
+                filename = newString("<unknown>");
             }
 
             size_t i;
@@ -222,28 +934,18 @@ static void como_compile(ast_node* p, ComoFrame *frame)
                 );
             }
 
-            arrayPushEx(func_decl_frame->code, newPointer((void *)create_op(LOAD_CONST, 
-                newString(name)))); 
-            arrayPushEx(func_decl_frame->code, newPointer((void *)create_op(STORE_NAME, 
-										newString("__FUNCTION__"))));
-
-            como_compile(p->u1.function_node.body, func_decl_frame);
-
-            Array *temp = O_AVAL(func_decl_frame->code);
-            Object *temp2 = temp->table[temp->size - 1];
-
-            ComoOpCode *opcode = (ComoOpCode *)(O_PTVAL(temp2));
-
-            if(opcode->op_code != IRETURN) {
-                //como_debug("automatically inserting IRETURN for function %s", name);
-                arrayPushEx(func_decl_frame->code, newPointer(
-                    (void *)create_op(LOAD_CONST, newLong(0L)))); 
-                arrayPushEx(func_decl_frame->code, newPointer(
-                    (void *)create_op(IRETURN, newLong(1L))));           
-            } 
-
-            mapInsertEx(global_frame->cf_symtab, name, newPointer(
-                (void *)func_decl_frame));
+            if(p->u1.function_node.body == NULL) {
+                if(p->u1.function_node.nested != NULL) {
+                    como_compile(p->u1.function_node.nested, frame);
+                }
+                como_bind_function(name, 
+                    como_lazy_function_create(p, func_decl_parameters, 
+                        filename));
+            } else {
+                como_bind_function(name, newPointer(
+                    (void *)como_compile_function(name, func_decl_parameters,
+                        p->u1.function_node.body, filename)));
+            }
 
             break;
         } 
@@ -255,7 +957,11 @@ static void como_compile(ast_node* p, ComoFrame *frame)
                 .statements_node
                 .count;
 
-            como_compile(p->u1.call_node.arguments, frame);
+            size_t i;
+            for(i = 0; i < (size_t)argcount; i++) {
+                como_compile(p->u1.call_node.arguments->u1
+                    .statements_node.statement_list[i], frame);
+            }
             arrayPushEx(frame->code, newPointer(
                     (void *)create_op(LOAD_CONST, newLong(argcount)))); 
 
@@ -281,6 +987,14 @@ static void como_compile(ast_node* p, ComoFrame *frame)
             }
             break;
         }
+        case AST_NODE_TYPE_PREFIX: {
+            ast_node *assign = p->u1.prefix_node.expr;
+            arrayPushEx(frame->code, newPointer((void *)create_op(
+                p->u1.prefix_node.type == AST_PREFIX_OP_INC 
+                    ? PREFIX_INC : PREFIX_DEC,
+                newString(AST_NODE_AS_ID(assign->u1.binary_node.left)))));
+            break;
+        }
         case AST_NODE_TYPE_UNARY_OP: {
             switch(p->u1.unary_node.type) {
                 case AST_UNARY_OP_MINUS:
@@ -295,7 +1009,9 @@ static void como_compile(ast_node* p, ComoFrame *frame)
             if(p->u1.binary_node.type != AST_BINARY_OP_ASSIGN) {
                 como_compile(p->u1.binary_node.left, frame);
                 como_compile(p->u1.binary_node.right, frame);       
-            }  
+            } else if(como_compile_inplace(p, frame)) {
+                break;
+            }
             switch(p->u1.binary_node.type) {
                 case AST_BINARY_OP_REM:
                     arrayPushEx(frame->code, newPointer(
@@ -352,285 +1068,1903 @@ static void como_compile(ast_node* p, ComoFrame *frame)
     }
 }
 
-static void como_execute(ComoFrame *frame, ComoFrame *callingframe) {
-    size_t i;
-    for(i = 0; i < O_AVAL(frame->code)->size; i++) {
-        ComoOpCode *opcode = ((ComoOpCode *)(O_PTVAL(O_AVAL(frame->code)->table[i])));
-        switch(opcode->op_code) {
-            default: {
-                como_error_noreturn("Invalid OpCode got %d", opcode->op_code);
-            }
-            case POSTFIX_INC: {
-                Object *value = NULL;
-                value = mapSearchEx(frame->cf_symtab, 
-                    O_SVAL(opcode->operand)->value);
+/* 
+ * Pops the operands of a generic binary instruction, counts the execution
+ * and rewrites the instruction into a form specialized for their types
+ */
+#define BINARY_OPERANDS(op) \
+    Object *right = pop(frame); \
+    Object *left = pop(frame); \
+    quicken_stats[(op)].generic++; \
+    como_quicken(opcode, left, right)
+
+/* 
+ * Body of a quickened instruction on two longs. The operands are only
+ * popped once the guard holds, otherwise the instruction is rewritten back
+ * to its generic form, which then runs with the stack untouched
+ */
+#define QUICKENED_LONG_LONG(op, generic_label, guard, expr) do { \
+    Object *right = frame->cf_stack[frame->cf_sp - 1]; \
+    Object *left = frame->cf_stack[frame->cf_sp - 2]; \
+    if(O_TYPE(left) != IS_LONG || O_TYPE(right) != IS_LONG || !(guard)) { \
+        como_dequicken(opcode, (op)); \
+        goto generic_label; \
+    } \
+    frame->cf_sp -= 2; \
+    push(frame, newLong((long)(expr))); \
+    quicken_stats[(op)].quickened++; \
+} while(0); \
+break
+
+#define QUICKENED_STR_STR(op, generic_label, value) do { \
+    Object *right = frame->cf_stack[frame->cf_sp - 1]; \
+    Object *left = frame->cf_stack[frame->cf_sp - 2]; \
+    if(O_TYPE(left) != IS_STRING || O_TYPE(right) != IS_STRING) { \
+        como_dequicken(opcode, (op)); \
+        goto generic_label; \
+    } \
+    frame->cf_sp -= 2; \
+    push(frame, (value)); \
+    quicken_stats[(op)].quickened++; \
+} while(0); \
+break
+
+/* An instruction that misses this many times stays generic */
+#define COMO_QUICKEN_MAX_MISSES 4
+
+typedef struct ComoQuickenStats {
+    size_t generic;            /* executions of the generic instruction */
+    size_t quickened;          /* executions of one of its quickened forms */
+    size_t rewrites;           /* times it was quickened */
+    size_t misses;             /* times a quickened form was rewritten back */
+} ComoQuickenStats;
+
+/* Indexed by the generic opcode */
+static ComoQuickenStats quicken_stats[256];
+
+static unsigned char como_quicken_long_long(unsigned char op) {
+    switch(op) {
+        case IADD:                     return IADD_LONG_LONG;
+        case IMINUS:                   return IMINUS_LONG_LONG;
+        case ITIMES:                   return ITIMES_LONG_LONG;
+        case IDIV:                     return IDIV_LONG_LONG;
+        case IREM:                     return IREM_LONG_LONG;
+        case IS_LESS_THAN:             return IS_LESS_THAN_LONG_LONG;
+        case IS_LESS_THAN_OR_EQUAL:    return IS_LESS_THAN_OR_EQUAL_LONG_LONG;
+        case IS_GREATER_THAN:          return IS_GREATER_THAN_LONG_LONG;
+        case IS_GREATER_THAN_OR_EQUAL: return IS_GREATER_THAN_OR_EQUAL_LONG_LONG;
+        case IS_EQUAL:                 return IS_EQUAL_LONG_LONG;
+        case IS_NOT_EQUAL:             return IS_NOT_EQUAL_LONG_LONG;
+        default:                       return INONE;
+    }
+}
 
-                if(value == NULL) {
-                    como_error_noreturn("undefined variable '%s'", 
-                        O_SVAL(opcode->operand)->value);
-                } else {
-                    if(O_TYPE(value) != IS_LONG) {
-                        como_error_noreturn("unsupported value for POSTFIX_INC");
-                    } else {
-                        long oldvalue = O_LVAL(value);
-                        O_LVAL(value) = oldvalue + 1;
-                        push(frame, newLong(oldvalue));
-                    }   
-                }
-                break;        
-            }
-            case POSTFIX_DEC: {
-                Object *value = NULL;
-                value = mapSearchEx(frame->cf_symtab, 
-                    O_SVAL(opcode->operand)->value);
+static unsigned char como_quicken_str_str(unsigned char op) {
+    switch(op) {
+        case IADD:                     return IADD_STR_STR;
+        case IS_EQUAL:                 return IS_EQUAL_STR_STR;
+        case IS_NOT_EQUAL:             return IS_NOT_EQUAL_STR_STR;
+        default:                       return INONE;
+    }
+}
 
-                if(value == NULL) {
-                    como_error_noreturn("undefined variable '%s'", 
-                        O_SVAL(opcode->operand)->value);
+static inline void como_quicken(ComoOpCode *opcode, Object *left, 
+    Object *right) 
+{
+    unsigned char quickened = INONE;
+
+    if(como_options.no_quicken 
+            || opcode->op_misses >= COMO_QUICKEN_MAX_MISSES) {
+        return;
+    }
+
+    if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) {
+        quickened = como_quicken_long_long(opcode->op_code);
+    } else if(O_TYPE(left) == IS_STRING && O_TYPE(right) == IS_STRING) {
+        quickened = como_quicken_str_str(opcode->op_code);
+    }
+
+    if(quickened != INONE) {
+        quicken_stats[opcode->op_code].rewrites++;
+        opcode->op_code = quickened;
+    }
+}
+
+static inline void como_dequicken(ComoOpCode *opcode, unsigned char generic) {
+    quicken_stats[generic].misses++;
+    opcode->op_misses++;
+    opcode->op_code = generic;
+}
+
+static void como_quicken_print_stats(void) {
+    size_t i;
+
+    fprintf(stderr, "%-26s %12s %12s %9s %7s\n", "opcode", "generic", 
+        "quickened", "rewrites", "misses");
+
+    for(i = 0; i < 256; i++) {
+        ComoQuickenStats *stats = &quicken_stats[i];
+        if(stats->generic == 0 && stats->quickened == 0) {
+            continue;
+        }
+        fprintf(stderr, "%-26s %12zu %12zu %9zu %7zu\n", 
+            como_opcode_name((unsigned char)i), stats->generic, 
+            stats->quickened, stats->rewrites, stats->misses);
+    }
+}
+
+static void como_execute(ComoFrame *frame);
+static size_t como_trace_back_edge(ComoFrame *frame, ComoOpCode *jmp, 
+    size_t pc);
+
+/* 
+ * CALL_FUNCTION, pops the function, the argument count and the arguments,
+ * runs the function and pushes its return value
+ */
+static void como_call_function(ComoFrame *frame, ComoOpCode *opcode) {
+    Object *fn = pop(frame);
+    Object *argcount = pop(frame);
+    long i = O_LVAL(argcount);
+    ComoFrame *fnframe;
+    if(O_TYPE(fn) != IS_POINTER) {
+        como_error_noreturn("name '%s' is not callable",
+            O_SVAL(opcode->operand)->value);
+    }
+    if(O_FLG(fn) & COMO_LAZY_FUNCTION) {
+        como_lazy_materialize(fn);
+    }
+    fnframe = (ComoFrame *)O_PTVAL(fn);
+    fnframe->cf_calls++;
+    if(O_LVAL(argcount) != (long)(O_AVAL(fnframe->namedparameters)->size)) {
+        como_error_noreturn("callable '%s' expects %ld arguments, but %ld were given",
+            O_SVAL(opcode->operand)->value, 
+            (long)(O_AVAL(fnframe->namedparameters)->size), 
+            O_LVAL(argcount));
+    }
+    //como_debug("calling '%s'", O_SVAL(opcode->operand)->value);
+    // DOING THIS ACTUALLY DEFINES THE NAME AT RUNTIME
+    // which could not be equal to that actual function body 
+    // declared
+    // name = my_function
+    // name() 
+    // that call will have "name" for value __FUNCTION__
+    // even though the real function is my_function
+    // must define it at COMPILE time
+    // mapInsertEx(fnframe->cf_symtab, "__FUNCTION__", 
+    // newString(O_SVAL(opcode->operand)->value));
+
+    while(i--) {
+        como_debug("getting %ldth argument for function call '%s'",
+            i, O_SVAL(opcode->operand)->value);
+        Object *argname = O_AVAL(fnframe->namedparameters)->table[i];
+
+        Object *argvalue = pop(frame);
+        O_FLG(argvalue) = (O_FLG(argvalue) & ~COMO_OWNED) | COMO_BOUND;
+        mapInsert(fnframe->cf_symtab, O_SVAL(argname)->value,
+            argvalue);
+#ifdef COMO_DEBUG
+        char *argvaluestr = objectToString(argvalue);
+        
+    como_debug("%ldth argument: '%s' has value: %s", i, O_SVAL(argname)->value,
+            argvaluestr);
+    free(argvaluestr);
+#endif
+    }
+    //ComoFrame *prev = frame;
+
+    //fnframe->next = prev;
+
+    /* 
+     * Every activation gets a stack of its own, sized to the
+     * verified depth, so recursion can't overrun it
+     */
+    Object *stack[fnframe->cf_stack_size];
+    Object **saved_stack = fnframe->cf_stack;
+    size_t saved_sp = fnframe->cf_sp;
+
+    fnframe->cf_stack = stack;
+    fnframe->cf_sp = 0;
+
+    if(fnframe->cf_calls == como_options.jit_threshold 
+            && !como_options.no_jit) {
+        fnframe->cf_jit = como_jit_compile(fnframe, 
+            O_SVAL(opcode->operand)->value);
+    }
+
+    fnframe->cf_depth++;
+
+    if(fnframe->cf_jit != NULL) {
+        fnframe->cf_jit(fnframe);
+    } else {
+        como_execute(fnframe);
+    }
+
+    fnframe->cf_depth--;
+
+    /* fnframe may be this frame, when called recursively */
+    Object *retval = pop(fnframe);
+    O_FLG(retval) &= ~COMO_OWNED;
+    fnframe->cf_stack = saved_stack;
+    fnframe->cf_sp = saved_sp;
+    
+    push(frame, retval);
+    //fnframe->next = NULL;
+}
+
+/* 
+ * POSTFIX_INC and POSTFIX_DEC, returns the value name had. That value may
+ * be bound to other names as well, name is bound to a new long instead
+ */
+static Object *como_postfix(ComoFrame *frame, const char *name, long delta)
+{
+    Object *value = mapSearchEx(frame->cf_symtab, name);
+    Object *result = como_rt_step(value, delta, name);
+
+    O_FLG(value) &= ~COMO_OWNED;
+    mapInsertEx(frame->cf_symtab, name, result);
+
+    return value;
+}
+
+/* 
+ * Steps the counter of a FOR_RANGE and tests it, returns 1 while the loop
+ * goes on. What POSTFIX_INC, POP_TOP, the loads, the comparison and JZ it
+ * stands for would do, without the objects they allocate: once the
+ * counter is a long the loop owns, see COMO_OWNED, it is stepped in place
+ */
+static int como_for_range(ComoFrame *frame, ComoOpCode *opcode) {
+    Object **loop = O_AVAL(opcode->operand)->table;
+    const char *name = O_SVAL(loop[FOR_RANGE_NAME])->value;
+    Object *counter = mapSearchEx(frame->cf_symtab, name);
+    Object *bound = loop[FOR_RANGE_BOUND];
+    Object *result;
+    long left, right;
+
+    if(counter != NULL && O_TYPE(counter) == IS_LONG
+            && (O_FLG(counter) & COMO_OWNED) && frame->cf_depth <= 1) {
+        O_LVAL(counter) += O_LVAL(loop[FOR_RANGE_STEP]);
+    } else {
+        counter = como_rt_step(counter, O_LVAL(loop[FOR_RANGE_STEP]), name);
+        O_FLG(counter) |= COMO_OWNED;
+        mapInsertEx(frame->cf_symtab, name, counter);
+    }
+
+    if(O_TYPE(bound) == IS_STRING) {
+        const char *bound_name = O_SVAL(bound)->value;
+        bound = mapSearch(frame->cf_symtab, bound_name);
+        if(bound == NULL) {
+            bound = mapSearch(global_frame->cf_symtab, bound_name);
+        }
+        if(bound == NULL) {
+            como_error_noreturn("undefined variable '%s'", bound_name);
+        }
+    }
+
+    if(O_TYPE(bound) == IS_LONG) {
+        left = O_LVAL(counter);
+        right = O_LVAL(bound);
+        switch(O_LVAL(loop[FOR_RANGE_TEST])) {
+            case IS_LESS_THAN:             return left < right;
+            case IS_LESS_THAN_OR_EQUAL:    return left <= right;
+            case IS_GREATER_THAN:          return left > right;
+            case IS_GREATER_THAN_OR_EQUAL: return left >= right;
+            case IS_EQUAL:                 return left == right;
+            default:                       return left != right;
+        }
+    }
+
+    switch(O_LVAL(loop[FOR_RANGE_TEST])) {
+        case IS_LESS_THAN:
+            result = como_rt_is_less_than(counter, bound);
+        break;
+        case IS_LESS_THAN_OR_EQUAL:
+            result = como_rt_is_less_than_or_equal(counter, bound);
+        break;
+        case IS_GREATER_THAN:
+            result = como_rt_is_greater_than(counter, bound);
+        break;
+        case IS_GREATER_THAN_OR_EQUAL:
+            result = como_rt_is_greater_than_or_equal(counter, bound);
+        break;
+        case IS_EQUAL:
+            result = como_rt_is_equal(counter, bound);
+        break;
+        default:
+            result = como_rt_is_not_equal(counter, bound);
+        break;
+    }
+
+    return !como_rt_is_false(result);
+}
+
+/* 
+ * Pops the value a SWITCH is on and returns the pc of the LABEL of the case
+ * it matches: the one with the same long or string as a label, else the
+ * default's, else the one after every case
+ */
+static size_t como_switch(ComoFrame *frame, ComoOpCode *opcode) {
+    Array *targets = O_AVAL(O_AVAL(opcode->operand)->table[SWITCH_TARGETS]);
+    long match = como_rt_switch(opcode->operand, pop(frame));
+
+    if(match < 0) {
+        match = (long)targets->size - 1;
+    }
+
+    return (size_t)O_LVAL(targets->table[match]);
+}
+
+/* LOAD_NAME, the value of name in frame or else in the global frame */
+static inline Object *como_load_name(ComoFrame *frame, const char *name) {
+    Object *value = mapSearch(frame->cf_symtab, name);
+
+    if(value == NULL) {
+        value = mapSearch(global_frame->cf_symtab, name);
+        if(value == NULL) {
+            como_error_noreturn("undefined variable '%s'", name);
+        }
+    }
+
+    return value;
+}
+
+/* STORE_NAME, binds name to value in frame, see COMO_BOUND */
+static inline void como_store_name(ComoFrame *frame, const char *name, 
+    Object *value)
+{
+    O_FLG(value) = (O_FLG(value) & ~COMO_OWNED) | COMO_BOUND;
+    mapInsertEx(frame->cf_symtab, name, value);
+}
+
+/* 
+ * name = name op right, for INPLACE_ADD and the like and the PREFIX_ ones,
+ * right NULL standing for 1. Returns the value now bound to name. A long
+ * this frame owns, see COMO_OWNED, is updated in place, unless the frame 
+ * is running more than once: an activation further up may have pushed it. 
+ * With pushed set the value goes on the stack, so it isn't owned
+ */
+static Object *como_update_name(ComoFrame *frame, const char *name, 
+    unsigned char op, Object *right, int pushed)
+{
+    Object *left = mapSearch(frame->cf_symtab, name);
+    Object *result;
+    int owned = left != NULL && (O_FLG(left) & COMO_OWNED) && !pushed
+        && frame->cf_depth <= 1;
+
+    if(left == NULL) {
+        left = mapSearch(global_frame->cf_symtab, name);
+        if(left == NULL) {
+            como_error_noreturn("undefined variable '%s'", name);
+        }
+    }
+
+    if(O_TYPE(left) == IS_LONG && (right == NULL || (O_TYPE(right) == IS_LONG
+            && ((op != IDIV && op != IREM) || O_LVAL(right) != 0)))) {
+        long l = O_LVAL(left), r = right != NULL ? O_LVAL(right) : 1L, value;
+
+        switch(op) {
+            case IADD:   value = l + r; break;
+            case IMINUS: value = l - r; break;
+            case ITIMES: value = l * r; break;
+            case IDIV:   value = l / r; break;
+            default:     value = l % r; break;
+        }
+
+        if(owned) {
+            O_LVAL(left) = value;
+            return left;
+        }
+
+        result = newLong(value);
+        if(!pushed) {
+            O_FLG(result) |= COMO_OWNED;
+        }
+    } else {
+        if(right == NULL) {
+            right = newLong(1L);
+        }
+        switch(op) {
+            case IADD:   result = como_rt_add(left, right);   break;
+            case IMINUS: result = como_rt_minus(left, right); break;
+            case ITIMES: result = como_rt_times(left, right); break;
+            case IDIV:   result = como_rt_div(left, right);   break;
+            default:     result = como_rt_rem(left, right);   break;
+        }
+    }
+
+    mapInsertEx(frame->cf_symtab, name, result);
+
+    return result;
+}
+
+/* 
+ * Runs the instruction at *pc, using op in place of its op_code. Inlined 
+ * into como_execute, and into the helpers called by JIT compiled code with
+ * a constant op. Jumps set *pc to their LABEL
+ */
+static inline __attribute__ ((always_inline)) int como_execute_op(
+    ComoFrame *frame, ComoOpCode *opcode, unsigned char op, size_t *pc) 
+{
+    switch(op) {
+        default: {
+            como_error_noreturn("Invalid OpCode got %d", opcode->op_code);
+        }
+        case POSTFIX_INC: {
+            push(frame, como_postfix(frame, O_SVAL(opcode->operand)->value, 1));
+            break;        
+        }
+        case POSTFIX_DEC: {
+            push(frame, como_postfix(frame, O_SVAL(opcode->operand)->value, -1));
+            break;        
+        }
+        case PREFIX_INC: {
+            push(frame, como_update_name(frame, O_SVAL(opcode->operand)->value,
+                IADD, NULL, 1));
+            break;
+        }
+        case PREFIX_DEC: {
+            push(frame, como_update_name(frame, O_SVAL(opcode->operand)->value,
+                IMINUS, NULL, 1));
+            break;
+        }
+        case INPLACE_INC: {
+            (void)como_update_name(frame, O_SVAL(opcode->operand)->value,
+                IADD, NULL, 0);
+            break;
+        }
+        case INPLACE_DEC: {
+            (void)como_update_name(frame, O_SVAL(opcode->operand)->value,
+                IMINUS, NULL, 0);
+            break;
+        }
+        case INPLACE_ADD:
+        case INPLACE_MINUS:
+        case INPLACE_TIMES:
+        case INPLACE_DIV:
+        case INPLACE_REM: {
+            static const unsigned char binary[] = { 
+                IADD, IMINUS, ITIMES, IDIV, IREM 
+            };
+            (void)como_update_name(frame, O_SVAL(opcode->operand)->value,
+                binary[op - INPLACE_ADD], pop(frame), 0);
+            break;
+        }
+        case IADD_LONG_LONG:
+            QUICKENED_LONG_LONG(IADD, generic_iadd, 1, 
+                O_LVAL(left) + O_LVAL(right));
+        case IMINUS_LONG_LONG:
+            QUICKENED_LONG_LONG(IMINUS, generic_iminus, 1, 
+                O_LVAL(left) - O_LVAL(right));
+        case ITIMES_LONG_LONG:
+            QUICKENED_LONG_LONG(ITIMES, generic_itimes, 1, 
+                O_LVAL(left) * O_LVAL(right));
+        case IDIV_LONG_LONG:
+            QUICKENED_LONG_LONG(IDIV, generic_idiv, O_LVAL(right) != 0, 
+                O_LVAL(left) / O_LVAL(right));
+        case IREM_LONG_LONG:
+            QUICKENED_LONG_LONG(IREM, generic_irem, O_LVAL(right) != 0, 
+                O_LVAL(left) % O_LVAL(right));
+        case IS_LESS_THAN_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_LESS_THAN, generic_is_less_than, 1, 
+                O_LVAL(left) < O_LVAL(right));
+        case IS_LESS_THAN_OR_EQUAL_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_LESS_THAN_OR_EQUAL, 
+                generic_is_less_than_or_equal, 1, 
+                O_LVAL(left) <= O_LVAL(right));
+        case IS_GREATER_THAN_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_GREATER_THAN, generic_is_greater_than, 
+                1, O_LVAL(left) > O_LVAL(right));
+        case IS_GREATER_THAN_OR_EQUAL_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_GREATER_THAN_OR_EQUAL, 
+                generic_is_greater_than_or_equal, 1, 
+                O_LVAL(left) >= O_LVAL(right));
+        case IS_EQUAL_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_EQUAL, generic_is_equal, 1, 
+                O_LVAL(left) == O_LVAL(right));
+        case IS_NOT_EQUAL_LONG_LONG:
+            QUICKENED_LONG_LONG(IS_NOT_EQUAL, generic_is_not_equal, 1, 
+                O_LVAL(left) != O_LVAL(right));
+        case IS_EQUAL_STR_STR:
+            QUICKENED_STR_STR(IS_EQUAL, generic_is_equal,
+                newLong((long)como_rt_string_equals(left, right)));
+        case IS_NOT_EQUAL_STR_STR:
+            QUICKENED_STR_STR(IS_NOT_EQUAL, generic_is_not_equal,
+                newLong((long)!como_rt_string_equals(left, right)));
+        case IADD_STR_STR:
+            QUICKENED_STR_STR(IADD, generic_iadd,
+                como_rt_concat(left, right));
+        case IADD: generic_iadd: {
+            BINARY_OPERANDS(IADD);
+            push(frame, como_rt_add(left, right));
+            break;
+        }
+        case IMINUS: generic_iminus: {
+            BINARY_OPERANDS(IMINUS);
+            push(frame, como_rt_minus(left, right));
+            break;
+        }
+        case ITIMES: generic_itimes: {
+            BINARY_OPERANDS(ITIMES);
+            push(frame, como_rt_times(left, right));
+            break;
+        }
+        case IDIV: generic_idiv: {
+            BINARY_OPERANDS(IDIV);
+            push(frame, como_rt_div(left, right));
+            break;
+        }
+        case IREM: generic_irem: {
+            BINARY_OPERANDS(IREM);
+            push(frame, como_rt_rem(left, right));
+            break;
+        }
+        case IS_LESS_THAN: generic_is_less_than: {
+            BINARY_OPERANDS(IS_LESS_THAN);
+            push(frame, como_rt_is_less_than(left, right));
+            break;
+        }
+        case IS_LESS_THAN_OR_EQUAL: generic_is_less_than_or_equal: {
+            BINARY_OPERANDS(IS_LESS_THAN_OR_EQUAL);
+            push(frame, como_rt_is_less_than_or_equal(left, right));
+            break;
+        }
+        case IS_GREATER_THAN: generic_is_greater_than: {
+            BINARY_OPERANDS(IS_GREATER_THAN);
+            push(frame, como_rt_is_greater_than(left, right));
+            break;
+        }
+        case IS_GREATER_THAN_OR_EQUAL: generic_is_greater_than_or_equal: {
+            BINARY_OPERANDS(IS_GREATER_THAN_OR_EQUAL);
+            push(frame, como_rt_is_greater_than_or_equal(left, right));
+            break;
+        }
+        case IS_EQUAL: generic_is_equal: {
+            BINARY_OPERANDS(IS_EQUAL);
+            push(frame, como_rt_is_equal(left, right));
+            break;
+        }
+        case IS_NOT_EQUAL: generic_is_not_equal: {
+            BINARY_OPERANDS(IS_NOT_EQUAL);
+            push(frame, como_rt_is_not_equal(left, right));
+            break;
+        }
+        case UNARY_MINUS: {
+            push(frame, como_rt_unary_minus(pop(frame)));
+            break;
+        }
+        case JZ: {
+            Object *cond = pop(frame);
+            if(como_rt_is_false(cond)) {
+                *pc = (size_t)O_LVAL(opcode->operand);
+            }
+            break;
+        }
+        case JMP: {
+            size_t target = (size_t)O_LVAL(opcode->operand);
+            if(target < *pc && !como_options.no_trace) {
+                *pc = como_trace_back_edge(frame, opcode, *pc);
+            } else {
+                *pc = target;
+            }
+            break;
+        }
+        case LABEL: {
+            break;
+        }
+        case SWITCH: {
+            *pc = como_switch(frame, opcode);
+            break;
+        }
+        case FOR_RANGE: {
+            if(!como_for_range(frame, opcode)) {
+                *pc = (size_t)O_LVAL(COMO_JUMP_TARGET(opcode));
+            }
+            break;
+        }
+        case POP_TOP: {
+            (void)pop(frame);
+            break;
+        }
+        case HALT: {
+            break;
+        }
+        case LOAD_CONST: {
+								como_debug("LOAD_CONST");
+            push(frame, opcode->operand);
+            break;
+        }
+        case STORE_NAME: {
+            como_store_name(frame, O_SVAL(opcode->operand)->value, 
+                pop(frame));
+            break;
+        }
+						/* This is where recursion was broken, don't do *ex */
+        case LOAD_NAME: {
+            push(frame, como_load_name(frame, O_SVAL(opcode->operand)->value));
+            break;
+        }
+        case CALL_FUNCTION: {
+            como_call_function(frame, opcode);
+            break;
+        }
+        case IRETURN: {
+            /* If there wasn't a return statement found in func body*
+								 * The compiler will insert a 1 as the operand if 
+								 * the AST had an expression for the return statement,
+								 * otherwise, it will be 0
+								 * The actual value to be returned is popped from the stack
+								 */
+								if(! (O_LVAL(opcode->operand))) {
+                push(frame, newLong(0L));
+            }
+            return COMO_OP_RETURN;
+        }
+        case IPRINT: {
+            como_rt_print(pop(frame));
+            break;          
+        }
+    }
+
+    return COMO_OP_NEXT;
+}
+
+static void como_execute(ComoFrame *frame) {
+    size_t i;
+    for(i = 0; i < O_AVAL(frame->code)->size; i++) {
+        ComoOpCode *opcode = ((ComoOpCode *)(O_PTVAL(O_AVAL(frame->code)->table[i])));
+        if(como_execute_op(frame, opcode, opcode->op_code, &i) 
+                == COMO_OP_RETURN) {
+            return;
+        }
+    }
+}
+
+/* 
+ * Helpers called by JIT compiled code, see como_jit.c. Each one has the
+ * op_code the instruction had when its function was compiled folded into
+ * como_execute_op, and hands off to como_jit_op once the instruction has
+ * been rewritten since
+ */
+static int como_jit_op(ComoFrame *frame, ComoOpCode *opcode) {
+    size_t pc = 0;
+    return como_execute_op(frame, opcode, opcode->op_code, &pc);
+}
+
+#define JIT_HELPER(op) \
+static int como_jit_##op(ComoFrame *frame, ComoOpCode *opcode) { \
+    size_t pc = 0; \
+    if(opcode->op_code != (op)) { \
+        return como_jit_op(frame, opcode); \
+    } \
+    return como_execute_op(frame, opcode, (op), &pc); \
+}
+
+JIT_HELPER(LOAD_CONST)
+JIT_HELPER(LOAD_NAME)
+JIT_HELPER(STORE_NAME)
+JIT_HELPER(POP_TOP)
+JIT_HELPER(CALL_FUNCTION)
+JIT_HELPER(IRETURN)
+JIT_HELPER(IPRINT)
+JIT_HELPER(POSTFIX_INC)
+JIT_HELPER(POSTFIX_DEC)
+JIT_HELPER(PREFIX_INC)
+JIT_HELPER(PREFIX_DEC)
+JIT_HELPER(INPLACE_INC)
+JIT_HELPER(INPLACE_DEC)
+JIT_HELPER(INPLACE_ADD)
+JIT_HELPER(INPLACE_MINUS)
+JIT_HELPER(INPLACE_TIMES)
+JIT_HELPER(INPLACE_DIV)
+JIT_HELPER(INPLACE_REM)
+JIT_HELPER(UNARY_MINUS)
+JIT_HELPER(IADD_LONG_LONG)
+JIT_HELPER(IMINUS_LONG_LONG)
+JIT_HELPER(ITIMES_LONG_LONG)
+JIT_HELPER(IDIV_LONG_LONG)
+JIT_HELPER(IREM_LONG_LONG)
+JIT_HELPER(IS_LESS_THAN_LONG_LONG)
+JIT_HELPER(IS_LESS_THAN_OR_EQUAL_LONG_LONG)
+JIT_HELPER(IS_GREATER_THAN_LONG_LONG)
+JIT_HELPER(IS_GREATER_THAN_OR_EQUAL_LONG_LONG)
+JIT_HELPER(IS_EQUAL_LONG_LONG)
+JIT_HELPER(IS_NOT_EQUAL_LONG_LONG)
+JIT_HELPER(IS_EQUAL_STR_STR)
+JIT_HELPER(IS_NOT_EQUAL_STR_STR)
+JIT_HELPER(IADD_STR_STR)
+
+#define JIT_HELPER_CASE(op) case op: return como_jit_##op
+
+como_jit_helper_t como_jit_helper(unsigned char op_code) {
+    switch(op_code) {
+        JIT_HELPER_CASE(LOAD_CONST);
+        JIT_HELPER_CASE(LOAD_NAME);
+        JIT_HELPER_CASE(STORE_NAME);
+        JIT_HELPER_CASE(POP_TOP);
+        JIT_HELPER_CASE(CALL_FUNCTION);
+        JIT_HELPER_CASE(IRETURN);
+        JIT_HELPER_CASE(IPRINT);
+        JIT_HELPER_CASE(POSTFIX_INC);
+        JIT_HELPER_CASE(POSTFIX_DEC);
+        JIT_HELPER_CASE(PREFIX_INC);
+        JIT_HELPER_CASE(PREFIX_DEC);
+        JIT_HELPER_CASE(INPLACE_INC);
+        JIT_HELPER_CASE(INPLACE_DEC);
+        JIT_HELPER_CASE(INPLACE_ADD);
+        JIT_HELPER_CASE(INPLACE_MINUS);
+        JIT_HELPER_CASE(INPLACE_TIMES);
+        JIT_HELPER_CASE(INPLACE_DIV);
+        JIT_HELPER_CASE(INPLACE_REM);
+        JIT_HELPER_CASE(UNARY_MINUS);
+        JIT_HELPER_CASE(IADD_LONG_LONG);
+        JIT_HELPER_CASE(IMINUS_LONG_LONG);
+        JIT_HELPER_CASE(ITIMES_LONG_LONG);
+        JIT_HELPER_CASE(IDIV_LONG_LONG);
+        JIT_HELPER_CASE(IREM_LONG_LONG);
+        JIT_HELPER_CASE(IS_LESS_THAN_LONG_LONG);
+        JIT_HELPER_CASE(IS_LESS_THAN_OR_EQUAL_LONG_LONG);
+        JIT_HELPER_CASE(IS_GREATER_THAN_LONG_LONG);
+        JIT_HELPER_CASE(IS_GREATER_THAN_OR_EQUAL_LONG_LONG);
+        JIT_HELPER_CASE(IS_EQUAL_LONG_LONG);
+        JIT_HELPER_CASE(IS_NOT_EQUAL_LONG_LONG);
+        JIT_HELPER_CASE(IS_EQUAL_STR_STR);
+        JIT_HELPER_CASE(IS_NOT_EQUAL_STR_STR);
+        JIT_HELPER_CASE(IADD_STR_STR);
+        default:
+            return como_jit_op;
+    }
+}
+
+/* JZ or FOR_RANGE, the jump target is left to the native code */
+int como_jit_branch(ComoFrame *frame, ComoOpCode *opcode) {
+    size_t pc = (size_t)-1;
+    if(opcode->op_code == FOR_RANGE) {
+        return !como_for_range(frame, opcode);
+    }
+    (void)como_execute_op(frame, opcode, JZ, &pc);
+    return pc != (size_t)-1;
+}
+
+/* SWITCH, returns the pc of the LABEL of the case it takes */
+int como_jit_switch(ComoFrame *frame, ComoOpCode *opcode) {
+    return (int)como_switch(frame, opcode);
+}
+
+/* LOAD_NAME and STORE_NAME, for the operands JIT compiled code keeps */
+Object *como_jit_load_name(ComoFrame *frame, const char *name) {
+    return como_load_name(frame, name);
+}
+
+void como_jit_store_name(ComoFrame *frame, const char *name, Object *value) {
+    como_store_name(frame, name, value);
+}
+
+/* 
+ * Loop traces. A backward JMP taken COMO_TRACE_THRESHOLD times has the next
+ * iteration of its loop recorded: the instructions actually executed, in 
+ * order, with forward jumps followed and the operand types seen by binary
+ * instructions. The result is a straight line superblock, run over and 
+ * over by como_trace_run instead of the loop. Each JZ, and FOR_RANGE, 
+ * becomes a guard on the direction it took while recording, each SWITCH
+ * a guard on the case it took and each binary instruction on longs a
+ * guard on its operand types. When a guard fails the trace exits
+ * to como_execute at the instruction the guard stands for. A JZ guard 
+ * that keeps failing gets a side trace of the other direction recorded,
+ * which the trace branches to from then on.
+ *
+ * The trace is specialized as it is recorded. Loads, stores and INPLACE_
+ * instructions are run by como_trace_run itself, not by their helpers. A
+ * binary instruction on longs reads the names and constants loaded right
+ * before it itself, stores its result if a STORE_NAME follows, and a
+ * comparison a JZ tests is made by the JZ guard, without a long for its
+ * result
+ */
+#define COMO_TRACE_THRESHOLD 64
+#define COMO_TRACE_SIDE_THRESHOLD 8
+#define COMO_TRACE_MAX_ATTEMPTS 4
+#define COMO_TRACE_MAX_LENGTH 1024
+
+/* fails of a JZ guard whose other direction can't be traced */
+#define COMO_TRACE_NO_SIDE ((unsigned short)-1)
+
+enum {
+    COMO_TRACE_EXEC,           /* run the instruction by its helper */
+    COMO_TRACE_LOAD,           /* LOAD_NAME or LOAD_CONST, of left */
+    COMO_TRACE_STORE,          /* STORE_NAME */
+    COMO_TRACE_UPDATE,         /* INPLACE_, of right if it isn't by one */
+    COMO_TRACE_LONG_LONG,      /* binary instruction guarded on two longs */
+    COMO_TRACE_JZ,             /* JZ or FOR_RANGE guarded on the direction */
+    COMO_TRACE_SWITCH          /* SWITCH guarded on the case, its exit */
+};
+
+/* 
+ * An operand read by the trace op itself: a name, or a constant if name is
+ * NULL. If both are NULL it is on the stack
+ */
+typedef struct ComoTraceValue {
+    const char *name;
+    Object     *constant;
+} ComoTraceValue;
+
+typedef struct ComoTraceOp {
+    unsigned char     kind;
+    unsigned char     op;      /* generic op of a COMO_TRACE_LONG_LONG, a 
+                                  COMO_TRACE_UPDATE or a comparing JZ */
+    unsigned char     taken;   /* direction of a COMO_TRACE_JZ */
+    unsigned char     compare; /* the COMO_TRACE_JZ makes op itself */
+    unsigned short    fails;   /* of a COMO_TRACE_JZ without a side trace */
+    size_t            exit;    /* where como_execute resumes if it exits */
+    ComoOpCode       *opcode;
+    como_jit_helper_t helper;  /* runs a COMO_TRACE_EXEC */
+    ComoTraceValue    left;    /* operands of op */
+    ComoTraceValue    right;
+    const char       *store;   /* name stored to, NULL to push the result */
+    struct ComoTrace *side;    /* taken when a COMO_TRACE_JZ fails */
+} ComoTraceOp;
+
+typedef struct ComoTrace {
+    size_t      header;        /* pc after the LABEL starting the loop */
+    size_t      end;           /* pc of the backward JMP */
+    size_t      count;
+    ComoTraceOp ops[];
+} ComoTrace;
+
+typedef struct ComoTraceStats {
+    size_t recorded;
+    size_t side;               /* of recorded, side traces */
+    size_t aborted;
+    size_t instructions;       /* in all recorded traces */
+    size_t entries;
+    size_t iterations;         /* loop iterations run by a trace */
+    size_t exits;
+} ComoTraceStats;
+
+static ComoTraceStats trace_stats;
+
+static void como_trace_free(ComoTrace *trace) {
+    size_t i;
+
+    if(trace == NULL) {
+        return;
+    }
+
+    for(i = 0; i < trace->count; i++) {
+        como_trace_free(trace->ops[i].side);
+    }
+
+    free(trace);
+}
+
+static int como_trace_long_long_op(unsigned char op) {
+    switch(como_opcode_generic(op)) {
+        case IADD: case IMINUS: case ITIMES: case IDIV: case IREM:
+        case IS_LESS_THAN: case IS_LESS_THAN_OR_EQUAL: case IS_GREATER_THAN:
+        case IS_GREATER_THAN_OR_EQUAL: case IS_EQUAL: case IS_NOT_EQUAL:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int como_trace_compare_op(unsigned char op) {
+    return op != IADD && op != IMINUS && op != ITIMES && op != IDIV 
+        && op != IREM;
+}
+
+/* 
+ * The operand of an op being recorded from the op before it, a load,
+ * which is then removed, else the stack
+ */
+static ComoTraceValue como_trace_take_load(ComoTrace *trace, size_t *count,
+    size_t *exit)
+{
+    ComoTraceValue value = { NULL, NULL };
+
+    if(*count > 0 && trace->ops[*count - 1].kind == COMO_TRACE_LOAD) {
+        (*count)--;
+        value = trace->ops[*count].left;
+        *exit = trace->ops[*count].exit;
+    }
+
+    return value;
+}
+
+static inline int como_trace_on_stack(const ComoTraceValue *value) {
+    return value->name == NULL && value->constant == NULL;
+}
+
+/* 
+ * Runs the rest of an iteration of the loop from header to end, starting
+ * at start, and records it. Returns NULL if the iteration leaves the loop,
+ * enters another one or returns, *pc is then where como_execute carries 
+ * on. Like there, a pc is that of the instruction run last
+ */
+static ComoTrace *como_trace_record(ComoFrame *frame, size_t header,
+    size_t end, size_t start, size_t *pc) 
+{
+    Array *code = O_AVAL(frame->code);
+    size_t i = start;
+    size_t count = 0;
+    ComoTrace *trace = malloc(sizeof(ComoTrace) 
+        + sizeof(ComoTraceOp) * COMO_TRACE_MAX_LENGTH);
+
+    for(;;) {
+        ComoOpCode *opcode;
+        ComoTraceOp *t, *last;
+
+        if(i < header || i > end || count == COMO_TRACE_MAX_LENGTH) {
+            goto abort;
+        }
+
+        if(i == end) {
+            break;
+        }
+
+        opcode = (ComoOpCode *)O_PTVAL(code->table[i]);
+        last = count > 0 ? &trace->ops[count - 1] : NULL;
+
+        switch(opcode->op_code) {
+            case LABEL:
+            case NOP:
+                i++;
+            continue;
+            case JMP:
+                if((size_t)O_LVAL(opcode->operand) < i) {
+                    goto abort;
+                }
+                i = (size_t)O_LVAL(opcode->operand) + 1;
+            continue;
+            case IRETURN:
+            case HALT:
+                goto abort;
+            case JZ:
+            case FOR_RANGE: {
+                size_t target = (size_t)O_LVAL(COMO_JUMP_TARGET(opcode));
+                int compare = opcode->op_code == JZ && last != NULL 
+                    && last->kind == COMO_TRACE_LONG_LONG 
+                    && last->store == NULL && como_trace_compare_op(last->op);
+                if(compare) {
+                    t = last;
                 } else {
-                    if(O_TYPE(value) != IS_LONG) {
-                        como_error_noreturn("unsupported value for POSTFIX_DEC");
+                    t = &trace->ops[count++];
+                    memset(t, 0, sizeof(*t));
+                }
+                t->kind = COMO_TRACE_JZ;
+                t->compare = (unsigned char)compare;
+                t->opcode = opcode;
+                t->taken = opcode->op_code == FOR_RANGE 
+                    ? !como_for_range(frame, opcode)
+                    : como_rt_is_false(pop(frame));
+                t->exit = t->taken ? i : target;
+                t->fails = 0;
+                i = t->taken ? target + 1 : i + 1;
+                continue;
+            }
+            case SWITCH:
+                t = &trace->ops[count++];
+                memset(t, 0, sizeof(*t));
+                t->kind = COMO_TRACE_SWITCH;
+                t->opcode = opcode;
+                t->exit = como_switch(frame, opcode);
+                i = t->exit + 1;
+            continue;
+            case STORE_NAME:
+                /* The result is stored by the binary instruction itself */
+                if(last != NULL && last->kind == COMO_TRACE_LONG_LONG 
+                        && last->store == NULL) {
+                    last->store = O_SVAL(opcode->operand)->value;
+                    (void)como_jit_op(frame, opcode);
+                    i++;
+                    continue;
+                }
+            break;
+        }
+
+        t = &trace->ops[count++];
+        memset(t, 0, sizeof(*t));
+        t->kind = COMO_TRACE_EXEC;
+        t->opcode = opcode;
+        t->helper = como_jit_helper(opcode->op_code);
+        t->exit = i - 1;
+
+        switch(opcode->op_code) {
+            case LOAD_NAME:
+                t->kind = COMO_TRACE_LOAD;
+                t->left.name = O_SVAL(opcode->operand)->value;
+            break;
+            case LOAD_CONST:
+                t->kind = COMO_TRACE_LOAD;
+                t->left.constant = opcode->operand;
+            break;
+            case STORE_NAME:
+                t->kind = COMO_TRACE_STORE;
+                t->store = O_SVAL(opcode->operand)->value;
+            break;
+            case INPLACE_INC:
+            case INPLACE_DEC:
+                t->kind = COMO_TRACE_UPDATE;
+                t->op = opcode->op_code == INPLACE_INC ? IADD : IMINUS;
+                t->store = O_SVAL(opcode->operand)->value;
+            break;
+            case INPLACE_ADD:
+            case INPLACE_MINUS:
+            case INPLACE_TIMES:
+            case INPLACE_DIV:
+            case INPLACE_REM: {
+                static const unsigned char binary[] = { 
+                    IADD, IMINUS, ITIMES, IDIV, IREM 
+                };
+                ComoTraceValue right;
+                size_t exit;
+                count--;
+                right = como_trace_take_load(trace, &count, &exit);
+                t = &trace->ops[count++];
+                memset(t, 0, sizeof(*t));
+                t->kind = COMO_TRACE_UPDATE;
+                t->opcode = opcode;
+                t->exit = i - 1;
+                t->op = binary[opcode->op_code - INPLACE_ADD];
+                t->right = right;
+                t->store = O_SVAL(opcode->operand)->value;
+                break;
+            }
+            default:
+                if(como_trace_long_long_op(opcode->op_code)) {
+                    Object *right = frame->cf_stack[frame->cf_sp - 1];
+                    Object *left = frame->cf_stack[frame->cf_sp - 2];
+                    if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) {
+                        ComoTraceValue a = { NULL, NULL }, b;
+                        size_t exit = i - 1;
+                        count--;
+                        /* The left operand is only read if the right is */
+                        b = como_trace_take_load(trace, &count, &exit);
+                        if(!como_trace_on_stack(&b)) {
+                            a = como_trace_take_load(trace, &count, &exit);
+                        }
+                        t = &trace->ops[count++];
+                        memset(t, 0, sizeof(*t));
+                        t->kind = COMO_TRACE_LONG_LONG;
+                        t->opcode = opcode;
+                        t->op = como_opcode_generic(opcode->op_code);
+                        t->left = a;
+                        t->right = b;
+                        t->exit = exit;
+                    }
+                }
+            break;
+        }
+
+        (void)como_jit_op(frame, opcode);
+        i++;
+    }
+
+    trace = realloc(trace, sizeof(ComoTrace) + sizeof(ComoTraceOp) * count);
+    trace->header = header;
+    trace->end = end;
+    trace->count = count;
+
+    trace_stats.recorded++;
+    trace_stats.instructions += count;
+
+    return trace;
+
+abort:
+    free(trace);
+    trace_stats.aborted++;
+    *pc = i - 1;
+    return NULL;
+}
+
+static inline Object *como_trace_value(ComoFrame *frame, 
+    const ComoTraceValue *value, size_t *sp) 
+{
+    if(value->name != NULL) {
+        return como_load_name(frame, value->name);
+    }
+
+    if(value->constant != NULL) {
+        return value->constant;
+    }
+
+    return frame->cf_stack[--*sp];
+}
+
+static inline long como_trace_long_long(unsigned char op, long left, 
+    long right)
+{
+    switch(op) {
+        case IADD:                     return left + right;
+        case IMINUS:                   return left - right;
+        case ITIMES:                   return left * right;
+        case IDIV:                     return left / right;
+        case IREM:                     return left % right;
+        case IS_LESS_THAN:             return left < right;
+        case IS_LESS_THAN_OR_EQUAL:    return left <= right;
+        case IS_GREATER_THAN:          return left > right;
+        case IS_GREATER_THAN_OR_EQUAL: return left >= right;
+        case IS_EQUAL:                 return left == right;
+        default:                       return left != right;
+    }
+}
+
+/* A comparing JZ whose operands aren't both longs */
+static int como_trace_compare(unsigned char op, Object *left, Object *right) {
+    switch(op) {
+        case IS_LESS_THAN: 
+            return como_rt_is_false(como_rt_is_less_than(left, right));
+        case IS_LESS_THAN_OR_EQUAL:
+            return como_rt_is_false(como_rt_is_less_than_or_equal(left, right));
+        case IS_GREATER_THAN:
+            return como_rt_is_false(como_rt_is_greater_than(left, right));
+        case IS_GREATER_THAN_OR_EQUAL:
+            return como_rt_is_false(
+                como_rt_is_greater_than_or_equal(left, right));
+        case IS_EQUAL:
+            return como_rt_is_false(como_rt_is_equal(left, right));
+        default:
+            return como_rt_is_false(como_rt_is_not_equal(left, right));
+    }
+}
+
+/* 
+ * Runs root, the trace of a whole iteration, until a guard fails. Returns
+ * the pc como_execute continues from
+ */
+static size_t como_trace_run(ComoFrame *frame, ComoTrace *root) {
+    ComoTrace *trace = root;
+    size_t i, pc;
+
+    trace_stats.entries++;
+
+    for(;;) {
+run:
+        for(i = 0; i < trace->count; i++) {
+            ComoTraceOp *t = &trace->ops[i];
+            switch(t->kind) {
+                case COMO_TRACE_EXEC:
+                    (void)t->helper(frame, t->opcode);
+                break;
+                case COMO_TRACE_LOAD: 
+                    push(frame, t->left.name != NULL 
+                        ? como_load_name(frame, t->left.name) 
+                        : t->left.constant);
+                break;
+                case COMO_TRACE_STORE: {
+                    Object *value = pop(frame);
+                    O_FLG(value) = (O_FLG(value) & ~COMO_OWNED) | COMO_BOUND;
+                    mapInsertEx(frame->cf_symtab, t->store, value);
+                    break;
+                }
+                case COMO_TRACE_UPDATE: {
+                    Object *right = NULL;
+                    size_t sp = frame->cf_sp;
+                    if(t->opcode->op_code != INPLACE_INC 
+                            && t->opcode->op_code != INPLACE_DEC) {
+                        right = como_trace_value(frame, &t->right, &sp);
+                        frame->cf_sp = sp;
+                    }
+                    (void)como_update_name(frame, t->store, t->op, right, 0);
+                    break;
+                }
+                case COMO_TRACE_LONG_LONG: {
+                    size_t sp = frame->cf_sp;
+                    Object *right = como_trace_value(frame, &t->right, &sp);
+                    Object *left = como_trace_value(frame, &t->left, &sp);
+                    Object *value;
+                    if(O_TYPE(left) != IS_LONG || O_TYPE(right) != IS_LONG
+                            || ((t->op == IDIV || t->op == IREM) 
+                                && O_LVAL(right) == 0)) {
+                        trace_stats.exits++;
+                        return t->exit;
+                    }
+                    frame->cf_sp = sp;
+                    value = newLong(como_trace_long_long(t->op, 
+                        O_LVAL(left), O_LVAL(right)));
+                    if(t->store != NULL) {
+                        mapInsertEx(frame->cf_symtab, t->store, value);
                     } else {
-                        long oldvalue = O_LVAL(value);
-                        O_LVAL(value) = oldvalue - 1;
-                        push(frame, newLong(oldvalue));
-                    }   
+                        push(frame, value);
+                    }
+                    break;
                 }
-                break;        
-            }
-						case IS_LESS_THAN: {
-							Object *right = pop(frame);
-							Object *left = pop(frame);
-							assert(right);
-							assert(left);
-
-							if(objectValueIsLessThan(left, right)) {
-								push(frame, newLong(1L));
-							} else {
-								push(frame, newLong(0L));
-							}
-							break;
-						}
-						case IADD: {
-							Object *right = pop(frame);
-							Object *left = pop(frame);
-							assert(right);
-							assert(left);
-
-							if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) {
-								long value = O_LVAL(left) + O_LVAL(right);
-								push(frame, newLong(value));
-							} else {
-								char *left_str = objectToString(left);
-								char *right_str = objectToString(right);
-								Object *s1 = newString(left_str);
-								Object *s2 = newString(right_str);
-								Object *value = stringCat(s1, s2);
-								push(frame, value);
-								objectDestroy(s1);
-								objectDestroy(s2);
-								free(left_str);
-								free(right_str);	
-							}
-							break;
-						}
-            case IMINUS: {
-                Object *right = pop(frame);
-                Object *left = pop(frame);
-                assert(right);
-                assert(left);
-                if(O_TYPE(left) != IS_LONG && O_TYPE(right) != IS_LONG) {
-                    como_error_noreturn("unsupported value for IMINUS");
-                } else {
-                    push(frame, newLong(O_LVAL(left) - O_LVAL(right)));
-                }      
+                case COMO_TRACE_JZ: {
+                    int taken;
+                    if(t->compare) {
+                        size_t sp = frame->cf_sp;
+                        Object *right = como_trace_value(frame, &t->right, &sp);
+                        Object *left = como_trace_value(frame, &t->left, &sp);
+                        frame->cf_sp = sp;
+                        taken = O_TYPE(left) == IS_LONG 
+                            && O_TYPE(right) == IS_LONG
+                            ? !como_trace_long_long(t->op, O_LVAL(left), 
+                                O_LVAL(right))
+                            : como_trace_compare(t->op, left, right);
+                    } else {
+                        taken = t->opcode->op_code == FOR_RANGE 
+                            ? !como_for_range(frame, t->opcode)
+                            : como_rt_is_false(pop(frame));
+                    }
+                    if(taken == t->taken) {
+                        break;
+                    }
+                    if(t->side != NULL) {
+                        trace = t->side;
+                        goto run;
+                    }
+                    if(t->fails == COMO_TRACE_NO_SIDE 
+                            || ++t->fails < COMO_TRACE_SIDE_THRESHOLD) {
+                        trace_stats.exits++;
+                        return t->exit;
+                    }
+                    /* Recording runs the rest of this iteration */
+                    t->side = como_trace_record(frame, root->header, 
+                        root->end, t->exit + 1, &pc);
+                    if(t->side == NULL) {
+                        t->fails = COMO_TRACE_NO_SIDE;
+                        trace_stats.exits++;
+                        return pc;
+                    }
+                    trace_stats.side++;
+                    i = trace->count;
+                    break;
+                }
+                case COMO_TRACE_SWITCH:
+                    pc = como_switch(frame, t->opcode);
+                    if(pc != t->exit) {
+                        trace_stats.exits++;
+                        return pc;
+                    }
                 break;
             }
-            case IS_LESS_THAN_OR_EQUAL: {
-                Object *right = pop(frame);
-                Object *left = pop(frame);
-                assert(right);
-                assert(left);
+        }
+        trace = root;
+        trace_stats.iterations++;
+    }
+}
+
+/* 
+ * Called for every backward JMP taken, pc is that of the JMP. Returns the
+ * pc como_execute continues from
+ */
+static size_t como_trace_back_edge(ComoFrame *frame, ComoOpCode *jmp, 
+    size_t pc) 
+{
+    size_t target = (size_t)O_LVAL(jmp->operand);
+
+    if(jmp->op_trace == NULL) {
+        if(++jmp->op_hits < COMO_TRACE_THRESHOLD 
+                || jmp->op_misses >= COMO_TRACE_MAX_ATTEMPTS) {
+            return target;
+        }
+
+        jmp->op_hits = 0;
+        jmp->op_trace = como_trace_record(frame, target + 1, pc, target + 1,
+            &target);
+
+        if(jmp->op_trace == NULL) {
+            jmp->op_misses++;
+            return target;
+        }
+    }
+
+    return como_trace_run(frame, jmp->op_trace);
+}
+
+static void como_trace_print_stats(void) {
+    fprintf(stderr, "traces: %zu recorded (%zu side), %zu aborted, "
+        "%zu instructions\n", trace_stats.recorded, trace_stats.side, 
+        trace_stats.aborted, trace_stats.instructions);
+    fprintf(stderr, "traces: %zu entries, %zu iterations, %zu exits\n",
+        trace_stats.entries, trace_stats.iterations, trace_stats.exits);
+}
+
+static void como_init_global_frame(const char *filename) {
+    Object *main_code = newArray(4);
+    global_frame = create_frame(main_code);
+    global_frame->filename = newString(filename);
+    mapInsertEx(global_frame->cf_symtab, "__FUNCTION__", 
+        newString("__main__"));
+}
+
+/* Shared by the --jobs workers, each one claims the next unit */
+typedef struct ComoCompileQueue {
+    ast_node     **units;
+    Object       **bindings;
+    size_t         count;
+    size_t         next;
+} ComoCompileQueue;
+
+static void *como_compile_worker(void *arg) {
+    ComoCompileQueue *queue = (ComoCompileQueue *)arg;
+    size_t i;
+
+    while((i = __sync_fetch_and_add(&queue->next, 1)) < queue->count) {
+        compile_bindings = queue->bindings[i];
+        como_compile(queue->units[i], global_frame);
+    }
+
+    compile_bindings = NULL;
+
+    return NULL;
+}
+
+/* 
+ * Compiles the top level function declarations of the program on 
+ * como_options.jobs threads, each into its own frame. Nothing is bound 
+ * here, bindings[i] receives everything units[i] declares
+ */
+static void como_compile_parallel(ast_node **units, Object **bindings, 
+    size_t count) 
+{
+    ComoCompileQueue queue;
+    pthread_t *threads;
+    size_t i, nthreads = (size_t)como_options.jobs;
+
+    if(nthreads > count) {
+        nthreads = count;
+    }
+
+    queue.units = units;
+    queue.bindings = bindings;
+    queue.count = count;
+    queue.next = 0;
+
+    threads = malloc(sizeof(pthread_t) * nthreads);
+
+    for(i = 0; i < nthreads; i++) {
+        if(pthread_create(&threads[i], NULL, como_compile_worker, &queue)) {
+            como_error_noreturn("pthread_create failed");
+        }
+    }
+
+    for(i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+}
+
+/* 
+ * Like como_compile for the whole program, but function bodies are compiled
+ * concurrently first. The top statements are then walked in source order,
+ * binding each precompiled function where a serial compile would have
+ */
+static void como_compile_program_parallel(ast_node *p) {
+    ast_node_statements *program = &p->u1.statements_node;
+    ast_node **units = malloc(sizeof(ast_node *) * (program->count + 1));
+    Object **bindings = malloc(sizeof(Object *) * (program->count + 1));
+    size_t i, j, count = 0;
+
+    for(i = 0; i < program->count; i++) {
+        if(program->statement_list[i]->type == AST_NODE_TYPE_FUNC_DECL) {
+            units[count] = program->statement_list[i];
+            bindings[count] = newArray(2);
+            count++;
+        }
+    }
+
+    como_compile_parallel(units, bindings, count);
+
+    for(i = 0, count = 0; i < program->count; i++) {
+        ast_node *stmt = program->statement_list[i];
+        if(stmt->type != AST_NODE_TYPE_FUNC_DECL) {
+            como_compile(stmt, global_frame);
+            continue;
+        }
+        Array *pairs = O_AVAL(bindings[count]);
+        for(j = 0; j < pairs->size; j += 2) {
+            mapInsertEx(global_frame->cf_symtab, 
+                O_SVAL(pairs->table[j])->value, pairs->table[j + 1]);
+        }
+        count++;
+    }
 
-                if(objectValueCompare(left, right) || objectValueIsLessThan(left, right)) {
-                    push(frame, newLong(1L));
-                } else {
-                    push(frame, newLong(0L));
-                }
-                break;
-            }
-            case JZ: {
-                Object *cond = pop(frame);
-                if(O_TYPE(cond) == IS_LONG && O_LVAL(cond) == 0) {
-                    i = (size_t)O_LVAL(opcode->operand);      
-                    continue;          
-                }
-                break;
-            }
-            case JMP: {
-                i = O_LVAL(opcode->operand);
-                continue;
-            }
-            case LABEL: {
-                break;
-            }
-            case HALT: {
-                break;
-            }
-						case IS_NOT_EQUAL: {
-							Object *right = pop(frame);
-							Object *left = pop(frame);
-
-							if(!objectValueCompare(left, right)) {
-								push(frame, newLong(1L));
-							} else {
-								push(frame, newLong(0L));
-							}
-							break;
-						}
-            case LOAD_CONST: {
-								como_debug("LOAD_CONST");
-                push(frame, opcode->operand);
-                break;
+    free(units);
+    free(bindings);
+}
+
+/* Sizes the global frame stack for the code about to be executed */
+static void como_global_frame_verify(void) {
+    size_t depth = como_verify_code(global_frame->code, "__main__");
+
+    if(depth > global_frame->cf_stack_size || global_frame->cf_stack == NULL) {
+        global_frame->cf_stack = realloc(global_frame->cf_stack, 
+            sizeof(Object *) * (depth + 1));
+        global_frame->cf_stack_size = depth;
+    }
+}
+
+/* 
+ * Adds every name p reads to reads, and the function declarations in it to
+ * functions, without looking into their bodies
+ */
+static void como_find_reads(ast_node *p, Object *reads, Object *functions) {
+    size_t i;
+
+    if(p == NULL) {
+        return;
+    }
+
+    switch(p->type) {
+        case AST_NODE_TYPE_ID:
+            mapInsert(reads, AST_NODE_AS_ID(p), newLong(1L));
+        break;
+        case AST_NODE_TYPE_POSTFIX:
+            mapInsert(reads, AST_NODE_AS_ID(p->u1.postfix_node.expr), 
+                newLong(1L));
+        break;
+        case AST_NODE_TYPE_PREFIX:
+            como_find_reads(p->u1.prefix_node.expr, reads, functions);
+        break;
+        case AST_NODE_TYPE_STATEMENT_LIST:
+            for(i = 0; i < p->u1.statements_node.count; i++) {
+                como_find_reads(p->u1.statements_node.statement_list[i], 
+                    reads, functions);
             }
-            case STORE_NAME: {
-                Object *value = pop(frame);
-                mapInsertEx(frame->cf_symtab, 
-                    O_SVAL(opcode->operand)->value, value);
-                break;
+        break;
+        case AST_NODE_TYPE_BIN_OP:
+            if(p->u1.binary_node.type != AST_BINARY_OP_ASSIGN) {
+                como_find_reads(p->u1.binary_node.left, reads, functions);
             }
-						/* This is where recursion was broken, don't do *ex */
-            case LOAD_NAME: {
-                Object *value = NULL;
-                value = mapSearch(frame->cf_symtab, 
-                    O_SVAL(opcode->operand)->value);
-                if(value) {
-                    goto load_name_leave;
-                } else {
-                    value = mapSearch(global_frame->cf_symtab, 
-                        O_SVAL(opcode->operand)->value);
-                }
+            como_find_reads(p->u1.binary_node.right, reads, functions);
+        break;
+        case AST_NODE_TYPE_UNARY_OP:
+            como_find_reads(p->u1.unary_node.expr, reads, functions);
+        break;
+        case AST_NODE_TYPE_IF:
+            como_find_reads(p->u1.if_node.condition, reads, functions);
+            como_find_reads(p->u1.if_node.b1, reads, functions);
+            como_find_reads(p->u1.if_node.b2, reads, functions);
+        break;
+        case AST_NODE_TYPE_WHILE:
+            como_find_reads(p->u1.while_node.condition, reads, functions);
+            como_find_reads(p->u1.while_node.body, reads, functions);
+        break;
+        case AST_NODE_TYPE_FOR:
+            como_find_reads(p->u1.for_node.initialization, reads, functions);
+            como_find_reads(p->u1.for_node.condition, reads, functions);
+            como_find_reads(p->u1.for_node.final_expression, reads, functions);
+            como_find_reads(p->u1.for_node.body, reads, functions);
+        break;
+        case AST_NODE_TYPE_SWITCH:
+            como_find_reads(p->u1.switch_node.expr, reads, functions);
+            como_find_reads(p->u1.switch_node.cases, reads, functions);
+        break;
+        case AST_NODE_TYPE_CASE:
+            como_find_reads(p->u1.case_node.body, reads, functions);
+        break;
+        case AST_NODE_TYPE_RET:
+            como_find_reads(p->u1.return_node.expr, reads, functions);
+        break;
+        case AST_NODE_TYPE_PRINT:
+            como_find_reads(p->u1.print_node.expr, reads, functions);
+        break;
+        case AST_NODE_TYPE_FUNC_DECL:
+            arrayPushEx(functions, newPointer((void *)p));
+        break;
+        case AST_NODE_TYPE_CALL:
+            mapInsert(reads, AST_NODE_AS_ID(p->u1.call_node.id), newLong(1L));
+            como_find_reads(p->u1.call_node.arguments, reads, functions);
+        break;
+        default:
+        break;
+    }
+}
 
-                if(value == NULL) {
-                    como_error_noreturn("undefined variable '%s'", 
-                        O_SVAL(opcode->operand)->value);
-                }
-load_name_leave:
-                push(frame, value);
-                break;
-            }
-            case CALL_FUNCTION: {
-                Object *fn = pop(frame);
-                Object *argcount = pop(frame);
-                long i = O_LVAL(argcount);
-                ComoFrame *fnframe;
-                if(O_TYPE(fn) != IS_POINTER) {
-                    como_error_noreturn("name '%s' is not callable",
-                        O_SVAL(opcode->operand)->value);
-                }
-                fnframe = (ComoFrame *)O_PTVAL(fn);
-                if(O_LVAL(argcount) != (long)(O_AVAL(fnframe->namedparameters)->size)) {
-                    como_error_noreturn("callable '%s' expects %ld arguments, but %ld were given",
-                        O_SVAL(opcode->operand)->value, 
-                        (long)(O_AVAL(fnframe->namedparameters)->size), 
-                        O_LVAL(argcount));
-                }
-								//como_debug("calling '%s'", O_SVAL(opcode->operand)->value);
-                // DOING THIS ACTUALLY DEFINES THE NAME AT RUNTIME
-								// which could not be equal to that actual function body 
-								// declared
-								// name = my_function
-								// name() 
-								// that call will have "name" for value __FUNCTION__
-								// even though the real function is my_function
-								// must define it at COMPILE time
-								// mapInsertEx(fnframe->cf_symtab, "__FUNCTION__", 
-                // newString(O_SVAL(opcode->operand)->value));
-
-                while(i--) {
-                    como_debug("getting %ldth argument for function call '%s'",
-                        i, O_SVAL(opcode->operand)->value);
-                    Object *argname = O_AVAL(fnframe->namedparameters)->table[i];
-
-                    Object *argvalue = pop(frame);
-                    mapInsert(fnframe->cf_symtab, O_SVAL(argname)->value,
-                        argvalue);
-                    char *argvaluestr = objectToString(argvalue);
-                    
-										como_debug("%ldth argument: '%s' has value: %s", i, O_SVAL(argname)->value,
-                        argvaluestr);
-										free(argvaluestr);
-                }
-                //ComoFrame *prev = frame;
+/* 
+ * The functions the top level code may call, directly or through other 
+ * ones, into live_functions. Returns every name they or it read
+ */
+static Object *como_find_live(ast_node *program) {
+    Object *reads = newMap(16);
+    Object *functions = newArray(8);
+    int changed = 1;
+    size_t i;
 
-                //fnframe->next = prev;
+    live_functions = newMap(16);
 
-                como_execute(fnframe, NULL);
-                
-								push(frame, pop(fnframe));
-								//fnframe->next = NULL;
+    como_find_reads(program, reads, functions);
 
-                break;
+    while(changed) {
+        changed = 0;
+        for(i = 0; i < O_AVAL(functions)->size; i++) {
+            ast_node *fn = (ast_node *)O_PTVAL(O_AVAL(functions)->table[i]);
+            const char *name = fn->u1.function_node.name;
+            if(mapSearch(reads, name) != NULL 
+                    && mapSearch(live_functions, name) == NULL) {
+                mapInsert(live_functions, name, newLong(1L));
+                como_find_reads(fn->u1.function_node.body, reads, functions);
+                changed = 1;
             }
-						case IS_EQUAL: {
-							Object *right = pop(frame);
-							Object *left = pop(frame);
-							push(frame, newLong((long)objectValueCompare(left, right)));
-							break;
-						}
-            case ITIMES: {
-                Object *right = pop(frame);
-                Object *left = pop(frame);
-                assert(right);
-								assert(left);
-
-								if(O_TYPE(right) != IS_LONG && O_TYPE(left) != IS_LONG) {
-                    como_error_noreturn("invalid operands for ITIMES");
-                }
-								como_debug("ITIMES: %d, %d", O_TYPE(left),
-											O_TYPE(right));
+        }
+    }
 
-                long value = O_LVAL(left) * O_LVAL(right);
-                push(frame, newLong(value));
-                break;
-            }
-            case IRETURN: {
-                /* If there wasn't a return statement found in func body*
-								 * The compiler will insert a 1 as the operand if 
-								 * the AST had an expression for the return statement,
-								 * otherwise, it will be 0
-								 * The actual value to be returned is popped from the stack
-								 */
-								if(! (O_LVAL(opcode->operand))) {
-                    push(frame, newLong(0L));
+    objectDestroy(functions);
+
+    return reads;
+}
+
+/* 
+ * The optimization passes, in the order of ComoPassId. The AST ones run
+ * once, on the whole program before it is compiled, the code ones on every
+ * code array once it is compiled and before it is verified. The lowerings
+ * and the ssa ones are run where they apply, once como_pass_enabled says 
+ * they may. A pass runs from its -O level up
+ */
+typedef enum {
+    COMO_PASS_AST,
+    COMO_PASS_CODE,
+    COMO_PASS_LOWERING,
+    COMO_PASS_SSA,
+} ComoPassKind;
+
+typedef struct ComoPass {
+    const char  *name;
+    int          level;
+    ComoPassKind kind;
+    int        (*ast)(ast_node *program);           /* 0 if it didn't apply */
+    void       (*code)(Object *code, int top_level);
+    size_t       runs;                              /* for --time-passes */
+    uint64_t     nanoseconds;
+    long         instructions;                      /* added, or removed */
+} ComoPass;
+
+/* Only the functions the top level code may call are compiled */
+static int como_pass_live_functions(ast_node *program) {
+    /* Lazy bodies aren't parsed yet, any function may be read by one */
+    if(como_options.lazy) {
+        return 0;
+    }
+
+    program_reads = como_find_live(program);
+
+    return 1;
+}
+
+static void como_pass_dead_code(Object *code, int top_level) {
+    Object *read;
+
+    /* Without program_reads, nothing is known of what reads the top level */
+    if(top_level) {
+        como_dead_code(code, program_reads);
+        return;
+    }
+
+    /* Its names are its own, nothing else reads them */
+    read = newMap(2);
+    como_dead_code(code, read);
+    objectDestroy(read);
+}
+
+static ComoPass passes[] = {
+    { "live-functions", 2, COMO_PASS_AST, como_pass_live_functions, NULL, 
+        0, 0, 0 },
+    { "dead-code",      1, COMO_PASS_CODE, NULL, como_pass_dead_code, 
+        0, 0, 0 },
+    { "inplace",        1, COMO_PASS_LOWERING, NULL, NULL, 0, 0, 0 },
+    { "for-range",      1, COMO_PASS_LOWERING, NULL, NULL, 0, 0, 0 },
+    { "ssa-cse",        1, COMO_PASS_SSA, NULL, NULL, 0, 0, 0 },
+    { "ssa-evaluate",   2, COMO_PASS_SSA, NULL, NULL, 0, 0, 0 },
+    { "ssa-inline",     2, COMO_PASS_SSA, NULL, NULL, 0, 0, 0 },
+    { "ssa-licm",       2, COMO_PASS_SSA, NULL, NULL, 0, 0, 0 },
+};
+
+#define COMO_PASS_COUNT (sizeof(passes) / sizeof(passes[0]))
+
+/* --jobs workers compile and run the code passes concurrently */
+static pthread_mutex_t passes_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int como_pass_enabled(ComoPassId id) {
+    return passes[id].level <= como_options.opt_level;
+}
+
+uint64_t como_pass_clock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void como_pass_record(ComoPassId id, uint64_t start, long delta) {
+    uint64_t elapsed = como_pass_clock() - start;
+
+    pthread_mutex_lock(&passes_lock);
+    passes[id].runs++;
+    passes[id].nanoseconds += elapsed;
+    passes[id].instructions += delta;
+    pthread_mutex_unlock(&passes_lock);
+}
+
+static void como_run_ast_passes(ast_node *program) {
+    size_t i;
+
+    for(i = 0; i < COMO_PASS_COUNT; i++) {
+        ComoPass *pass = &passes[i];
+        uint64_t start;
+
+        if(pass->kind != COMO_PASS_AST || !como_pass_enabled((ComoPassId)i)) {
+            continue;
+        }
+
+        start = como_pass_clock();
+        if(pass->ast(program)) {
+            como_pass_record((ComoPassId)i, start, 0);
+        }
+    }
+}
+
+static void como_run_code_passes(Object *code, int top_level) {
+    size_t i;
+
+    for(i = 0; i < COMO_PASS_COUNT; i++) {
+        ComoPass *pass = &passes[i];
+        size_t before = O_AVAL(code)->size;
+        uint64_t start;
+
+        if(pass->kind != COMO_PASS_CODE 
+                || !como_pass_enabled((ComoPassId)i)) {
+            continue;
+        }
+
+        start = como_pass_clock();
+        pass->code(code, top_level);
+        como_pass_record((ComoPassId)i, start, 
+            (long)O_AVAL(code)->size - (long)before);
+    }
+}
+
+static void como_print_pass_times(void) {
+    uint64_t total = 0;
+    size_t i;
+
+    fprintf(stderr, "%-24s %6s %10s %14s\n", "pass", "runs", "usec", 
+        "instructions");
+
+    for(i = 0; i < COMO_PASS_COUNT; i++) {
+        ComoPass *pass = &passes[i];
+        if(!como_pass_enabled((ComoPassId)i)) {
+            continue;
+        }
+        fprintf(stderr, "%-24s %6zu %10.1f ", pass->name, pass->runs, 
+            (double)pass->nanoseconds / 1000.0);
+        /* The AST and the ssa form have no bytecode to count */
+        if(pass->kind == COMO_PASS_AST || pass->kind == COMO_PASS_SSA) {
+            fprintf(stderr, "%14s\n", "-");
+        } else {
+            fprintf(stderr, "%+14ld\n", pass->instructions);
+        }
+        total += pass->nanoseconds;
+    }
+
+    fprintf(stderr, "passes: -O%d, %.1f usec\n", como_options.opt_level, 
+        (double)total / 1000.0);
+}
+
+static void como_compile_ast(ast_node *p) {
+    Object *main_code = global_frame->code;
+
+    como_run_ast_passes(p);
+
+    /* Lazy declarations have no body to compile */
+    if(como_options.jobs > 1 && !como_options.lazy 
+            && p->type == AST_NODE_TYPE_STATEMENT_LIST) {
+        como_compile_program_parallel(p);
+    } else {
+        (void)como_compile(p, global_frame);
+    }
+    
+    arrayPushEx(main_code, newPointer((void *)create_op(HALT, NULL)));
+
+    como_run_code_passes(main_code, 1);
+
+    if(program_reads != NULL) {
+        objectDestroy(program_reads);
+        program_reads = NULL;
+    }
+
+    como_profile_apply("__main__", main_code);
+    como_global_frame_verify();
+
+    (void)como_execute(global_frame);
+}
+
+static int como_stream_function_resolved(ComoFrame *fn, Object *visited);
+
+/* 
+ * A name called by a streamed statement is resolved once it is bound in the
+ * global symbol table, and, if it is a function, so is everything it calls
+ */
+static int como_stream_name_resolved(const char *name, Object *visited) {
+    Object *value = mapSearch(global_frame->cf_symtab, name);
+
+    if(value == NULL) {
+        return 0;
+    }
+
+    if(O_TYPE(value) != IS_POINTER) {
+        return 1;
+    }
+
+    if(mapSearch(visited, name) != NULL) {
+        return 1;
+    }
+
+    mapInsert(visited, name, newLong(1L));
+
+    return como_stream_function_resolved((ComoFrame *)O_PTVAL(value), visited);
+}
+
+static int como_stream_function_resolved(ComoFrame *fn, Object *visited) {
+    size_t i;
+
+    if(fn->cf_resolved) {
+        return 1;
+    }
+
+    for(i = 0; i < O_AVAL(fn->code)->size; i++) {
+        ComoOpCode *opcode = (ComoOpCode *)O_PTVAL(O_AVAL(fn->code)->table[i]);
+        if(opcode->op_code == CALL_FUNCTION && 
+                !como_stream_name_resolved(O_SVAL(opcode->operand)->value, 
+                    visited)) {
+            return 0;
+        }
+    }
+
+    /* Names are never unbound, so this can't change for this frame */
+    fn->cf_resolved = 1;
+
+    return 1;
+}
+
+static int como_stream_statement_resolved(ast_node *p, Object *visited) {
+    size_t i;
+
+    if(p == NULL) {
+        return 1;
+    }
+
+    switch(p->type) {
+        case AST_NODE_TYPE_NUMBER:
+        case AST_NODE_TYPE_STRING:
+        case AST_NODE_TYPE_ID:
+        case AST_NODE_TYPE_POSTFIX:
+        case AST_NODE_TYPE_PREFIX:
+            return 1;
+        case AST_NODE_TYPE_STATEMENT_LIST:
+            for(i = 0; i < p->u1.statements_node.count; i++) {
+                if(!como_stream_statement_resolved(
+                        p->u1.statements_node.statement_list[i], visited)) {
+                    return 0;
                 }
-                return;
             }
-            case IPRINT: {
-                Object *value = pop(frame);
-                size_t len = 0;
-                char *sval = objectToStringLength(value, &len);
-                fprintf(stdout, "%s\n", sval);
-                fflush(stdout);
-                free(sval);
-                break;          
+            return 1;
+        case AST_NODE_TYPE_BIN_OP:
+            return como_stream_statement_resolved(p->u1.binary_node.left, 
+                    visited) && 
+                como_stream_statement_resolved(p->u1.binary_node.right, 
+                    visited);
+        case AST_NODE_TYPE_UNARY_OP:
+            return como_stream_statement_resolved(p->u1.unary_node.expr, 
+                    visited);
+        case AST_NODE_TYPE_IF:
+            return como_stream_statement_resolved(p->u1.if_node.condition, 
+                    visited) &&
+                como_stream_statement_resolved(p->u1.if_node.b1, visited) &&
+                como_stream_statement_resolved(p->u1.if_node.b2, visited);
+        case AST_NODE_TYPE_WHILE:
+            return como_stream_statement_resolved(p->u1.while_node.condition, 
+                    visited) &&
+                como_stream_statement_resolved(p->u1.while_node.body, visited);
+        case AST_NODE_TYPE_FOR:
+            return como_stream_statement_resolved(
+                    p->u1.for_node.initialization, visited) &&
+                como_stream_statement_resolved(p->u1.for_node.condition, 
+                    visited) &&
+                como_stream_statement_resolved(
+                    p->u1.for_node.final_expression, visited) &&
+                como_stream_statement_resolved(p->u1.for_node.body, visited);
+        case AST_NODE_TYPE_SWITCH:
+            return como_stream_statement_resolved(p->u1.switch_node.expr, 
+                    visited) &&
+                como_stream_statement_resolved(p->u1.switch_node.cases, 
+                    visited);
+        case AST_NODE_TYPE_CASE:
+            return como_stream_statement_resolved(p->u1.case_node.body, 
+                    visited);
+        case AST_NODE_TYPE_RET:
+            return como_stream_statement_resolved(p->u1.return_node.expr, 
+                    visited);
+        case AST_NODE_TYPE_PRINT:
+            return como_stream_statement_resolved(p->u1.print_node.expr, 
+                    visited);
+        case AST_NODE_TYPE_FUNC_DECL:
+            /* 
+             * Declared while this statement is compiled, but its body may
+             * call something that is still missing
+             */
+            mapInsert(visited, p->u1.function_node.name, newLong(1L));
+            return como_stream_statement_resolved(p->u1.function_node.body, 
+                    visited);
+        case AST_NODE_TYPE_CALL:
+            if(mapSearch(visited, AST_NODE_AS_ID(p->u1.call_node.id)) == NULL 
+                    && !como_stream_name_resolved(
+                        AST_NODE_AS_ID(p->u1.call_node.id), visited)) {
+                return 0;
             }
+            return como_stream_statement_resolved(p->u1.call_node.arguments, 
+                    visited);
+        default:
+            return 1;
+    }
+}
+
+static int como_stream_ready(ast_node *p) {
+    Object *visited = newMap(4);
+    int retval = como_stream_statement_resolved(p, visited);
+    objectDestroy(visited);
+    return retval;
+}
+
+/* 
+ * Compiles and executes a single top statement in a code array of its 
+ * own, after which the instructions and the AST are released
+ */
+static void como_stream_execute(ast_node *p) {
+    Object *code = newArray(4);
+
+    global_frame->code = code;
+    como_compile_statement(p, global_frame);
+    como_global_frame_verify();
+    como_execute(global_frame);
+
+    /* A top level return leaves its value behind */
+    global_frame->cf_sp = 0;
+
+    como_code_free(code);
+    ast_node_free(p);
+}
+
+/* 
+ * Runs queued statements in source order until one of them calls a 
+ * function that hasn't been declared yet, unless more than 
+ * COMO_STREAM_WINDOW are queued. When force is set, everything left is 
+ * run, which is what happens once the whole file was parsed
+ */
+static void como_stream_drain(int force) {
+    size_t i, n = 0;
+    ast_node_statements *pending = &stream_pending->u1.statements_node;
+
+    while(n < pending->count) {
+        if(!force && pending->count - n <= COMO_STREAM_WINDOW
+                && !como_stream_ready(pending->statement_list[n])) {
+            break;
         }
+        como_stream_execute(pending->statement_list[n++]);
+    }
+
+    for(i = n; i < pending->count; i++) {
+        pending->statement_list[i - n] = pending->statement_list[i];
     }
+    pending->count -= n;
 }
 
-static void como_compile_ast(ast_node *p, const char *filename) {
-    Object *main_code = newArray(4);
-    global_frame = create_frame(main_code);
-    global_frame->filename = newString(filename);
-    mapInsertEx(global_frame->cf_symtab, "__FUNCTION__", 
-        newString("__main__"));
+int como_stream_statement(ast_node *p) {
+    if(!como_options.stream) {
+        return 0;
+    }
 
-    (void)como_compile(p, global_frame);
-    
-    arrayPushEx(main_code, newPointer((void *)create_op(HALT, NULL)));
+    /* 
+     * Function declarations don't emit any code, they're bound at compile
+     * time, which hoists them above any pending statement that calls them
+     */
+    if(p->type == AST_NODE_TYPE_FUNC_DECL) {
+        como_compile(p, global_frame);
+        ast_node_free(p);
+    } else {
+        ast_node_statement_list_push(stream_pending, p);
+    }
+
+    como_stream_drain(0);
 
-    (void)como_execute(global_frame, NULL);
+    return 1;
 }
 
 char *get_active_file_name(void) {
@@ -638,6 +2972,81 @@ char *get_active_file_name(void) {
 		return O_SVAL(global_frame->filename)->value;
 }
 
+/* 
+ * Reports the statistics asked for once the bytecode has run, and saves
+ * the --profile, with the forms of code if it is still around
+ */
+static void como_finish_run(Object *code)
+{
+    if(como_options.quicken_stats) {
+        como_quicken_print_stats();
+    }
+
+    if(como_options.jit_stats) {
+        como_jit_print_stats();
+    }
+
+    if(como_options.trace_stats) {
+        como_trace_print_stats();
+    }
+
+    if(como_options.time_passes) {
+        como_print_pass_times();
+    }
+
+    if(como_options.profile != NULL) {
+        como_profile_save(como_options.profile, profile_hash, 
+            global_frame->cf_symtab, code);
+    }
+}
+
+/*
+ * Parses from the file handle itself rather than a copy of the file in 
+ * memory, each top statement is executed by como_stream_statement
+ */
+static int como_ast_create_stream(const char *filename)
+{
+    ast_node* statements;
+    yyscan_t scanner;
+    FILE *fp;
+
+    fp = fopen(filename, "r");
+
+    if(!fp) {
+        printf("file '%s' not found\n", filename);
+        return 1;
+    }
+    
+    if(yylex_init(&scanner)) {
+        como_error_noreturn("yylex_init returned NULL");
+    }
+
+    yyset_in(fp, scanner);
+
+    /* The source isn't kept in memory, so bodies can't be parsed later */
+    como_options.lazy = 0;
+
+    como_init_global_frame(filename);
+    stream_pending = ast_node_create_statement_list(0);
+
+    if(yyparse(&statements, scanner)) {
+        como_error_noreturn("yyparse returned NULL");
+    }
+
+    yylex_destroy(scanner);
+    fclose(fp);
+
+    como_stream_drain(1);
+
+    ast_node_free(stream_pending);
+    ast_node_free(statements);
+
+    /* Each statement's code was freed once it ran */
+    como_finish_run(NULL);
+
+    return 0;
+}
+
 int como_ast_create(const char *filename)
 {
     ast_node* statements;
@@ -645,6 +3054,22 @@ int como_ast_create(const char *filename)
     YY_BUFFER_STATE state;
     char* text;
 
+    if(como_options.profile != NULL) {
+        profile_hash = como_profile_hash_file(filename);
+        como_profile_load(como_options.profile, profile_hash);
+    }
+
+    /* The whole AST is translated, bodies included */
+    if(como_options.emit_c != NULL 
+            || como_options.engine != COMO_ENGINE_BYTECODE) {
+        como_options.stream = 0;
+        como_options.lazy = 0;
+    }
+
+    if(como_options.stream) {
+        return como_ast_create_stream(filename);
+    }
+
     text = file_get_contents(filename);
 
     if(!text) {
@@ -656,6 +3081,12 @@ int como_ast_create(const char *filename)
         como_error_noreturn("yylex_init returned NULL");
     }
 
+    if(como_options.lazy) {
+        lazy_source = text;
+        lazy_functions = newArray(4);
+        como_lazy_begin_parse(0, strlen(text));
+    }
+
     state = yy_scan_string(text, scanner);
 
     if(yyparse(&statements, scanner)) {
@@ -666,7 +3097,33 @@ int como_ast_create(const char *filename)
 
     yylex_destroy(scanner);
 
-    como_compile_ast(statements, filename);
+    if(como_options.emit_c != NULL) {
+        return como_emit_c(statements, filename, como_options.emit_c);
+    }
+
+    if(como_options.engine == COMO_ENGINE_CLOSURE) {
+        return como_closure_run(statements);
+    }
+
+    if(como_options.engine == COMO_ENGINE_REGISTER) {
+        int status = como_reg_run(statements);
+
+        /* The ssa passes are all that run for it */
+        if(como_options.time_passes) {
+            como_print_pass_times();
+        }
+
+        return status;
+    }
+
+    como_init_global_frame(filename);
+    como_compile_ast(statements);
+
+    if(como_options.lazy && como_options.lazy_stats) {
+        como_lazy_print_stats();
+    }
+
+    como_finish_run(global_frame->code);
 
     return 0;
 }
@@ -2,30 +2,227 @@
 #define COMO_COMPILER_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <object.h>
 
-#define COMO_DEFAULT_FRAME_STACKSIZE   2048U
+#include "ast.h"
+
+/* O_FLG of a function pointer whose body hasn't been compiled yet */
+#define COMO_LAZY_FUNCTION (1 << 1)
+
+/* 
+ * O_FLG of a long made by INPLACE_ADD and the like, or FOR_RANGE, and
+ * bound to a name, which nothing else refers to yet. They update it in
+ * place from then on, until STORE_NAME, a call or a return hands it on.
+ * Every other value is shared and never changed, see como_runtime.h
+ */
+#define COMO_OWNED (1 << 2)
+
+/* 
+ * O_FLG of a value once STORE_NAME or a call has bound it to a name. A 
+ * constant without it is freed with the code of a --stream statement, see
+ * como_code_free
+ */
+#define COMO_BOUND (1 << 3)
+
+/* Returned for each instruction run, see como_execute_op */
+#define COMO_OP_NEXT   0
+#define COMO_OP_RETURN 1
 
 typedef struct ComoOpCode {
     unsigned char op_code;
+    unsigned char op_misses;            /* times a quickened form missed */
+    unsigned short op_hits;             /* times a backward JMP was taken */
     Object       *operand;
+    struct ComoTrace *op_trace;         /* of the loop a backward JMP closes */
 } ComoOpCode;
 
 typedef struct ComoFrame {
     size_t     cf_sp;                      /* stack pointer into cf_stack */
-    size_t     cf_stack_size;              /* stack size, num of used entries */
-    Object     *cf_stack[(size_t)COMO_DEFAULT_FRAME_STACKSIZE];  /* stack */
+    size_t     cf_stack_size;              /* max depth, from como_verify_code */
+    Object     **cf_stack;                 /* stack, of cf_stack_size entries */
     Object     *cf_symtab;               /* Map, symbol table */
     Object     *code;
     struct ComoFrame *next;
     Object *namedparameters;
     Object *filename;
+    int        cf_resolved;              /* every callee is defined, see --stream */
+    long       cf_calls;                 /* times called, see --profile */
+    long       cf_depth;                 /* activations currently running */
+    void       (*cf_jit)(struct ComoFrame *); /* native code, see como_jit.c */
 } ComoFrame;
 
+/* 
+ * Bound in place of a ComoFrame for functions declared with --lazy, the 
+ * body is parsed and compiled on the first CALL_FUNCTION
+ */
+typedef struct ComoLazyFunction {
+    Object *name;
+    Object *parameters;
+    Object *filename;
+    size_t  body_offset;                 /* of the '{' in the source */
+    size_t  body_length;
+    int     materialized;
+} ComoLazyFunction;
+
+/* The Long holding the pc a JMP, JZ or FOR_RANGE jumps to */
+#define COMO_JUMP_TARGET(opcode) \
+    ((opcode)->op_code == FOR_RANGE \
+        ? O_AVAL((opcode)->operand)->table[FOR_RANGE_TARGET] \
+        : (opcode)->operand)
+
+/* 
+ * Command line switches, filled in by main() before como_ast_create
+ * is called
+ */
+typedef struct ComoOptions {
+    int stream;                /* --stream, run each top statement once reduced */
+    int lazy;                  /* --lazy, compile function bodies on first call */
+    int lazy_stats;            /* --lazy-stats */
+    int jobs;                  /* --jobs N, threads compiling function bodies */
+    int no_quicken;            /* --no-quicken, never rewrite instructions */
+    int quicken_stats;         /* --quicken-stats */
+    const char *profile;       /* --profile FILE, type feedback across runs */
+    int no_jit;                /* --no-jit, never compile to native code */
+    long jit_threshold;        /* --jit-threshold N, calls before compiling */
+    int jit_stats;             /* --jit-stats */
+    int no_trace;              /* --no-trace, never record loop traces */
+    int trace_stats;           /* --trace-stats */
+    const char *emit_c;        /* --emit-c FILE, translate to C instead */
+    int engine;                /* --engine NAME, a ComoEngine */
+    int register_stats;        /* --register-stats */
+    int register_dump;         /* --register-dump */
+    int ssa;                   /* --ssa, compile register code through SSA */
+    int ssa_dump;              /* --ssa-dump */
+    int dump_types;            /* --dump-types, annotate --register-dump */
+    long inline_limit;         /* --inline-limit N, instructions inlined */
+    int inline_report;         /* --inline-report */
+    int opt_level;             /* -O0, -O1 or -O2, passes that run */
+    int time_passes;           /* --time-passes */
+} ComoOptions;
+
+/* What runs the program, the bytecode VM unless --engine says otherwise */
+typedef enum {
+    COMO_ENGINE_BYTECODE,
+    COMO_ENGINE_CLOSURE,
+    COMO_ENGINE_REGISTER,
+} ComoEngine;
+
 typedef void(*como_vm_executor_t)(ComoFrame *, ComoFrame *);
 
+#define COMO_DEFAULT_JIT_THRESHOLD 100
+#define COMO_DEFAULT_INLINE_LIMIT  16
+#define COMO_DEFAULT_OPT_LEVEL     2
+
+/* Entry point of a function compiled by como_jit_compile */
+typedef void (*como_jit_code_t)(ComoFrame *);
+
+/* 
+ * Runs one instruction for JIT compiled code, returns COMO_OP_NEXT or 
+ * COMO_OP_RETURN, or for JZ, 1 if the jump is taken
+ */
+typedef int (*como_jit_helper_t)(ComoFrame *, ComoOpCode *);
+
+extern ComoOptions como_options;
+
 extern int como_ast_create(const char *filename);
 
+/* 
+ * Called by the parser for every reduced top_statement, returns 1 if the 
+ * statement was consumed and must not be added to the statement list
+ */
+extern int como_stream_statement(ast_node *statement);
+
+/* 
+ * Called by the parser for every function declaration, with --lazy this
+ * drops the body after recording where it is in the source
+ */
+extern void como_lazy_function(ast_node *function, int first_line, 
+    int first_column, int last_line, int last_column);
+
+/* 
+ * The operand of a SWITCH over the CASE nodes in cases, for como_rt_switch.
+ * The targets are left for the caller to set
+ */
+extern Object *como_switch_table(ast_node *cases);
+
+/* 
+ * Defined in como_verify.c, returns the maximum operand stack depth of the
+ * code, exits if the stack isn't balanced on every path through it
+ */
+extern size_t como_verify_code(Object *code, const char *name);
+
+/* 
+ * Defined in como_dead_code.c, removes what code can never run, and stores
+ * to names that neither code nor anything in read reads, unless read is
+ * NULL. Returns how many instructions are gone
+ */
+extern size_t como_dead_code(Object *code, Object *read);
+
+/*
+ * The optimization passes of como_compiler_ex.c, in the order of passes[].
+ * The lowerings are chosen while the stack bytecode is compiled, the ssa
+ * ones run on the --ssa form of the register engine
+ */
+typedef enum {
+    COMO_PASS_LIVE_FUNCTIONS,
+    COMO_PASS_DEAD_CODE,
+    COMO_PASS_INPLACE,
+    COMO_PASS_FOR_RANGE,
+    COMO_PASS_SSA_CSE,
+    COMO_PASS_SSA_EVALUATE,
+    COMO_PASS_SSA_INLINE,
+    COMO_PASS_SSA_LICM,
+} ComoPassId;
+
+/*
+ * Whether the pass runs at the -O level, and, once it has, records the
+ * run for --time-passes with the instructions it added, or removed
+ */
+extern int como_pass_enabled(ComoPassId id);
+extern uint64_t como_pass_clock(void);
+extern void como_pass_record(ComoPassId id, uint64_t start, long delta);
+
+/* 
+ * Defined in como_profile.c. A profile is loaded before parsing, applied to
+ * every code array once it is compiled, before it is verified, and saved
+ * at exit
+ */
+extern uint64_t como_profile_hash_file(const char *filename);
+extern void como_profile_load(const char *path, uint64_t hash);
+extern long como_profile_calls(const char *name);
+extern void como_profile_apply(const char *name, Object *code);
+extern void como_profile_save(const char *path, uint64_t hash, 
+    Object *symtab, Object *main_code);
+
+/* 
+ * The helper JIT compiled code calls for an instruction, for JZ and 
+ * SWITCH, and to read and bind the names it loads and stores itself
+ */
+extern como_jit_helper_t como_jit_helper(unsigned char op_code);
+extern int como_jit_branch(ComoFrame *frame, ComoOpCode *opcode);
+extern int como_jit_switch(ComoFrame *frame, ComoOpCode *opcode);
+extern Object *como_jit_load_name(ComoFrame *frame, const char *name);
+extern void como_jit_store_name(ComoFrame *frame, const char *name, 
+    Object *value);
+
+/* 
+ * Defined in como_jit.c, returns NULL if the function can't be compiled
+ * on this platform
+ */
+extern como_jit_code_t como_jit_compile(ComoFrame *frame, const char *name);
+extern void como_jit_print_stats(void);
+
+/* 
+ * Defined in como_emit_c.c, writes program as a C translation unit to 
+ * path, "-" for stdout
+ */
+extern int como_emit_c(ast_node *program, const char *filename, 
+    const char *path);
+
+/* Defined in como_closure.c, compiles program into closures and runs it */
+extern int como_closure_run(ast_node *program);
+
 extern como_vm_executor_t *ex;
 
 #endif
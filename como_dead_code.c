@@ -0,0 +1,320 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "comodebug.h"
+#include "como_opcode.h"
+#include "como_compiler_ex.h"
+
+#define CODE_AT(code, i) ((ComoOpCode *)O_PTVAL(O_AVAL((code))->table[(i)]))
+#define TARGET(opcode) O_LVAL(COMO_JUMP_TARGET((opcode)))
+
+/*
+ * Dead code elimination, run on a code array once it is compiled and
+ * before it is verified. Repeated until nothing changes:
+ *
+ *   - a STORE_NAME of a name nothing reads becomes POP_TOP
+ *   - LOAD_CONST followed by POP_TOP is removed
+ *   - JZ on a constant long is removed, or becomes JMP
+ *   - a JMP to the very next LABEL is removed
+ *   - whatever no path from the first instruction reaches is removed, so
+ *     is a LABEL no jump or SWITCH targets
+ *
+ * The operands of removed instructions are left alone, a jump target may
+ * be shared by two jumps and a constant bound to a name.
+ */
+
+static int is_jump(ComoOpCode *opcode)
+{
+	return opcode->op_code == JMP || opcode->op_code == JZ
+		|| opcode->op_code == FOR_RANGE;
+}
+
+/* The Longs an instruction may jump to, a SWITCH has one per case */
+static Object **jump_targets(ComoOpCode *opcode, size_t *count)
+{
+	if(opcode->op_code == SWITCH) {
+		Array *targets = O_AVAL(O_AVAL(opcode->operand)->table[SWITCH_TARGETS]);
+		*count = targets->size;
+		return targets->table;
+	}
+
+	if(opcode->op_code == FOR_RANGE) {
+		*count = 1;
+		return &O_AVAL(opcode->operand)->table[FOR_RANGE_TARGET];
+	}
+
+	if(is_jump(opcode)) {
+		*count = 1;
+		return &opcode->operand;
+	}
+
+	*count = 0;
+	return NULL;
+}
+
+static void mark_reachable(Object *code, unsigned char *reachable)
+{
+	size_t size = O_AVAL(code)->size;
+	size_t *worklist = malloc(sizeof(size_t) * (size + 1));
+	size_t top = 0;
+
+	if(size == 0) {
+		free(worklist);
+		return;
+	}
+
+	reachable[0] = 1;
+	worklist[top++] = 0;
+
+	while(top > 0) {
+		size_t pc = worklist[--top];
+		ComoOpCode *opcode = CODE_AT(code, pc);
+		size_t count, i;
+		Object **targets = jump_targets(opcode, &count);
+
+		for(i = 0; i <= count; i++) {
+			size_t next;
+
+			if(i < count) {
+				next = (size_t)O_LVAL(targets[i]);
+			} else if(opcode->op_code != JMP && opcode->op_code != IRETURN
+					&& opcode->op_code != SWITCH) {
+				next = pc + 1;
+			} else {
+				break;
+			}
+
+			if(next < size && !reachable[next]) {
+				reachable[next] = 1;
+				worklist[top++] = next;
+			}
+		}
+	}
+
+	free(worklist);
+}
+
+/* 
+ * Every name LOAD_NAME, POSTFIX_INC, POSTFIX_DEC, FOR_RANGE or one of the 
+ * INPLACE_ and PREFIX_ instructions looks up
+ */
+static Object *find_reads(Object *code)
+{
+	Object *reads = newMap(8);
+	size_t i;
+
+	for(i = 0; i < O_AVAL(code)->size; i++) {
+		ComoOpCode *opcode = CODE_AT(code, i);
+		if(opcode->op_code == LOAD_NAME || opcode->op_code == POSTFIX_INC
+				|| opcode->op_code == POSTFIX_DEC 
+				|| (opcode->op_code >= INPLACE_ADD 
+					&& opcode->op_code <= PREFIX_DEC)) {
+			mapInsertEx(reads, O_SVAL(opcode->operand)->value, newLong(1L));
+		} else if(opcode->op_code == FOR_RANGE) {
+			Object **loop = O_AVAL(opcode->operand)->table;
+			mapInsertEx(reads, O_SVAL(loop[FOR_RANGE_NAME])->value,
+				newLong(1L));
+			if(O_TYPE(loop[FOR_RANGE_BOUND]) == IS_STRING) {
+				mapInsertEx(reads, O_SVAL(loop[FOR_RANGE_BOUND])->value,
+					newLong(1L));
+			}
+		}
+	}
+
+	return reads;
+}
+
+/* Marks what can go, returns how many instructions that is */
+static size_t find_dead(Object *code, Object *read, unsigned char *removed)
+{
+	size_t size = O_AVAL(code)->size;
+	unsigned char *reachable = calloc(size + 1, 1);
+	unsigned char *targeted = calloc(size + 1, 1);
+	size_t i, count = 0;
+
+	if(read != NULL) {
+		Object *reads = find_reads(code);
+		for(i = 0; i < size; i++) {
+			ComoOpCode *opcode = CODE_AT(code, i);
+			const char *name;
+
+			if(opcode->op_code != STORE_NAME) {
+				continue;
+			}
+
+			name = O_SVAL(opcode->operand)->value;
+			if(mapSearch(reads, name) == NULL && mapSearch(read, name) == NULL) {
+				objectDestroy(opcode->operand);
+				opcode->op_code = POP_TOP;
+				opcode->operand = NULL;
+			}
+		}
+		objectDestroy(reads);
+	}
+
+	for(i = 0; i + 1 < size; i++) {
+		ComoOpCode *opcode = CODE_AT(code, i), *next = CODE_AT(code, i + 1);
+
+		if(opcode->op_code != LOAD_CONST) {
+			continue;
+		}
+
+		if(next->op_code == POP_TOP) {
+			removed[i] = removed[i + 1] = 1;
+		} else if(next->op_code == JZ && O_TYPE(opcode->operand) == IS_LONG) {
+			removed[i] = 1;
+			if(O_LVAL(opcode->operand) != 0) {
+				removed[i + 1] = 1;
+			} else {
+				next->op_code = JMP;
+			}
+		}
+	}
+
+	/* Past the jumps just removed, the rest is a plain walk */
+	for(i = 0; i < size; i++) {
+		ComoOpCode *opcode = CODE_AT(code, i);
+		if(removed[i] && is_jump(opcode)) {
+			opcode->op_code = NOP;
+		}
+	}
+
+	mark_reachable(code, reachable);
+
+	for(i = 0; i < size; i++) {
+		removed[i] |= !reachable[i];
+	}
+
+	/* Jumping over nothing but LABELs */
+	for(i = 0; i < size; i++) {
+		ComoOpCode *opcode = CODE_AT(code, i);
+		size_t target, pc;
+
+		if(removed[i] || opcode->op_code != JMP) {
+			continue;
+		}
+
+		target = (size_t)TARGET(opcode);
+		for(pc = i + 1; pc < target && (removed[pc]
+				|| CODE_AT(code, pc)->op_code == LABEL); pc++)
+			;
+		if(target > i && pc == target) {
+			removed[i] = 1;
+		}
+	}
+
+	for(i = 0; i < size; i++) {
+		size_t count, j;
+		Object **targets = jump_targets(CODE_AT(code, i), &count);
+		for(j = 0; j < count && !removed[i]; j++) {
+			targeted[O_LVAL(targets[j])] = 1;
+		}
+	}
+
+	for(i = 0; i < size; i++) {
+		if(CODE_AT(code, i)->op_code == LABEL && !targeted[i]) {
+			removed[i] = 1;
+		}
+		count += removed[i];
+	}
+
+	free(reachable);
+	free(targeted);
+
+	return count;
+}
+
+static void compact(Object *code, unsigned char *removed)
+{
+	Array *table = O_AVAL(code);
+	size_t size = table->size;
+	size_t *moved = malloc(sizeof(size_t) * (size + 1));
+	size_t i, j, count = 0, used = 0, capacity = size + 1;
+	Object **longs = malloc(sizeof(Object *) * capacity);
+	long *targets = malloc(sizeof(long) * capacity);
+
+	for(i = 0; i < size; i++) {
+		moved[i] = count;
+		count += !removed[i];
+	}
+
+	/* Two jumps may share their operand, all are read before any is set */
+	for(i = 0; i < size; i++) {
+		ComoOpCode *opcode = CODE_AT(code, i);
+		Object **jumps = &opcode->operand;
+		size_t jump_count = opcode->op_code == LABEL;
+
+		if(removed[i]) {
+			continue;
+		}
+
+		if(jump_count == 0) {
+			jumps = jump_targets(opcode, &jump_count);
+		}
+
+		for(j = 0; j < jump_count; j++) {
+			if(used == capacity) {
+				capacity *= 2;
+				longs = realloc(longs, sizeof(Object *) * capacity);
+				targets = realloc(targets, sizeof(long) * capacity);
+			}
+			longs[used] = jumps[j];
+			targets[used++] = (long)moved[O_LVAL(jumps[j])];
+		}
+	}
+
+	for(i = 0; i < used; i++) {
+		O_LVAL(longs[i]) = targets[i];
+	}
+
+	for(i = 0, count = 0; i < size; i++) {
+		if(removed[i]) {
+			free(CODE_AT(code, i));
+			objectDestroy(table->table[i]);
+		} else {
+			table->table[count++] = table->table[i];
+		}
+	}
+
+	table->size = count;
+
+	free(moved);
+	free(longs);
+	free(targets);
+}
+
+size_t como_dead_code(Object *code, Object *read)
+{
+	size_t total = 0, count;
+
+	do {
+		unsigned char *removed = calloc(O_AVAL(code)->size + 1, 1);
+		count = find_dead(code, read, removed);
+		if(count > 0) {
+			compact(code, removed);
+		}
+		free(removed);
+		total += count;
+	} while(count > 0);
+
+	return total;
+}
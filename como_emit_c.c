@@ -0,0 +1,703 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <object.h>
+
+#include "ast.h"
+#include "comodebug.h"
+#include "como_compiler_ex.h"
+
+/*
+ * The --emit-c backend. The AST como_compile walks is translated into a C
+ * program that calls como_runtime.c for every operation, so it behaves
+ * exactly like the bytecode would.
+ *
+ * Names are resolved while translating. A variable is a static Object *
+ * per name: g_<name> for the top level, f<n>_<name> for the names
+ * function n assigns, or receives as parameters. Like the symbol table
+ * of a ComoFrame, these outlive a call. A name read in a function is its
+ * own slot if set, otherwise the top level one. Functions are bound to
+ * their names before the top level code runs, in the order como_compile
+ * binds them.
+ */
+
+typedef struct ComoEmitter {
+	FILE   *out;               /* function bodies and main() */
+	Object *globals;           /* Map, names with a top level slot */
+	Object *constants;         /* Array, the value of each k[] */
+	Object *strings;           /* Map, string literal to its k[] index */
+	Object *functions;         /* Array of FUNC_DECL nodes, in binding order */
+	Object *function_locals;   /* Array, the locals Map of each function */
+	Object *locals;            /* Map, slots of the function being emitted */
+	size_t  function;          /* index of the function being emitted */
+	size_t  temp;
+	int     depth;
+} ComoEmitter;
+
+static void emit_line(ComoEmitter *e, const char *format, ...)
+{
+	va_list args;
+	int i;
+
+	for(i = 0; i < e->depth; i++) {
+		fputc('\t', e->out);
+	}
+
+	va_start(args, format);
+	vfprintf(e->out, format, args);
+	va_end(args);
+
+	fputc('\n', e->out);
+}
+
+static void emit_c_string(FILE *out, const char *value)
+{
+	fputc('"', out);
+
+	for(; *value; value++) {
+		unsigned char c = (unsigned char)*value;
+		switch(c) {
+			case '"':  fputs("\\\"", out); break;
+			case '\\': fputs("\\\\", out); break;
+			case '\n': fputs("\\n", out);  break;
+			case '\t': fputs("\\t", out);  break;
+			default:
+				if(c < 0x20 || c >= 0x7f) {
+					fprintf(out, "\\%03o", c);
+				} else {
+					fputc(c, out);
+				}
+			break;
+		}
+	}
+
+	fputc('"', out);
+}
+
+static void declare(Object *names, const char *name)
+{
+	if(mapSearch(names, name) == NULL) {
+		mapInsertEx(names, name, newLong(1L));
+	}
+}
+
+/*
+ * Finds the slots of a scope, and every function declared in it. Nested
+ * functions are bound before the function declaring them, like
+ * como_compile_function does
+ */
+static void collect(ComoEmitter *e, ast_node *p, Object *names)
+{
+	size_t i;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				collect(e, p->u1.statements_node.statement_list[i], names);
+			}
+		break;
+		case AST_NODE_TYPE_BIN_OP:
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				declare(names, AST_NODE_AS_ID(p->u1.binary_node.left));
+			} else {
+				collect(e, p->u1.binary_node.left, names);
+			}
+			collect(e, p->u1.binary_node.right, names);
+		break;
+		case AST_NODE_TYPE_POSTFIX:
+			declare(names, AST_NODE_AS_ID(p->u1.postfix_node.expr));
+		break;
+		case AST_NODE_TYPE_PREFIX:
+			collect(e, p->u1.prefix_node.expr, names);
+		break;
+		case AST_NODE_TYPE_UNARY_OP:
+			collect(e, p->u1.unary_node.expr, names);
+		break;
+		case AST_NODE_TYPE_CALL:
+			collect(e, p->u1.call_node.arguments, names);
+		break;
+		case AST_NODE_TYPE_RET:
+			collect(e, p->u1.return_node.expr, names);
+		break;
+		case AST_NODE_TYPE_PRINT:
+			collect(e, p->u1.print_node.expr, names);
+		break;
+		case AST_NODE_TYPE_IF:
+			collect(e, p->u1.if_node.condition, names);
+			collect(e, p->u1.if_node.b1, names);
+			collect(e, p->u1.if_node.b2, names);
+		break;
+		case AST_NODE_TYPE_WHILE:
+			collect(e, p->u1.while_node.condition, names);
+			collect(e, p->u1.while_node.body, names);
+		break;
+		case AST_NODE_TYPE_FOR:
+			collect(e, p->u1.for_node.initialization, names);
+			collect(e, p->u1.for_node.condition, names);
+			collect(e, p->u1.for_node.final_expression, names);
+			collect(e, p->u1.for_node.body, names);
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			collect(e, p->u1.switch_node.expr, names);
+			collect(e, p->u1.switch_node.cases, names);
+		break;
+		case AST_NODE_TYPE_CASE:
+			collect(e, p->u1.case_node.body, names);
+		break;
+		case AST_NODE_TYPE_FUNC_DECL: {
+			Object *locals = newMap(8);
+			ast_node *parameters = p->u1.function_node.parameter_list;
+
+			for(i = 0; i < parameters->u1.statements_node.count; i++) {
+				declare(locals, AST_NODE_AS_ID(
+					parameters->u1.statements_node.statement_list[i]));
+			}
+			declare(locals, "__FUNCTION__");
+
+			collect(e, p->u1.function_node.body, locals);
+
+			arrayPushEx(e->functions, newPointer((void *)p));
+			arrayPushEx(e->function_locals, locals);
+			declare(e->globals, p->u1.function_node.name);
+		}
+		break;
+		default:
+		break;
+	}
+}
+
+static size_t new_temp(ComoEmitter *e)
+{
+	return e->temp++;
+}
+
+static size_t add_constant(ComoEmitter *e, Object *value)
+{
+	arrayPushEx(e->constants, value);
+	return O_AVAL(e->constants)->size - 1;
+}
+
+/* String literals are interned, like como_compile does */
+static size_t add_string(ComoEmitter *e, const char *value)
+{
+	Object *index = mapSearch(e->strings, value);
+
+	if(index == NULL) {
+		index = newLong((long)add_constant(e, newString(value)));
+		mapInsertEx(e->strings, value, index);
+	}
+
+	return (size_t)O_LVAL(index);
+}
+
+/* The C lvalue a name is stored to */
+static void emit_slot(ComoEmitter *e, char *buffer, size_t size,
+	const char *name)
+{
+	if(e->locals != NULL) {
+		snprintf(buffer, size, "f%zu_%s", e->function, name);
+	} else {
+		snprintf(buffer, size, "g_%s", name);
+	}
+}
+
+/* LOAD_NAME, the function's own slot and then the top level one */
+static size_t emit_load(ComoEmitter *e, const char *name)
+{
+	size_t t = new_temp(e);
+	int local = e->locals != NULL && mapSearch(e->locals, name) != NULL;
+	int global = mapSearch(e->globals, name) != NULL;
+
+	if(local && global) {
+		emit_line(e, "Object *t%zu = f%zu_%s != NULL ? f%zu_%s : "
+			"g_%s != NULL ? g_%s : como_rt_undefined(\"%s\");", t,
+			e->function, name, e->function, name, name, name, name);
+	} else if(local) {
+		emit_line(e, "Object *t%zu = f%zu_%s != NULL ? f%zu_%s : "
+			"como_rt_undefined(\"%s\");", t, e->function, name, e->function,
+			name, name);
+	} else if(global) {
+		emit_line(e, "Object *t%zu = g_%s != NULL ? g_%s : "
+			"como_rt_undefined(\"%s\");", t, name, name, name);
+	} else {
+		emit_line(e, "Object *t%zu = como_rt_undefined(\"%s\");", t, name);
+	}
+
+	return t;
+}
+
+static const char *binary_function(ast_binary_op_type type)
+{
+	switch(type) {
+		case AST_BINARY_OP_ADD:   return "como_rt_add";
+		case AST_BINARY_OP_MINUS: return "como_rt_minus";
+		case AST_BINARY_OP_TIMES: return "como_rt_times";
+		case AST_BINARY_OP_DIV:   return "como_rt_div";
+		case AST_BINARY_OP_REM:   return "como_rt_rem";
+		case AST_BINARY_OP_LT:    return "como_rt_is_less_than";
+		case AST_BINARY_OP_LTE:   return "como_rt_is_less_than_or_equal";
+		case AST_BINARY_OP_GT:    return "como_rt_is_greater_than";
+		case AST_BINARY_OP_GTE:   return "como_rt_is_greater_than_or_equal";
+		case AST_BINARY_OP_CMP:   return "como_rt_is_equal";
+		case AST_BINARY_OP_NEQ:   return "como_rt_is_not_equal";
+		default:                  return NULL;
+	}
+}
+
+/*
+ * Emits the evaluation of an expression into a fresh temporary, operands
+ * are evaluated left to right as on the VM stack. Returns the temporary
+ */
+static size_t emit_expression(ComoEmitter *e, ast_node *p)
+{
+	size_t t, left, right, i;
+	char slot[512];
+
+	switch(p->type) {
+		case AST_NODE_TYPE_NUMBER:
+			t = new_temp(e);
+			emit_line(e, "Object *t%zu = k[%zu];", t,
+				add_constant(e, newLong(p->u1.number_value)));
+		return t;
+		case AST_NODE_TYPE_STRING:
+			t = new_temp(e);
+			emit_line(e, "Object *t%zu = k[%zu];", t,
+				add_string(e, p->u1.string_value.value));
+		return t;
+		case AST_NODE_TYPE_ID:
+			return emit_load(e, AST_NODE_AS_ID(p));
+		case AST_NODE_TYPE_UNARY_OP:
+			left = emit_expression(e, p->u1.unary_node.expr);
+			t = new_temp(e);
+			emit_line(e, "Object *t%zu = como_rt_unary_minus(t%zu);", t, left);
+		return t;
+		case AST_NODE_TYPE_POSTFIX: {
+			const char *name = AST_NODE_AS_ID(p->u1.postfix_node.expr);
+			t = new_temp(e);
+			emit_slot(e, slot, sizeof(slot), name);
+			emit_line(e, "Object *t%zu = %s;", t, slot);
+			emit_line(e, "%s = como_rt_step(t%zu, %d, \"%s\");", slot, t,
+				p->u1.postfix_node.type == AST_POSTFIX_OP_INC ? 1 : -1, name);
+			return t;
+		}
+		case AST_NODE_TYPE_PREFIX:
+			/* The assignment it stands for, whose value is the name's */
+			return emit_expression(e, p->u1.prefix_node.expr);
+		case AST_NODE_TYPE_BIN_OP:
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				t = emit_expression(e, p->u1.binary_node.right);
+				emit_slot(e, slot, sizeof(slot),
+					AST_NODE_AS_ID(p->u1.binary_node.left));
+				emit_line(e, "%s = t%zu;", slot, t);
+				return t;
+			}
+			left = emit_expression(e, p->u1.binary_node.left);
+			right = emit_expression(e, p->u1.binary_node.right);
+			t = new_temp(e);
+			emit_line(e, "Object *t%zu = %s(t%zu, t%zu);", t,
+				binary_function(p->u1.binary_node.type), left, right);
+		return t;
+		case AST_NODE_TYPE_CALL: {
+			ast_node_statements *arguments =
+				&p->u1.call_node.arguments->u1.statements_node;
+			const char *name = AST_NODE_AS_ID(p->u1.call_node.id);
+			size_t args = new_temp(e);
+			size_t *values = malloc(sizeof(size_t) * (arguments->count + 1));
+			size_t callee;
+
+			for(i = 0; i < arguments->count; i++) {
+				values[i] = emit_expression(e, arguments->statement_list[i]);
+			}
+
+			callee = emit_load(e, name);
+
+			if(arguments->count > 0) {
+				emit_line(e, "Object *t%zu[%zu];", args, arguments->count);
+				for(i = 0; i < arguments->count; i++) {
+					emit_line(e, "t%zu[%zu] = t%zu;", args, i, values[i]);
+				}
+			}
+
+			t = new_temp(e);
+			if(arguments->count > 0) {
+				emit_line(e, "Object *t%zu = como_rt_call(t%zu, \"%s\", %zu, t%zu);",
+					t, callee, name, arguments->count, args);
+			} else {
+				emit_line(e, "Object *t%zu = como_rt_call(t%zu, \"%s\", 0, NULL);",
+					t, callee, name);
+			}
+
+			free(values);
+			return t;
+		}
+		default:
+			como_error_noreturn("--emit-c: node type %d isn't an expression",
+				p->type);
+	}
+}
+
+static void emit_statement(ComoEmitter *e, ast_node *p);
+
+static void emit_block(ComoEmitter *e, ast_node *p)
+{
+	e->depth++;
+	if(p != NULL) {
+		emit_statement(e, p);
+	}
+	e->depth--;
+}
+
+/*
+ * Finds the case to run first, a C switch on a long value so the compiler
+ * builds the jump table, string labels compared in turn. Then switches on
+ * the index of the case, -1 running the default
+ */
+static void emit_switch(ComoEmitter *e, ast_node *p)
+{
+	ast_node_statements *cases = &p->u1.switch_node.cases->u1.statements_node;
+	size_t value, match, i, j;
+	int pass, compared = 0;
+
+	emit_line(e, "{");
+	e->depth++;
+	value = emit_expression(e, p->u1.switch_node.expr);
+	match = new_temp(e);
+	emit_line(e, "long t%zu = -1;", match);
+
+	for(pass = 0; pass < 2; pass++) {
+		int emitted = 0;
+
+		for(i = 0; i < cases->count; i++) {
+			ast_node *labels = cases->statement_list[i]->u1.case_node.labels;
+			for(j = 0; labels != NULL && j < labels->u1.statements_node.count; 
+					j++) {
+				ast_node *label = labels->u1.statements_node.statement_list[j];
+				if((label->type == AST_NODE_TYPE_NUMBER) != (pass == 0)) {
+					continue;
+				}
+				if(!emitted) {
+					emit_line(e, pass == 0 ? "if(O_TYPE(t%zu) == IS_LONG) {" 
+						: "if(O_TYPE(t%zu) == IS_STRING) {", value);
+					e->depth++;
+					if(pass == 0) {
+						emit_line(e, "switch(O_LVAL(t%zu)) {", value);
+					}
+					emitted = 1;
+				}
+				if(pass == 0) {
+					emit_line(e, "case %ldL: t%zu = %zu; break;", 
+						label->u1.number_value, match, i);
+				} else {
+					emit_line(e, "if(t%zu == -1 && strcmp(O_SVAL(t%zu)->value, "
+						"O_SVAL(k[%zu])->value) == 0) t%zu = %zu;", match, value,
+						add_string(e, label->u1.string_value.value), match, i);
+				}
+			}
+		}
+
+		if(emitted) {
+			if(pass == 0) {
+				emit_line(e, "}");
+			}
+			e->depth--;
+			emit_line(e, "}");
+		}
+		compared |= emitted;
+	}
+
+	if(!compared) {
+		emit_line(e, "(void)t%zu;", value);
+	}
+
+	emit_line(e, "switch(t%zu) {", match);
+	for(i = 0; i < cases->count; i++) {
+		ast_node *node = cases->statement_list[i];
+		if(node->u1.case_node.labels == NULL) {
+			emit_line(e, "default:");
+		} else {
+			emit_line(e, "case %zu:", i);
+		}
+		emit_block(e, node->u1.case_node.body);
+		e->depth++;
+		emit_line(e, "break;");
+		e->depth--;
+	}
+	emit_line(e, "}");
+
+	e->depth--;
+	emit_line(e, "}");
+}
+
+static void emit_statement(ComoEmitter *e, ast_node *p)
+{
+	size_t i, t;
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				ast_node *stmt = p->u1.statements_node.statement_list[i];
+				if(stmt != NULL) {
+					emit_statement(e, stmt);
+				}
+			}
+		break;
+		/* Bound before the top level code runs, see como_emit_c */
+		case AST_NODE_TYPE_FUNC_DECL:
+		break;
+		case AST_NODE_TYPE_PRINT:
+			emit_line(e, "{");
+			e->depth++;
+			t = emit_expression(e, p->u1.print_node.expr);
+			emit_line(e, "como_rt_print(t%zu);", t);
+			e->depth--;
+			emit_line(e, "}");
+		break;
+		case AST_NODE_TYPE_RET:
+			emit_line(e, "{");
+			e->depth++;
+			if(p->u1.return_node.expr != NULL) {
+				t = emit_expression(e, p->u1.return_node.expr);
+				emit_line(e, e->locals != NULL ? "return t%zu;"
+					: "(void)t%zu; return 0;", t);
+			} else {
+				emit_line(e, e->locals != NULL ? "return newLong(0L);"
+					: "return 0;");
+			}
+			e->depth--;
+			emit_line(e, "}");
+		break;
+		case AST_NODE_TYPE_IF:
+			emit_line(e, "{");
+			e->depth++;
+			t = emit_expression(e, p->u1.if_node.condition);
+			emit_line(e, "if(!como_rt_is_false(t%zu)) {", t);
+			emit_block(e, p->u1.if_node.b1);
+			if(p->u1.if_node.b2 != NULL) {
+				emit_line(e, "} else {");
+				emit_block(e, p->u1.if_node.b2);
+			}
+			emit_line(e, "}");
+			e->depth--;
+			emit_line(e, "}");
+		break;
+		case AST_NODE_TYPE_WHILE:
+			emit_line(e, "for(;;) {");
+			e->depth++;
+			t = emit_expression(e, p->u1.while_node.condition);
+			emit_line(e, "if(como_rt_is_false(t%zu)) break;", t);
+			emit_statement(e, p->u1.while_node.body);
+			e->depth--;
+			emit_line(e, "}");
+		break;
+		case AST_NODE_TYPE_FOR:
+			emit_line(e, "{");
+			e->depth++;
+			emit_statement(e, p->u1.for_node.initialization);
+			emit_line(e, "for(;;) {");
+			e->depth++;
+			t = emit_expression(e, p->u1.for_node.condition);
+			emit_line(e, "if(como_rt_is_false(t%zu)) break;", t);
+			emit_statement(e, p->u1.for_node.body);
+			emit_statement(e, p->u1.for_node.final_expression);
+			e->depth--;
+			emit_line(e, "}");
+			e->depth--;
+			emit_line(e, "}");
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			emit_switch(e, p);
+		break;
+		default:
+			emit_line(e, "{");
+			e->depth++;
+			t = emit_expression(e, p);
+			emit_line(e, "(void)t%zu;", t);
+			e->depth--;
+			emit_line(e, "}");
+		break;
+	}
+}
+
+static void emit_function(ComoEmitter *e, size_t index)
+{
+	ast_node *p = (ast_node *)O_PTVAL(O_AVAL(e->functions)->table[index]);
+	ast_node_statements *parameters =
+		&p->u1.function_node.parameter_list->u1.statements_node;
+	size_t i;
+
+	e->function = index;
+	e->locals = O_AVAL(e->function_locals)->table[index];
+	e->temp = 0;
+
+	emit_line(e, "/* %s */", p->u1.function_node.name);
+	emit_line(e, "static Object *f%zu(Object **args)", index);
+	emit_line(e, "{");
+	e->depth++;
+
+	/* CALL_FUNCTION binds the last argument first */
+	for(i = parameters->count; i-- > 0; ) {
+		emit_line(e, "f%zu_%s = args[%zu];", index,
+			AST_NODE_AS_ID(parameters->statement_list[i]), i);
+	}
+	if(parameters->count == 0) {
+		emit_line(e, "(void)args;");
+	}
+	emit_line(e, "f%zu___FUNCTION__ = k[%zu];", index,
+		add_constant(e, newString(p->u1.function_node.name)));
+
+	emit_statement(e, p->u1.function_node.body);
+
+	emit_line(e, "return newLong(0L);");
+	e->depth--;
+	emit_line(e, "}");
+	emit_line(e, "");
+}
+
+static void emit_declarations(ComoEmitter *e, FILE *out)
+{
+	Array *constants = O_AVAL(e->constants);
+	Array *functions = O_AVAL(e->functions);
+	Map *globals = O_MVAL(e->globals);
+	size_t i;
+
+	fprintf(out, "static Object *k[%zu];\n\n", constants->size + 1);
+
+	for(i = 0; i < globals->capacity; i++) {
+		Bucket *b;
+		for(b = globals->buckets[i]; b != NULL; b = b->next) {
+			fprintf(out, "static Object *g_%s;\n", b->key->value);
+		}
+	}
+	fputc('\n', out);
+
+	for(i = 0; i < functions->size; i++) {
+		Map *locals = O_MVAL(O_AVAL(e->function_locals)->table[i]);
+		size_t j;
+		for(j = 0; j < locals->capacity; j++) {
+			Bucket *b;
+			for(b = locals->buckets[j]; b != NULL; b = b->next) {
+				fprintf(out, "static Object *f%zu_%s;\n", i, b->key->value);
+			}
+		}
+		fprintf(out, "static Object *f%zu(Object **args);\n\n", i);
+	}
+}
+
+static void emit_main(ComoEmitter *e, const char *body, FILE *out)
+{
+	Array *constants = O_AVAL(e->constants);
+	Array *functions = O_AVAL(e->functions);
+	size_t i;
+
+	fprintf(out, "int main(void)\n{\n");
+
+	for(i = 0; i < constants->size; i++) {
+		Object *value = constants->table[i];
+		if(O_TYPE(value) == IS_LONG) {
+			fprintf(out, "\tk[%zu] = newLong(%ldL);\n", i, O_LVAL(value));
+		} else {
+			fprintf(out, "\tk[%zu] = newString(", i);
+			emit_c_string(out, O_SVAL(value)->value);
+			fprintf(out, ");\n");
+		}
+	}
+
+	fprintf(out, "\n\tg___FUNCTION__ = newString(\"__main__\");\n");
+
+	for(i = 0; i < functions->size; i++) {
+		ast_node *p = (ast_node *)O_PTVAL(functions->table[i]);
+		fprintf(out, "\tg_%s = como_rt_function(\"%s\", %zu, f%zu);\n",
+			p->u1.function_node.name, p->u1.function_node.name,
+			p->u1.function_node.parameter_list->u1.statements_node.count, i);
+	}
+
+	fprintf(out, "\n%s\treturn 0;\n}\n", body);
+}
+
+int como_emit_c(ast_node *program, const char *filename, const char *path)
+{
+	ComoEmitter e;
+	FILE *out;
+	char *functions, *body;
+	size_t length, i;
+
+	out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+
+	if(out == NULL) {
+		como_error_noreturn("can't write '%s'", path);
+	}
+
+	e.globals = newMap(16);
+	e.constants = newArray(16);
+	e.strings = newMap(16);
+	e.functions = newArray(8);
+	e.function_locals = newArray(8);
+	e.locals = NULL;
+	e.function = 0;
+	e.temp = 0;
+	e.depth = 0;
+
+	declare(e.globals, "__FUNCTION__");
+	collect(&e, program, e.globals);
+
+	/* Constants are only all known once everything has been emitted */
+	e.out = open_memstream(&functions, &length);
+	for(i = 0; i < O_AVAL(e.functions)->size; i++) {
+		emit_function(&e, i);
+	}
+	fclose(e.out);
+
+	e.out = open_memstream(&body, &length);
+	e.locals = NULL;
+	e.temp = 0;
+	e.depth = 1;
+	emit_statement(&e, program);
+	fclose(e.out);
+
+	fprintf(out, "/* Generated by como --emit-c from %s */\n", filename);
+	fprintf(out, "#include <stddef.h>\n");
+	fprintf(out, "#include <string.h>\n");
+	fprintf(out, "#include <object.h>\n");
+	fprintf(out, "#include \"como_runtime.h\"\n\n");
+
+	emit_declarations(&e, out);
+	fputs(functions, out);
+	emit_main(&e, body, out);
+
+	free(functions);
+	free(body);
+
+	if(out != stdout) {
+		fclose(out);
+	}
+
+	objectDestroy(e.globals);
+	objectDestroy(e.constants);
+	objectDestroy(e.strings);
+	objectDestroy(e.functions);
+	objectDestroy(e.function_locals);
+
+	return 0;
+}
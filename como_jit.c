@@ -0,0 +1,794 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <object.h>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define COMO_JIT_SUPPORTED 1
+#endif
+
+#include "comodebug.h"
+#include "como_opcode.h"
+#include "como_compiler_ex.h"
+
+/*
+ * The baseline JIT. A function called jit_threshold times is translated
+ * into x86-64 code. The instructions a loop over longs is made of run
+ * natively: LOAD_CONST and LOAD_NAME aren't pushed but left pending, so
+ * the instruction that uses them reads the constant, or calls to look up
+ * the name, itself. Arithmetic and comparisons, generic or quickened,
+ * check for two longs and compute the result in registers, and are fused
+ * with the STORE_NAME or JZ after them: the result is bound without
+ * being pushed, or a comparison jumps on the flags without making a value
+ * at all. A JZ of its own tests for a long zero inline. JMP, JZ and FOR_RANGE become
+ * native jumps, SWITCH an indirect one through a table of the native
+ * address of every pc, kept after the code, and LABEL and NOP disappear.
+ *
+ * Everything else, and arithmetic or a comparison whose operands turn
+ * out not to be longs, calls the helper for the instruction, which keeps the
+ * semantics of como_execute_op, quickening included, once the pending
+ * operands are pushed. The frame is kept in rbx, the operands of
+ * arithmetic and comparisons in r12 and r13, all preserved by calls:
+ *
+ *   push rbx
+ *   push r12
+ *   push r13
+ *   mov rbx, rdi
+ *   ...
+ *   movabs r12, <Object *>      ; LOAD_CONST 1; LOAD_NAME b; IS_LESS_THAN
+ *   mov rdi, rbx
+ *   movabs rsi, <name>
+ *   movabs rax, <como_jit_load_name>
+ *   call rax
+ *   mov r13, rax
+ *   cmp dword [r12 + type], IS_LONG
+ *   jne <slow>
+ *   cmp dword [r13 + type], IS_LONG
+ *   jne <slow>
+ *   mov rax, [r12 + lval]
+ *   cmp rax, [r13 + lval]
+ *   jge <target>                ; the JZ after it
+ *   jmp <done>
+ * slow:
+ *   ...                         ; pushes r12 and r13
+ *   mov rdi, rbx                ; as for every other instruction
+ *   movabs rsi, <ComoOpCode *>
+ *   movabs rax, <helper>
+ *   call rax
+ *   ...                         ; the JZ, through como_jit_branch
+ *   test eax, eax
+ *   jnz <target>
+ * done:
+ *   ...
+ *   mov eax, eax                ; SWITCH, the helper returns the pc to go to
+ *   movabs rcx, <table>
+ *   jmp [rcx + rax * 8]
+ *   ...
+ *   pop r13
+ *   pop r12
+ *   pop rbx
+ *   ret
+ */
+
+typedef struct ComoJitStats {
+	char   *name;
+	size_t  instructions;
+	size_t  bytes;
+	long    nanoseconds;
+} ComoJitStats;
+
+static ComoJitStats *jit_stats = NULL;
+static size_t jit_stats_count = 0;
+static size_t jit_stats_capacity = 0;
+
+static void como_jit_record(const char *name, size_t instructions,
+	size_t bytes, long nanoseconds)
+{
+	if(jit_stats_count == jit_stats_capacity) {
+		jit_stats_capacity = jit_stats_capacity ? jit_stats_capacity * 2 : 16;
+		jit_stats = realloc(jit_stats,
+			sizeof(ComoJitStats) * jit_stats_capacity);
+	}
+
+	jit_stats[jit_stats_count].name = strdup(name);
+	jit_stats[jit_stats_count].instructions = instructions;
+	jit_stats[jit_stats_count].bytes = bytes;
+	jit_stats[jit_stats_count].nanoseconds = nanoseconds;
+	jit_stats_count++;
+}
+
+void como_jit_print_stats(void)
+{
+	size_t i, bytes = 0;
+
+	fprintf(stderr, "%-24s %12s %10s %10s\n", "function", "instructions",
+		"bytes", "usec");
+
+	for(i = 0; i < jit_stats_count; i++) {
+		fprintf(stderr, "%-24s %12zu %10zu %10.1f\n", jit_stats[i].name,
+			jit_stats[i].instructions, jit_stats[i].bytes,
+			(double)jit_stats[i].nanoseconds / 1000.0);
+		bytes += jit_stats[i].bytes;
+	}
+
+	fprintf(stderr, "jit: %zu functions compiled, %zu bytes of code\n",
+		jit_stats_count, bytes);
+}
+
+#ifdef COMO_JIT_SUPPORTED
+
+/* Largest sequence emitted for one instruction, a fused one included */
+#define COMO_JIT_MAX_OP_BYTES 320
+
+enum {
+	RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RSI = 6, RDI = 7,
+	R12 = 12, R13 = 13
+};
+
+typedef struct ComoJitBuffer {
+	unsigned char *code;
+	size_t         size;
+} ComoJitBuffer;
+
+/*
+ * A LOAD_CONST or LOAD_NAME whose value isn't on the frame's stack yet,
+ * the instruction that uses it reads it itself
+ */
+typedef struct ComoJitPending {
+	Object     *constant;
+	const char *name;
+} ComoJitPending;
+
+typedef struct ComoJitCompiler {
+	ComoJitBuffer  b;
+	ComoFrame     *frame;
+	ComoJitPending pending[2];
+	size_t         npending;
+	size_t        *fixups;                /* rel32 of every jump to a pc */
+	size_t        *fixup_targets;
+	size_t         fixup_count;
+} ComoJitCompiler;
+
+/* Offsets into ComoFrame and Object, the latter taken from the O_ macros */
+static size_t off_sp, off_stack, off_type, off_lval;
+
+static void emit_bytes(ComoJitBuffer *b, const unsigned char *bytes, size_t n)
+{
+	memcpy(b->code + b->size, bytes, n);
+	b->size += n;
+}
+
+static void emit_u8(ComoJitBuffer *b, unsigned char byte)
+{
+	b->code[b->size++] = byte;
+}
+
+static void emit_u32(ComoJitBuffer *b, uint32_t value)
+{
+	memcpy(b->code + b->size, &value, sizeof(value));
+	b->size += sizeof(value);
+}
+
+static void emit_u64(ComoJitBuffer *b, uint64_t value)
+{
+	memcpy(b->code + b->size, &value, sizeof(value));
+	b->size += sizeof(value);
+}
+
+/* Emits a rel32 placeholder, returns where it is so it can be patched */
+static size_t emit_rel32(ComoJitBuffer *b)
+{
+	size_t at = b->size;
+	memset(b->code + b->size, 0, 4);
+	b->size += 4;
+	return at;
+}
+
+static void patch_rel32(ComoJitBuffer *b, size_t at, size_t target)
+{
+	int32_t rel = (int32_t)((long)target - (long)(at + 4));
+	memcpy(b->code + at, &rel, sizeof(rel));
+}
+
+static void emit_rex(ComoJitBuffer *b, int w, int reg, int base)
+{
+	unsigned char rex = (unsigned char)(0x40 | (w << 3) | ((reg >> 3) << 2)
+		| (base >> 3));
+	if(rex != 0x40) {
+		emit_u8(b, rex);
+	}
+}
+
+/* The ModRM, and SIB, of [base + disp32] */
+static void emit_mem(ComoJitBuffer *b, int reg, int base, size_t disp)
+{
+	emit_u8(b, (unsigned char)(0x80 | ((reg & 7) << 3) | (base & 7)));
+	if((base & 7) == RSP) {
+		emit_u8(b, 0x24);
+	}
+	emit_u32(b, (uint32_t)disp);
+}
+
+/* op reg, [base + disp], 64 bits */
+static void emit_op_mem(ComoJitBuffer *b, unsigned char op, int reg, 
+	int base, size_t disp)
+{
+	emit_rex(b, 1, reg, base);
+	if(op == 0xaf) {                                /* imul */
+		emit_u8(b, 0x0f);
+	}
+	emit_u8(b, op);
+	emit_mem(b, reg, base, disp);
+}
+
+static void emit_load(ComoJitBuffer *b, int dst, int base, size_t disp)
+{
+	emit_op_mem(b, 0x8b, dst, base, disp);
+}
+
+static void emit_store(ComoJitBuffer *b, int base, size_t disp, int src)
+{
+	emit_op_mem(b, 0x89, src, base, disp);
+}
+
+static void emit_mov(ComoJitBuffer *b, int dst, int src)
+{
+	emit_rex(b, 1, src, dst);
+	emit_u8(b, 0x89);
+	emit_u8(b, (unsigned char)(0xc0 | ((src & 7) << 3) | (dst & 7)));
+}
+
+static void emit_movabs(ComoJitBuffer *b, int reg, uint64_t value)
+{
+	emit_rex(b, 1, 0, reg);
+	emit_u8(b, (unsigned char)(0xb8 | (reg & 7)));
+	emit_u64(b, value);
+}
+
+static void emit_call(ComoJitBuffer *b, const void *fn)
+{
+	static const unsigned char call_rax[] = { 0xff, 0xd0 };
+
+	emit_movabs(b, RAX, (uint64_t)(uintptr_t)fn);
+	emit_bytes(b, call_rax, sizeof(call_rax));
+}
+
+static void emit_call_helper(ComoJitBuffer *b, ComoOpCode *opcode,
+	como_jit_helper_t helper)
+{
+	emit_mov(b, RDI, RBX);
+	emit_movabs(b, RSI, (uint64_t)(uintptr_t)opcode);
+	emit_call(b, (const void *)helper);
+}
+
+/* jcc rel32 (jmp if cc is 0), returns where the rel32 is */
+static size_t emit_jump(ComoJitBuffer *b, unsigned char cc)
+{
+	if(cc == 0) {
+		emit_u8(b, 0xe9);
+	} else {
+		emit_u8(b, 0x0f);
+		emit_u8(b, cc);
+	}
+	return emit_rel32(b);
+}
+
+#define JE  0x84
+#define JNE 0x85
+
+/* Jumps to the pc of a LABEL, patched once every offset is known */
+static void emit_jump_to(ComoJitCompiler *c, unsigned char cc, size_t pc)
+{
+	c->fixups[c->fixup_count] = emit_jump(&c->b, cc);
+	c->fixup_targets[c->fixup_count++] = pc;
+}
+
+/* jne, unless value in reg is a long */
+static size_t emit_guard_long(ComoJitBuffer *b, int reg)
+{
+	emit_rex(b, 0, 0, reg);                         /* cmp dword [reg+type], */
+	emit_u8(b, 0x83);
+	emit_mem(b, 7, reg, off_type);
+	emit_u8(b, IS_LONG);
+	return emit_jump(b, JNE);
+}
+
+/* rcx = cf_sp, rdx = cf_stack */
+static void emit_stack_regs(ComoJitBuffer *b)
+{
+	emit_load(b, RCX, RBX, off_sp);
+	emit_load(b, RDX, RBX, off_stack);
+}
+
+/* reg = cf_stack[cf_sp - depth], reg isn't rcx or rdx */
+static void emit_peek(ComoJitBuffer *b, int reg, size_t depth)
+{
+	emit_stack_regs(b);
+	emit_rex(b, 1, reg, 0);
+	emit_u8(b, 0x8b);
+	emit_u8(b, (unsigned char)(0x44 | ((reg & 7) << 3)));
+	emit_u8(b, 0xca);                               /* [rdx + rcx * 8] */
+	emit_u8(b, (unsigned char)(-(int)(depth * 8)));
+}
+
+/* cf_stack[cf_sp++] = reg, reg isn't rcx or rdx */
+static void emit_push(ComoJitBuffer *b, int reg)
+{
+	static const unsigned char inc_rcx[] = { 0x48, 0xff, 0xc1 };
+
+	emit_stack_regs(b);
+	emit_rex(b, 1, reg, 0);
+	emit_u8(b, 0x89);
+	emit_u8(b, (unsigned char)(0x04 | ((reg & 7) << 3)));
+	emit_u8(b, 0xca);
+	emit_bytes(b, inc_rcx, sizeof(inc_rcx));
+	emit_store(b, RBX, off_sp, RCX);
+}
+
+/* rax = cf_stack[--cf_sp] */
+static void emit_pop(ComoJitBuffer *b)
+{
+	static const unsigned char dec_rcx[] = { 0x48, 0xff, 0xc9 };
+	static const unsigned char mov_rax[] = { 0x48, 0x8b, 0x04, 0xca };
+
+	emit_stack_regs(b);
+	emit_bytes(b, dec_rcx, sizeof(dec_rcx));
+	emit_store(b, RBX, off_sp, RCX);
+	emit_bytes(b, mov_rax, sizeof(mov_rax));
+}
+
+/* cf_sp -= count */
+static void emit_drop(ComoJitBuffer *b, size_t count)
+{
+	emit_rex(b, 1, 0, RBX);
+	emit_u8(b, 0x83);
+	emit_mem(b, 5, RBX, off_sp);
+	emit_u8(b, (unsigned char)count);
+}
+
+/* reg = the value of a pending load, rcx and rdx aren't kept */
+static void emit_pending_value(ComoJitBuffer *b, ComoJitPending *pending, 
+	int reg)
+{
+	if(pending->name == NULL) {
+		emit_movabs(b, reg, (uint64_t)(uintptr_t)pending->constant);
+		return;
+	}
+
+	emit_mov(b, RDI, RBX);
+	emit_movabs(b, RSI, (uint64_t)(uintptr_t)pending->name);
+	emit_call(b, (const void *)como_jit_load_name);
+	if(reg != RAX) {
+		emit_mov(b, reg, RAX);
+	}
+}
+
+/* Puts the first count pending loads on the frame's stack, in order */
+static void flush_pending(ComoJitCompiler *c, size_t count)
+{
+	size_t i;
+
+	for(i = 0; i < count; i++) {
+		emit_pending_value(&c->b, &c->pending[i], RAX);
+		emit_push(&c->b, RAX);
+	}
+
+	for(i = count; i < c->npending; i++) {
+		c->pending[i - count] = c->pending[i];
+	}
+	c->npending -= count;
+}
+
+/* rax = the value on top, taken from the pending loads or the stack */
+static void take_top(ComoJitCompiler *c)
+{
+	flush_pending(c, c->npending > 0 ? c->npending - 1 : 0);
+
+	if(c->npending > 0) {
+		emit_pending_value(&c->b, &c->pending[0], RAX);
+		c->npending = 0;
+	} else {
+		emit_pop(&c->b);
+	}
+}
+
+static void emit_store_name(ComoJitBuffer *b, ComoOpCode *opcode)
+{
+	emit_mov(b, RDX, RAX);
+	emit_mov(b, RDI, RBX);
+	emit_movabs(b, RSI, (uint64_t)(uintptr_t)O_SVAL(opcode->operand)->value);
+	emit_call(b, (const void *)como_jit_store_name);
+}
+
+/* The jcc taken when op, a generic comparison, is false. 0 for the others */
+static unsigned char jump_if_false(unsigned char op)
+{
+	switch(op) {
+		case IS_LESS_THAN:             return 0x8d;  /* jge */
+		case IS_LESS_THAN_OR_EQUAL:    return 0x8f;  /* jg */
+		case IS_GREATER_THAN:          return 0x8e;  /* jle */
+		case IS_GREATER_THAN_OR_EQUAL: return 0x8c;  /* jl */
+		case IS_EQUAL:                 return JNE;
+		case IS_NOT_EQUAL:             return JE;
+		default:                       return 0;
+	}
+}
+
+/*
+ * A binary instruction on numbers, in any of its forms. The operands go to
+ * r12 and r13, from the pending loads or the stack, and are checked to be
+ * longs, the only case its forms all agree on.
+ * The result is computed in rax and, when next is a STORE_NAME, stored 
+ * without being pushed, or when it is a JZ, not made at all: the 
+ * comparison jumps itself. Otherwise the helper runs the instruction, and
+ * next, as if the operands had been pushed. Returns whether next was fused
+ */
+static int emit_long_long(ComoJitCompiler *c, ComoOpCode *opcode,
+	ComoOpCode *next)
+{
+	static const unsigned char cqo[] = { 0x48, 0x99 };
+	static const unsigned char mov_rax_rdx[] = { 0x48, 0x89, 0xd0 };
+	static const unsigned char test_eax_eax[] = { 0x85, 0xc0 };
+	static const unsigned char movzx_eax_al[] = { 0x0f, 0xb6, 0xc0 };
+	ComoJitBuffer *b = &c->b;
+	unsigned char op = como_opcode_generic(opcode->op_code);
+	unsigned char false_jump = jump_if_false(op);
+	size_t on_stack, guards[3], nguards = 0, done, i;
+	int fused = 0;
+
+	if(next != NULL && ((false_jump != 0 && next->op_code == JZ) 
+			|| (false_jump == 0 && next->op_code == STORE_NAME))) {
+		fused = 1;
+	}
+
+	on_stack = 2 - c->npending;
+	if(on_stack == 2) {
+		emit_peek(b, R12, 2);
+		emit_peek(b, R13, 1);
+	} else if(on_stack == 1) {
+		emit_peek(b, R12, 1);
+		emit_pending_value(b, &c->pending[0], R13);
+	} else {
+		emit_pending_value(b, &c->pending[0], R12);
+		emit_pending_value(b, &c->pending[1], R13);
+	}
+
+	guards[nguards++] = emit_guard_long(b, R12);
+	guards[nguards++] = emit_guard_long(b, R13);
+
+	if(op == IDIV || op == IREM) {
+		emit_rex(b, 1, 0, R13);                     /* cmp qword [r13+lval], 0 */
+		emit_u8(b, 0x83);
+		emit_mem(b, 7, R13, off_lval);
+		emit_u8(b, 0);
+		guards[nguards++] = emit_jump(b, JE);
+	}
+
+	emit_load(b, RAX, R12, off_lval);
+	switch(op) {
+		case IADD:
+			emit_op_mem(b, 0x03, RAX, R13, off_lval);
+		break;
+		case IMINUS:
+			emit_op_mem(b, 0x2b, RAX, R13, off_lval);
+		break;
+		case ITIMES:
+			emit_op_mem(b, 0xaf, RAX, R13, off_lval);
+		break;
+		case IDIV:
+		case IREM:
+			emit_bytes(b, cqo, sizeof(cqo));
+			emit_op_mem(b, 0xf7, 7, R13, off_lval); /* idiv */
+			if(op == IREM) {
+				emit_bytes(b, mov_rax_rdx, sizeof(mov_rax_rdx));
+			}
+		break;
+		default:
+			emit_op_mem(b, 0x3b, RAX, R13, off_lval);
+			if(!fused) {
+				emit_u8(b, 0x0f);                   /* setcc al */
+				emit_u8(b, (unsigned char)((false_jump ^ 1) + 0x10));
+				emit_u8(b, 0xc0);
+				emit_bytes(b, movzx_eax_al, sizeof(movzx_eax_al));
+			}
+		break;
+	}
+
+	if(on_stack > 0) {
+		/* Flags are kept, sub sets them though: the jcc comes first */
+		if(fused && false_jump != 0) {
+			size_t taken = emit_jump(b, false_jump);
+			emit_drop(b, on_stack);
+			done = emit_jump(b, 0);
+			patch_rel32(b, taken, b->size);
+			emit_drop(b, on_stack);
+			emit_jump_to(c, 0, (size_t)O_LVAL(next->operand));
+			goto slow;
+		}
+		emit_drop(b, on_stack);
+	}
+
+	if(fused && false_jump != 0) {
+		emit_jump_to(c, false_jump, (size_t)O_LVAL(next->operand));
+	} else {
+		emit_mov(b, RDI, RAX);
+		emit_call(b, (const void *)newLong);
+		if(fused) {
+			emit_store_name(b, next);
+		} else {
+			emit_push(b, RAX);
+		}
+	}
+	done = emit_jump(b, 0);
+
+slow:
+	for(i = 0; i < nguards; i++) {
+		patch_rel32(b, guards[i], b->size);
+	}
+	if(on_stack == 0) {
+		emit_push(b, R12);
+	}
+	if(on_stack <= 1) {
+		emit_push(b, R13);
+	}
+	emit_call_helper(b, opcode, como_jit_helper(opcode->op_code));
+	if(fused && false_jump != 0) {
+		emit_call_helper(b, next, como_jit_branch);
+		emit_bytes(b, test_eax_eax, sizeof(test_eax_eax));
+		emit_jump_to(c, JNE, (size_t)O_LVAL(next->operand));
+	} else if(fused) {
+		emit_call_helper(b, next, como_jit_helper(STORE_NAME));
+	}
+	patch_rel32(b, done, b->size);
+
+	c->npending = 0;
+	return fused;
+}
+
+/* Reads where the O_ macros put a long's type and value */
+static int como_jit_layout(void)
+{
+	Object probe;
+
+	off_sp = offsetof(ComoFrame, cf_sp);
+	off_stack = offsetof(ComoFrame, cf_stack);
+	off_type = (size_t)((char *)&O_TYPE(&probe) - (char *)&probe);
+	off_lval = (size_t)((char *)&O_LVAL(&probe) - (char *)&probe);
+
+	return sizeof(O_TYPE(&probe)) == 4 && sizeof(O_LVAL(&probe)) == 8 
+		&& sizeof(((ComoFrame *)NULL)->cf_sp) == 8;
+}
+
+como_jit_code_t como_jit_compile(ComoFrame *frame, const char *name)
+{
+	static const unsigned char prologue[] = {
+		0x53,                                       /* push rbx */
+		0x41, 0x54,                                 /* push r12 */
+		0x41, 0x55,                                 /* push r13 */
+		0x48, 0x89, 0xfb                            /* mov rbx, rdi */
+	};
+	static const unsigned char epilogue[] = {
+		0x41, 0x5d,                                 /* pop r13 */
+		0x41, 0x5c,                                 /* pop r12 */
+		0x5b,                                       /* pop rbx */
+		0xc3                                        /* ret */
+	};
+	static const unsigned char test_eax_eax[] = { 0x85, 0xc0 };
+	static const unsigned char mov_eax_eax[] = { 0x89, 0xc0 };
+	static const unsigned char jmp_rcx_rax[] = { 0xff, 0x24, 0xc1 };
+	Array *table = O_AVAL(frame->code);
+	size_t count = table->size;
+	size_t *offsets;
+	size_t switch_count = 0, capacity, page, skip, i;
+	ComoJitCompiler c;
+	ComoJitBuffer *b = &c.b;
+	struct timespec start, end;
+	uint64_t *addresses;
+	void *memory;
+
+	if(!como_jit_layout()) {
+		return NULL;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	page = (size_t)sysconf(_SC_PAGESIZE);
+	capacity = sizeof(prologue) + sizeof(epilogue)
+		+ count * COMO_JIT_MAX_OP_BYTES;
+	/* Room for the SWITCH table, aligned */
+	capacity = ((capacity + 7) & ~(size_t)7) + count * sizeof(uint64_t);
+	capacity = (capacity + page - 1) & ~(page - 1);
+
+	memory = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if(memory == MAP_FAILED) {
+		return NULL;
+	}
+
+	b->code = memory;
+	b->size = 0;
+	c.frame = frame;
+	c.npending = 0;
+	c.fixup_count = 0;
+
+	/* Native offset of every instruction, and one past the last */
+	offsets = malloc(sizeof(size_t) * (count + 1));
+	/* A fused instruction has two jumps */
+	c.fixups = malloc(sizeof(size_t) * (2 * count + 1));
+	c.fixup_targets = malloc(sizeof(size_t) * (2 * count + 1));
+
+	emit_bytes(b, prologue, sizeof(prologue));
+
+	/* Where it goes is only known once every offset is */
+	addresses = (uint64_t *)((unsigned char *)memory + (((sizeof(prologue) 
+		+ sizeof(epilogue) + count * COMO_JIT_MAX_OP_BYTES) + 7) 
+		& ~(size_t)7));
+
+	for(i = 0; i < count; i++) {
+		ComoOpCode *opcode = (ComoOpCode *)O_PTVAL(table->table[i]);
+		ComoOpCode *next = i + 1 < count 
+			? (ComoOpCode *)O_PTVAL(table->table[i + 1]) : NULL;
+
+		offsets[i] = b->size;
+		skip = 0;
+
+		switch(como_opcode_generic(opcode->op_code)) {
+			case NOP:
+			break;
+			case LOAD_CONST:
+			case LOAD_NAME:
+				if(c.npending == 2) {
+					flush_pending(&c, 1);
+				}
+				c.pending[c.npending].constant = opcode->operand;
+				c.pending[c.npending].name = opcode->op_code == LOAD_NAME
+					? O_SVAL(opcode->operand)->value : NULL;
+				c.npending++;
+			break;
+			case STORE_NAME:
+				take_top(&c);
+				emit_store_name(b, opcode);
+			break;
+			case IADD:
+			case IMINUS:
+			case ITIMES:
+			case IDIV:
+			case IREM:
+			case IS_LESS_THAN:
+			case IS_LESS_THAN_OR_EQUAL:
+			case IS_GREATER_THAN:
+			case IS_GREATER_THAN_OR_EQUAL:
+			case IS_EQUAL:
+			case IS_NOT_EQUAL:
+				skip = (size_t)emit_long_long(&c, opcode, next);
+			break;
+			case JZ: {
+				size_t not_long;
+				take_top(&c);
+				/* Jumps on a long zero, see como_rt_is_false */
+				not_long = emit_guard_long(b, RAX);
+				emit_rex(b, 1, 0, RAX);             /* cmp qword [rax+lval], 0 */
+				emit_u8(b, 0x83);
+				emit_mem(b, 7, RAX, off_lval);
+				emit_u8(b, 0);
+				emit_jump_to(&c, JE, (size_t)O_LVAL(opcode->operand));
+				patch_rel32(b, not_long, b->size);
+			}
+			break;
+			default:
+				/* Everything else takes its operands from the stack */
+				flush_pending(&c, c.npending);
+
+				switch(opcode->op_code) {
+					case LABEL:
+					case HALT:
+					break;
+					case JMP:
+						emit_jump_to(&c, 0, (size_t)O_LVAL(opcode->operand));
+					break;
+					case FOR_RANGE:
+						emit_call_helper(b, opcode, como_jit_branch);
+						emit_bytes(b, test_eax_eax, sizeof(test_eax_eax));
+						emit_jump_to(&c, JNE, 
+							(size_t)O_LVAL(COMO_JUMP_TARGET(opcode)));
+					break;
+					case SWITCH:
+						emit_call_helper(b, opcode, como_jit_switch);
+						emit_bytes(b, mov_eax_eax, sizeof(mov_eax_eax));
+						emit_movabs(b, RCX, (uint64_t)(uintptr_t)addresses);
+						emit_bytes(b, jmp_rcx_rax, sizeof(jmp_rcx_rax));
+						switch_count++;
+					break;
+					case IRETURN:
+						emit_call_helper(b, opcode, 
+							como_jit_helper(opcode->op_code));
+						emit_jump_to(&c, 0, count);
+					break;
+					default:
+						emit_call_helper(b, opcode, 
+							como_jit_helper(opcode->op_code));
+					break;
+				}
+			break;
+		}
+
+		/* Nothing jumps to a fused instruction, it is never a LABEL's next */
+		if(skip) {
+			offsets[++i] = b->size;
+		}
+	}
+
+	flush_pending(&c, c.npending);
+	offsets[count] = b->size;
+	emit_bytes(b, epilogue, sizeof(epilogue));
+
+	/*
+	 * Execution resumes after the LABEL a jump targets, which emits no
+	 * code but what puts the pending loads before it on the stack, so the
+	 * jump lands on whatever follows it. IRETURN jumps to the epilogue, 
+	 * recorded as target count
+	 */
+	for(i = 0; i < c.fixup_count; i++) {
+		size_t target = c.fixup_targets[i] == count ? count
+			: c.fixup_targets[i] + 1;
+		patch_rel32(b, c.fixups[i], offsets[target]);
+	}
+
+	/* Like a jump, SWITCH goes to what follows the LABEL at the pc */
+	for(i = 0; i < count && switch_count > 0; i++) {
+		addresses[i] = (uint64_t)(uintptr_t)((unsigned char *)memory 
+			+ offsets[i + 1]);
+	}
+
+	free(offsets);
+	free(c.fixups);
+	free(c.fixup_targets);
+
+	if(mprotect(memory, capacity, PROT_READ | PROT_EXEC) != 0) {
+		munmap(memory, capacity);
+		return NULL;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	como_jit_record(name, count, b->size,
+		(end.tv_sec - start.tv_sec) * 1000000000L
+			+ (end.tv_nsec - start.tv_nsec));
+
+	return (como_jit_code_t)memory;
+}
+
+#else
+
+/* Functions stay interpreted */
+como_jit_code_t como_jit_compile(ComoFrame *frame, const char *name)
+{
+	(void)frame;
+	(void)name;
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "como_opcode.h"
+
+#define OPCODE_NAME(op) case op: return #op
+
+const char *como_opcode_name(unsigned char op_code)
+{
+	switch(op_code) {
+		OPCODE_NAME(INONE);
+		OPCODE_NAME(LOAD_CONST);
+		OPCODE_NAME(STORE_NAME);
+		OPCODE_NAME(LOAD_NAME);
+		OPCODE_NAME(IS_LESS_THAN);
+		OPCODE_NAME(JZ);
+		OPCODE_NAME(IPRINT);
+		OPCODE_NAME(IADD);
+		OPCODE_NAME(JMP);
+		OPCODE_NAME(IRETURN);
+		OPCODE_NAME(NOP);
+		OPCODE_NAME(LABEL);
+		OPCODE_NAME(HALT);
+		OPCODE_NAME(IS_EQUAL);
+		OPCODE_NAME(IDIV);
+		OPCODE_NAME(ITIMES);
+		OPCODE_NAME(IMINUS);
+		OPCODE_NAME(IS_GREATER_THAN);
+		OPCODE_NAME(IS_NOT_EQUAL);
+		OPCODE_NAME(IS_GREATER_THAN_OR_EQUAL);
+		OPCODE_NAME(IS_LESS_THAN_OR_EQUAL);
+		OPCODE_NAME(DEFINE_FUNCTION);
+		OPCODE_NAME(CALL_FUNCTION);
+		OPCODE_NAME(POSTFIX_INC);
+		OPCODE_NAME(UNARY_MINUS);
+		OPCODE_NAME(IREM);
+		OPCODE_NAME(POSTFIX_DEC);
+		OPCODE_NAME(POP_TOP);
+		OPCODE_NAME(FOR_RANGE);
+		OPCODE_NAME(INPLACE_ADD);
+		OPCODE_NAME(INPLACE_MINUS);
+		OPCODE_NAME(INPLACE_TIMES);
+		OPCODE_NAME(INPLACE_DIV);
+		OPCODE_NAME(INPLACE_REM);
+		OPCODE_NAME(INPLACE_INC);
+		OPCODE_NAME(INPLACE_DEC);
+		OPCODE_NAME(PREFIX_INC);
+		OPCODE_NAME(PREFIX_DEC);
+		OPCODE_NAME(SWITCH);
+		OPCODE_NAME(IADD_LONG_LONG);
+		OPCODE_NAME(IMINUS_LONG_LONG);
+		OPCODE_NAME(ITIMES_LONG_LONG);
+		OPCODE_NAME(IDIV_LONG_LONG);
+		OPCODE_NAME(IREM_LONG_LONG);
+		OPCODE_NAME(IS_LESS_THAN_LONG_LONG);
+		OPCODE_NAME(IS_LESS_THAN_OR_EQUAL_LONG_LONG);
+		OPCODE_NAME(IS_GREATER_THAN_LONG_LONG);
+		OPCODE_NAME(IS_GREATER_THAN_OR_EQUAL_LONG_LONG);
+		OPCODE_NAME(IS_EQUAL_LONG_LONG);
+		OPCODE_NAME(IS_NOT_EQUAL_LONG_LONG);
+		OPCODE_NAME(IS_EQUAL_STR_STR);
+		OPCODE_NAME(IS_NOT_EQUAL_STR_STR);
+		OPCODE_NAME(IADD_STR_STR);
+		default:
+			return "UNKNOWN";
+	}
+}
+
+unsigned char como_opcode_generic(unsigned char op_code)
+{
+	switch(op_code) {
+		case IADD_LONG_LONG:
+		case IADD_STR_STR:
+			return IADD;
+		case IMINUS_LONG_LONG:
+			return IMINUS;
+		case ITIMES_LONG_LONG:
+			return ITIMES;
+		case IDIV_LONG_LONG:
+			return IDIV;
+		case IREM_LONG_LONG:
+			return IREM;
+		case IS_LESS_THAN_LONG_LONG:
+			return IS_LESS_THAN;
+		case IS_LESS_THAN_OR_EQUAL_LONG_LONG:
+			return IS_LESS_THAN_OR_EQUAL;
+		case IS_GREATER_THAN_LONG_LONG:
+			return IS_GREATER_THAN;
+		case IS_GREATER_THAN_OR_EQUAL_LONG_LONG:
+			return IS_GREATER_THAN_OR_EQUAL;
+		case IS_EQUAL_LONG_LONG:
+		case IS_EQUAL_STR_STR:
+			return IS_EQUAL;
+		case IS_NOT_EQUAL_LONG_LONG:
+		case IS_NOT_EQUAL_STR_STR:
+			return IS_NOT_EQUAL;
+		default:
+			return op_code;
+	}
+}
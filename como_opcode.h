@@ -28,6 +28,77 @@
 #define UNARY_MINUS              0x18
 #define IREM					 0x19
 #define POSTFIX_DEC              0x20
+#define POP_TOP                  0x21
+
+/* 
+ * The end of a counted loop, i++ or i-- and then i compared to a number or
+ * a name, in one instruction. Jumps to the LABEL after the loop once the
+ * comparison is false. The operand is an Array of these
+ */
+#define FOR_RANGE                0x22
+#define FOR_RANGE_TARGET         0     /* Long, pc of the LABEL */
+#define FOR_RANGE_NAME           1     /* String, the counter */
+#define FOR_RANGE_BOUND          2     /* Long, or String naming it */
+#define FOR_RANGE_TEST           3     /* Long, IS_LESS_THAN ... IS_NOT_EQUAL */
+#define FOR_RANGE_STEP           4     /* Long, 1 or -1 */
+
+/* 
+ * name = name op value, and name += value, in one instruction. The operand
+ * is the name, value is popped. INPLACE_INC and INPLACE_DEC add or 
+ * subtract 1 and pop nothing. PREFIX_INC and PREFIX_DEC are ++name and
+ * --name, which push the new value
+ */
+#define INPLACE_ADD              0x23
+#define INPLACE_MINUS            0x24
+#define INPLACE_TIMES            0x25
+#define INPLACE_DIV              0x26
+#define INPLACE_REM              0x27
+#define INPLACE_INC              0x28
+#define INPLACE_DEC              0x29
+#define PREFIX_INC               0x2a
+#define PREFIX_DEC               0x2b
+
+/* 
+ * switch, pops the value and jumps to the LABEL of the case it matches.
+ * The operand is an Array of these
+ */
+#define SWITCH                   0x2c
+#define SWITCH_TARGETS           0     /* Array of Long, pc of the LABEL of
+                                          each case, then where no case 
+                                          matches goes */
+#define SWITCH_MIN               1     /* Long, smallest long label */
+#define SWITCH_DENSE             2     /* Array of Long, the case of label 
+                                          SWITCH_MIN + i, or -1. Empty if 
+                                          the long labels are too sparse */
+#define SWITCH_KEYS              3     /* Array of Long, long labels sorted */
+#define SWITCH_CASES             4     /* Array of Long, case of each key */
+#define SWITCH_STRINGS           5     /* Map, case of each string label */
+
+/* 
+ * Quickened instructions, never emitted by the compiler. como_execute 
+ * rewrites a generic instruction into one of these once it has seen the
+ * types of its operands, and back again when they change
+ */
+#define IADD_LONG_LONG                     0x40
+#define IMINUS_LONG_LONG                   0x41
+#define ITIMES_LONG_LONG                   0x42
+#define IDIV_LONG_LONG                     0x43
+#define IREM_LONG_LONG                     0x44
+#define IS_LESS_THAN_LONG_LONG             0x45
+#define IS_LESS_THAN_OR_EQUAL_LONG_LONG    0x46
+#define IS_GREATER_THAN_LONG_LONG          0x47
+#define IS_GREATER_THAN_OR_EQUAL_LONG_LONG 0x48
+#define IS_EQUAL_LONG_LONG                 0x49
+#define IS_NOT_EQUAL_LONG_LONG             0x4a
+#define IS_EQUAL_STR_STR                   0x4b
+#define IS_NOT_EQUAL_STR_STR               0x4c
+#define IADD_STR_STR                       0x4d
+
+/* Defined in como_opcode.c */
+extern const char *como_opcode_name(unsigned char op_code);
+
+/* The generic instruction a quickened one was rewritten from */
+extern unsigned char como_opcode_generic(unsigned char op_code);
 
 
 #endif /* !COMO_OPCODE_H */
\ No newline at end of file
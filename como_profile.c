@@ -0,0 +1,239 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <object.h>
+
+#include "comodebug.h"
+#include "como_opcode.h"
+#include "como_compiler_ex.h"
+
+/*
+ * Type feedback profiles, see --profile. At exit every compiled function's
+ * call count and quickened instructions are written out:
+ *
+ *   como-profile 1 <source hash>
+ *   function <name> <calls> <number of instructions below>
+ *   <pc> <generic op_code> <quickened op_code> <misses>
+ *
+ * The next run of the same source loads them, and every function is
+ * compiled straight into the instructions the last run ended up with.
+ * A profile for a different source is ignored.
+ */
+
+#define COMO_PROFILE_VERSION 1
+
+typedef struct ComoProfileOp {
+	size_t        pc;
+	unsigned char generic;
+	unsigned char quickened;
+	unsigned char misses;
+} ComoProfileOp;
+
+typedef struct ComoProfileFunction {
+	long           calls;
+	size_t         count;
+	ComoProfileOp *ops;
+} ComoProfileFunction;
+
+/* Function name to ComoProfileFunction, NULL without a usable profile */
+static Object *profile = NULL;
+
+/* FNV-1a, over the raw bytes of the source file */
+uint64_t como_profile_hash_file(const char *filename)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	unsigned char buffer[8192];
+	size_t i, n;
+	FILE *fp = fopen(filename, "rb");
+
+	if(fp == NULL) {
+		return 0;
+	}
+
+	while((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+		for(i = 0; i < n; i++) {
+			hash ^= buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	fclose(fp);
+
+	return hash;
+}
+
+void como_profile_load(const char *path, uint64_t hash)
+{
+	FILE *fp = fopen(path, "r");
+	int version;
+	uint64_t profile_hash;
+	char name[256];
+	long calls;
+	size_t i, count;
+
+	if(fp == NULL) {
+		return;
+	}
+
+	if(fscanf(fp, "como-profile %d %" SCNx64, &version, &profile_hash) != 2
+			|| version != COMO_PROFILE_VERSION || profile_hash != hash) {
+		fclose(fp);
+		return;
+	}
+
+	profile = newMap(16);
+
+	while(fscanf(fp, " function %255s %ld %zu", name, &calls, &count) == 3) {
+		ComoProfileFunction *fn = malloc(sizeof(ComoProfileFunction));
+		fn->calls = calls;
+		fn->count = 0;
+		fn->ops = malloc(sizeof(ComoProfileOp) * (count + 1));
+
+		for(i = 0; i < count; i++) {
+			unsigned int generic, quickened, misses;
+			ComoProfileOp *op = &fn->ops[fn->count];
+			if(fscanf(fp, " %zu %x %x %u", &op->pc, &generic, &quickened,
+					&misses) != 4) {
+				break;
+			}
+			op->generic = (unsigned char)generic;
+			op->quickened = (unsigned char)quickened;
+			op->misses = (unsigned char)misses;
+			fn->count++;
+		}
+
+		mapInsertEx(profile, name, newPointer((void *)fn));
+	}
+
+	fclose(fp);
+}
+
+long como_profile_calls(const char *name)
+{
+	Object *fn;
+
+	if(profile == NULL || (fn = mapSearch(profile, name)) == NULL) {
+		return 0;
+	}
+
+	return ((ComoProfileFunction *)O_PTVAL(fn))->calls;
+}
+
+/*
+ * Rewrites freshly compiled code into the quickened form recorded for it,
+ * before it is verified. An entry only applies if the instruction at that
+ * pc is still the generic one it was recorded against, and the form is one
+ * of that instruction's
+ */
+void como_profile_apply(const char *name, Object *code)
+{
+	Object *value;
+	ComoProfileFunction *fn;
+	Array *table = O_AVAL(code);
+	size_t i;
+
+	if(profile == NULL || (value = mapSearch(profile, name)) == NULL) {
+		return;
+	}
+
+	fn = (ComoProfileFunction *)O_PTVAL(value);
+
+	for(i = 0; i < fn->count; i++) {
+		ComoProfileOp *op = &fn->ops[i];
+		ComoOpCode *opcode;
+
+		if(op->pc >= table->size) {
+			continue;
+		}
+
+		opcode = (ComoOpCode *)O_PTVAL(table->table[op->pc]);
+
+		if(opcode->op_code == op->generic 
+				&& como_opcode_generic(op->quickened) == op->generic) {
+			opcode->op_code = op->quickened;
+			opcode->op_misses = op->misses;
+		}
+	}
+}
+
+static void como_profile_save_code(FILE *fp, const char *name, long calls,
+	Object *code)
+{
+	Array *table = O_AVAL(code);
+	size_t i, count = 0;
+
+	for(i = 0; i < table->size; i++) {
+		ComoOpCode *opcode = (ComoOpCode *)O_PTVAL(table->table[i]);
+		if(opcode->op_code != como_opcode_generic(opcode->op_code)
+				|| opcode->op_misses > 0) {
+			count++;
+		}
+	}
+
+	fprintf(fp, "function %s %ld %zu\n", name, calls, count);
+
+	for(i = 0; i < table->size; i++) {
+		ComoOpCode *opcode = (ComoOpCode *)O_PTVAL(table->table[i]);
+		unsigned char generic = como_opcode_generic(opcode->op_code);
+		if(opcode->op_code != generic || opcode->op_misses > 0) {
+			fprintf(fp, "%zu %x %x %u\n", i, generic, opcode->op_code,
+				opcode->op_misses);
+		}
+	}
+}
+
+/*
+ * Every function still bound in the global symbol table is written, along
+ * with the main code when it is still around (it isn't with --stream)
+ */
+void como_profile_save(const char *path, uint64_t hash, Object *symtab,
+	Object *main_code)
+{
+	FILE *fp = fopen(path, "w");
+	Map *map = O_MVAL(symtab);
+	size_t i;
+
+	if(fp == NULL) {
+		como_error_noreturn("can't write profile '%s'", path);
+	}
+
+	fprintf(fp, "como-profile %d %" PRIx64 "\n", COMO_PROFILE_VERSION, hash);
+
+	if(main_code != NULL) {
+		como_profile_save_code(fp, "__main__", 1, main_code);
+	}
+
+	for(i = 0; i < map->capacity; i++) {
+		Bucket *b;
+		for(b = map->buckets[i]; b != NULL; b = b->next) {
+			ComoFrame *fn;
+			if(O_TYPE(b->value) != IS_POINTER
+					|| (O_FLG(b->value) & COMO_LAZY_FUNCTION)) {
+				continue;
+			}
+			fn = (ComoFrame *)O_PTVAL(b->value);
+			como_profile_save_code(fp, b->key->value, fn->cf_calls, fn->code);
+		}
+	}
+
+	fclose(fp);
+}
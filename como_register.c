@@ -0,0 +1,1248 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "ast.h"
+#include "comodebug.h"
+#include "como_runtime.h"
+#include "como_register.h"
+#include "como_ssa.h"
+#include "como_compiler_ex.h"
+
+#define OPCODE_NAME(op) case op: return #op
+
+/* Which fields of an instruction are registers */
+#define REG_FIELD_DST 1
+#define REG_FIELD_A   2
+#define REG_FIELD_B   4
+
+const char *como_reg_opcode_name(unsigned char op)
+{
+	switch(op) {
+		OPCODE_NAME(REG_MOVE);
+		OPCODE_NAME(REG_LOAD_GLOBAL);
+		OPCODE_NAME(REG_LOAD_LOCAL_OR_GLOBAL);
+		OPCODE_NAME(REG_UNDEFINED);
+		OPCODE_NAME(REG_ADD);
+		OPCODE_NAME(REG_SUB);
+		OPCODE_NAME(REG_MUL);
+		OPCODE_NAME(REG_DIV);
+		OPCODE_NAME(REG_REM);
+		OPCODE_NAME(REG_LT);
+		OPCODE_NAME(REG_LTE);
+		OPCODE_NAME(REG_GT);
+		OPCODE_NAME(REG_GTE);
+		OPCODE_NAME(REG_EQ);
+		OPCODE_NAME(REG_NEQ);
+		OPCODE_NAME(REG_NEG);
+		OPCODE_NAME(REG_INC);
+		OPCODE_NAME(REG_DEC);
+		OPCODE_NAME(REG_JMP);
+		OPCODE_NAME(REG_JZ);
+		OPCODE_NAME(REG_CALL);
+		OPCODE_NAME(REG_RETURN);
+		OPCODE_NAME(REG_RETURN_NONE);
+		OPCODE_NAME(REG_PRINT);
+		OPCODE_NAME(REG_COPY);
+		OPCODE_NAME(REG_CHECK);
+		OPCODE_NAME(REG_ADD_LONG);
+		OPCODE_NAME(REG_SUB_LONG);
+		OPCODE_NAME(REG_MUL_LONG);
+		OPCODE_NAME(REG_DIV_LONG);
+		OPCODE_NAME(REG_REM_LONG);
+		OPCODE_NAME(REG_LT_LONG);
+		OPCODE_NAME(REG_LTE_LONG);
+		OPCODE_NAME(REG_GT_LONG);
+		OPCODE_NAME(REG_GTE_LONG);
+		OPCODE_NAME(REG_EQ_LONG);
+		OPCODE_NAME(REG_NEQ_LONG);
+		OPCODE_NAME(REG_NEG_LONG);
+		OPCODE_NAME(REG_JZ_LONG);
+		OPCODE_NAME(REG_CONCAT);
+		OPCODE_NAME(REG_JNZ);
+		OPCODE_NAME(REG_JNZ_LONG);
+	}
+	return "UNKNOWN";
+}
+
+static int reg_fields(unsigned char op)
+{
+	switch(op) {
+		case REG_MOVE:
+		case REG_COPY:
+		case REG_NEG:
+		case REG_NEG_LONG:
+		case REG_INC:
+		case REG_DEC:
+		case REG_LOAD_LOCAL_OR_GLOBAL:
+			return REG_FIELD_DST | REG_FIELD_A;
+		case REG_LOAD_GLOBAL:
+		case REG_UNDEFINED:
+			return REG_FIELD_DST;
+		case REG_JZ:
+		case REG_JZ_LONG:
+		case REG_JNZ:
+		case REG_JNZ_LONG:
+		case REG_RETURN:
+		case REG_PRINT:
+		case REG_CHECK:
+			return REG_FIELD_A;
+		case REG_JMP:
+		case REG_RETURN_NONE:
+			return 0;
+		case REG_CALL:
+			return REG_FIELD_DST | REG_FIELD_A;
+		default:
+			return REG_FIELD_DST | REG_FIELD_A | REG_FIELD_B;
+	}
+}
+
+/* The top level code, whose slots LOAD_GLOBAL reads */
+static ComoRegFunction *reg_main = NULL;
+
+/* Every function, __main__ last, for --register-stats */
+static Object *reg_functions = NULL;
+
+typedef struct ComoRegCompiler {
+	ComoRegFunction *fn;
+	Object          *slots;          /* Map, name to slot of fn */
+	Object          *globals;        /* Map, name to slot of __main__ */
+	Object          *constants;      /* Array, the values of fn's constants */
+	Object          *strings;        /* Map, string literal to its constant */
+	unsigned int     temp;           /* next free temporary */
+	Object          *ssa;            /* Array, every function lowered by --ssa */
+} ComoRegCompiler;
+
+/* Names a scope assigns, and the functions it declares, in binding order */
+typedef struct ComoRegScope {
+	ast_node *node;                  /* FUNC_DECL, NULL for __main__ */
+	Object   *slots;
+} ComoRegScope;
+
+static void declare(Object *slots, const char *name)
+{
+	if(mapSearch(slots, name) == NULL) {
+		mapInsertEx(slots, name,
+			newLong((long)O_MVAL(slots)->size));
+	}
+}
+
+/*
+ * Gives every name a scope assigns a slot, and finds the functions
+ * declared in it. Nested functions are bound before the function
+ * declaring them, like como_compile_function does
+ */
+static void collect(Object *scopes, Object *globals, ast_node *p,
+	Object *slots)
+{
+	size_t i;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				collect(scopes, globals, p->u1.statements_node.statement_list[i],
+					slots);
+			}
+		break;
+		case AST_NODE_TYPE_BIN_OP:
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				declare(slots, AST_NODE_AS_ID(p->u1.binary_node.left));
+			} else {
+				collect(scopes, globals, p->u1.binary_node.left, slots);
+			}
+			collect(scopes, globals, p->u1.binary_node.right, slots);
+		break;
+		case AST_NODE_TYPE_POSTFIX:
+			declare(slots, AST_NODE_AS_ID(p->u1.postfix_node.expr));
+		break;
+		case AST_NODE_TYPE_PREFIX:
+			collect(scopes, globals, p->u1.prefix_node.expr, slots);
+		break;
+		case AST_NODE_TYPE_UNARY_OP:
+			collect(scopes, globals, p->u1.unary_node.expr, slots);
+		break;
+		case AST_NODE_TYPE_CALL:
+			collect(scopes, globals, p->u1.call_node.arguments, slots);
+		break;
+		case AST_NODE_TYPE_RET:
+			collect(scopes, globals, p->u1.return_node.expr, slots);
+		break;
+		case AST_NODE_TYPE_PRINT:
+			collect(scopes, globals, p->u1.print_node.expr, slots);
+		break;
+		case AST_NODE_TYPE_IF:
+			collect(scopes, globals, p->u1.if_node.condition, slots);
+			collect(scopes, globals, p->u1.if_node.b1, slots);
+			collect(scopes, globals, p->u1.if_node.b2, slots);
+		break;
+		case AST_NODE_TYPE_WHILE:
+			collect(scopes, globals, p->u1.while_node.condition, slots);
+			collect(scopes, globals, p->u1.while_node.body, slots);
+		break;
+		case AST_NODE_TYPE_FOR:
+			collect(scopes, globals, p->u1.for_node.initialization, slots);
+			collect(scopes, globals, p->u1.for_node.condition, slots);
+			collect(scopes, globals, p->u1.for_node.final_expression, slots);
+			collect(scopes, globals, p->u1.for_node.body, slots);
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			collect(scopes, globals, p->u1.switch_node.expr, slots);
+			collect(scopes, globals, p->u1.switch_node.cases, slots);
+		break;
+		case AST_NODE_TYPE_CASE:
+			collect(scopes, globals, p->u1.case_node.body, slots);
+		break;
+		case AST_NODE_TYPE_FUNC_DECL: {
+			ComoRegScope *scope = malloc(sizeof(ComoRegScope));
+			ast_node *parameters = p->u1.function_node.parameter_list;
+
+			scope->node = p;
+			scope->slots = newMap(8);
+
+			for(i = 0; i < parameters->u1.statements_node.count; i++) {
+				declare(scope->slots, AST_NODE_AS_ID(
+					parameters->u1.statements_node.statement_list[i]));
+			}
+			declare(scope->slots, "__FUNCTION__");
+
+			collect(scopes, globals, p->u1.function_node.body, scope->slots);
+
+			arrayPushEx(scopes, newPointer((void *)scope));
+			declare(globals, p->u1.function_node.name);
+		}
+		break;
+		default:
+		break;
+	}
+}
+
+size_t como_reg_emit(ComoRegFunction *fn, unsigned char op,
+	unsigned int dst, unsigned int a, unsigned int b, unsigned int c,
+	const char *name)
+{
+	ComoRegOp *ins;
+
+	if(fn->count == fn->capacity) {
+		fn->capacity = fn->capacity ? fn->capacity * 2 : 32;
+		fn->code = realloc(fn->code, sizeof(ComoRegOp) * fn->capacity);
+	}
+
+	ins = &fn->code[fn->count];
+	ins->op = op;
+	ins->type = REG_TYPE_NONE;
+	ins->dst = dst;
+	ins->a = a;
+	ins->b = b;
+	ins->c = c;
+	ins->name = name;
+
+	return fn->count++;
+}
+
+unsigned int como_reg_emit_args(ComoRegFunction *fn,
+	const unsigned int *regs, size_t count)
+{
+	size_t at = fn->nargs;
+
+	while(fn->nargs + count > fn->args_capacity) {
+		fn->args_capacity = fn->args_capacity ? fn->args_capacity * 2 : 16;
+		fn->args = realloc(fn->args, sizeof(unsigned int) * fn->args_capacity);
+	}
+
+	memcpy(fn->args + fn->nargs, regs, sizeof(unsigned int) * count);
+	fn->nargs += count;
+
+	return (unsigned int)at;
+}
+
+static size_t reg_emit(ComoRegCompiler *rc, unsigned char op,
+	unsigned int dst, unsigned int a, unsigned int b, unsigned int c,
+	const char *name)
+{
+	return como_reg_emit(rc->fn, op, dst, a, b, c, name);
+}
+
+static unsigned int new_temp(ComoRegCompiler *rc)
+{
+	unsigned int t = rc->temp++;
+
+	if(rc->temp > rc->fn->ntemps) {
+		rc->fn->ntemps = rc->temp;
+	}
+
+	return rc->fn->nslots + t;
+}
+
+static unsigned int add_constant(ComoRegCompiler *rc, Object *value)
+{
+	arrayPushEx(rc->constants, value);
+	return REG_CONSTANT | (unsigned int)(O_AVAL(rc->constants)->size - 1);
+}
+
+static unsigned int string_constant(ComoRegCompiler *rc, const char *value)
+{
+	Object *index = mapSearch(rc->strings, value);
+
+	if(index == NULL) {
+		index = newLong((long)add_constant(rc, newString(value)));
+		mapInsertEx(rc->strings, value, index);
+	}
+
+	return (unsigned int)O_LVAL(index);
+}
+
+static unsigned int slot_of(Object *slots, const char *name)
+{
+	Object *index = slots != NULL ? mapSearch(slots, name) : NULL;
+	return index != NULL ? (unsigned int)O_LVAL(index) : REG_NONE;
+}
+
+static int is_slot(ComoRegCompiler *rc, unsigned int reg)
+{
+	return reg != REG_NONE && !(reg & REG_CONSTANT) && reg < rc->fn->nslots;
+}
+
+/* Whether evaluating p can change a slot, through an assignment or a call */
+static int has_side_effects(ast_node *p)
+{
+	size_t i;
+
+	if(p == NULL) {
+		return 0;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_BIN_OP:
+			return p->u1.binary_node.type == AST_BINARY_OP_ASSIGN
+				|| has_side_effects(p->u1.binary_node.left)
+				|| has_side_effects(p->u1.binary_node.right);
+		case AST_NODE_TYPE_UNARY_OP:
+			return has_side_effects(p->u1.unary_node.expr);
+		case AST_NODE_TYPE_POSTFIX:
+		case AST_NODE_TYPE_PREFIX:
+		case AST_NODE_TYPE_CALL:
+			return 1;
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				if(has_side_effects(p->u1.statements_node.statement_list[i])) {
+					return 1;
+				}
+			}
+			return 0;
+		default:
+			return 0;
+	}
+}
+
+/* Binds the name of a POSTFIX node to a new long, one more or one less */
+static void compile_step(ComoRegCompiler *rc, ast_node *p)
+{
+	const char *name = AST_NODE_AS_ID(p->u1.postfix_node.expr);
+	unsigned int slot = slot_of(rc->slots, name);
+
+	reg_emit(rc, p->u1.postfix_node.type == AST_POSTFIX_OP_INC
+		? REG_INC : REG_DEC, slot, slot, 0, 0, name);
+}
+
+/* Moves reg into want, unless want is REG_NONE or already reg */
+static unsigned int reg_into(ComoRegCompiler *rc, unsigned int reg,
+	unsigned int want)
+{
+	if(want == REG_NONE || want == reg) {
+		return reg;
+	}
+
+	reg_emit(rc, REG_MOVE, want, reg, 0, 0, NULL);
+	return want;
+}
+
+static unsigned char binary_op(ast_binary_op_type type)
+{
+	switch(type) {
+		case AST_BINARY_OP_ADD:   return REG_ADD;
+		case AST_BINARY_OP_MINUS: return REG_SUB;
+		case AST_BINARY_OP_TIMES: return REG_MUL;
+		case AST_BINARY_OP_DIV:   return REG_DIV;
+		case AST_BINARY_OP_REM:   return REG_REM;
+		case AST_BINARY_OP_LT:    return REG_LT;
+		case AST_BINARY_OP_LTE:   return REG_LTE;
+		case AST_BINARY_OP_GT:    return REG_GT;
+		case AST_BINARY_OP_GTE:   return REG_GTE;
+		case AST_BINARY_OP_CMP:   return REG_EQ;
+		case AST_BINARY_OP_NEQ:   return REG_NEQ;
+		default:
+			como_error_noreturn("--engine register: unknown binary operator %d",
+				type);
+	}
+}
+
+/*
+ * Compiles an expression, returns the register holding its value. With
+ * want other than REG_NONE the value ends up in want. A name the function
+ * has a slot for is read in place, no instruction is needed for it.
+ *
+ * Temporaries are allocated like a stack: whatever an expression used
+ * is free again once its value has been consumed
+ */
+static unsigned int compile_expression(ComoRegCompiler *rc, ast_node *p,
+	unsigned int want)
+{
+	unsigned int mark = rc->temp, left, right, dst;
+	size_t i;
+
+	switch(p->type) {
+		case AST_NODE_TYPE_NUMBER:
+			return reg_into(rc, add_constant(rc, newLong(p->u1.number_value)),
+				want);
+		case AST_NODE_TYPE_STRING:
+			return reg_into(rc, string_constant(rc, p->u1.string_value.value),
+				want);
+		case AST_NODE_TYPE_ID: {
+			const char *name = AST_NODE_AS_ID(p);
+			unsigned int slot = slot_of(rc->slots, name);
+			unsigned int global = rc->slots == rc->globals ? REG_NONE
+				: slot_of(rc->globals, name);
+
+			if(slot != REG_NONE && global != REG_NONE) {
+				dst = want != REG_NONE ? want : new_temp(rc);
+				reg_emit(rc, REG_LOAD_LOCAL_OR_GLOBAL, dst, slot, global, 0, name);
+				return dst;
+			} else if(slot != REG_NONE) {
+				return reg_into(rc, slot, want);
+			}
+
+			dst = want != REG_NONE ? want : new_temp(rc);
+			reg_emit(rc, global != REG_NONE ? REG_LOAD_GLOBAL : REG_UNDEFINED,
+				dst, global, 0, 0, name);
+			return dst;
+		}
+		case AST_NODE_TYPE_UNARY_OP:
+			left = compile_expression(rc, p->u1.unary_node.expr, REG_NONE);
+			rc->temp = mark;
+			dst = want != REG_NONE ? want : new_temp(rc);
+			reg_emit(rc, REG_NEG, dst, left, 0, 0, NULL);
+		return dst;
+		case AST_NODE_TYPE_POSTFIX: {
+			const char *name = AST_NODE_AS_ID(p->u1.postfix_node.expr);
+			unsigned int slot = slot_of(rc->slots, name);
+			/* The value before, which i = i++ assigns back */
+			dst = want != REG_NONE && want != slot ? want : new_temp(rc);
+			reg_emit(rc, REG_MOVE, dst, slot, 0, 0, NULL);
+			compile_step(rc, p);
+			return reg_into(rc, dst, want);
+		}
+		case AST_NODE_TYPE_PREFIX:
+			/* The assignment it stands for, whose value is the name's */
+			return compile_expression(rc, p->u1.prefix_node.expr, want);
+		case AST_NODE_TYPE_BIN_OP:
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				unsigned int slot = slot_of(rc->slots,
+					AST_NODE_AS_ID(p->u1.binary_node.left));
+				compile_expression(rc, p->u1.binary_node.right, slot);
+				rc->temp = mark;
+				return reg_into(rc, slot, want);
+			}
+			left = compile_expression(rc, p->u1.binary_node.left, REG_NONE);
+			/*
+			 * The stack VM pushes the left operand before evaluating the
+			 * right one, which may assign to it
+			 */
+			if(is_slot(rc, left) && has_side_effects(p->u1.binary_node.right)) {
+				left = reg_into(rc, left, new_temp(rc));
+			}
+			right = compile_expression(rc, p->u1.binary_node.right, REG_NONE);
+			rc->temp = mark;
+			dst = want != REG_NONE ? want : new_temp(rc);
+			reg_emit(rc, binary_op(p->u1.binary_node.type), dst, left, right, 0,
+				NULL);
+		return dst;
+		case AST_NODE_TYPE_CALL: {
+			ast_node_statements *arguments =
+				&p->u1.call_node.arguments->u1.statements_node;
+			const char *name = AST_NODE_AS_ID(p->u1.call_node.id);
+			unsigned int *regs = malloc(sizeof(unsigned int)
+				* (arguments->count + 1));
+			unsigned int callee;
+
+			/*
+			 * A name is passed in place, unless a later argument may
+			 * assign to it before the call is made
+			 */
+			for(i = 0; i < arguments->count; i++) {
+				regs[i] = compile_expression(rc, arguments->statement_list[i],
+					REG_NONE);
+				if(is_slot(rc, regs[i])) {
+					size_t j;
+					for(j = i + 1; j < arguments->count; j++) {
+						if(has_side_effects(arguments->statement_list[j])) {
+							regs[i] = reg_into(rc, regs[i], new_temp(rc));
+							break;
+						}
+					}
+				}
+			}
+
+			callee = compile_expression(rc, p->u1.call_node.id, REG_NONE);
+			rc->temp = mark;
+			dst = want != REG_NONE ? want : new_temp(rc);
+			reg_emit(rc, REG_CALL, dst, callee,
+				como_reg_emit_args(rc->fn, regs, arguments->count),
+				(unsigned int)arguments->count, name);
+			free(regs);
+			return dst;
+		}
+		default:
+			como_error_noreturn("--engine register: node type %d isn't an "
+				"expression", p->type);
+	}
+}
+
+static void patch_jump(ComoRegCompiler *rc, size_t at, size_t target)
+{
+	ComoRegOp *ins = &rc->fn->code[at];
+
+	if(ins->op == REG_JMP) {
+		ins->a = (unsigned int)target;
+	} else {
+		ins->b = (unsigned int)target;
+	}
+}
+
+static void compile_statement(ComoRegCompiler *rc, ast_node *p);
+
+/*
+ * The value is compared with every label in turn, REG_JNZ going to the 
+ * body of the case on a match, and then REG_JMP to the default or past 
+ * the switch. The bodies follow, each jumping past the switch
+ */
+static void compile_switch(ComoRegCompiler *rc, ast_node *p)
+{
+	ast_node_statements *cases = &p->u1.switch_node.cases->u1.statements_node;
+	size_t *jumps = malloc(sizeof(size_t) * (cases->count + 1));
+	size_t *exits = malloc(sizeof(size_t) * (cases->count + 1));
+	size_t *targets = malloc(sizeof(size_t) * (cases->count + 1));
+	size_t count = 0, capacity = cases->count + 1, other, i, j;
+	long fallback = -1;
+	unsigned int value, cond;
+
+	value = compile_expression(rc, p->u1.switch_node.expr, REG_NONE);
+
+	for(i = 0; i < cases->count; i++) {
+		ast_node *labels = cases->statement_list[i]->u1.case_node.labels;
+
+		if(labels == NULL) {
+			fallback = (long)i;
+			continue;
+		}
+
+		for(j = 0; j < labels->u1.statements_node.count; j++) {
+			unsigned int mark = rc->temp;
+			unsigned int label = compile_expression(rc, 
+				labels->u1.statements_node.statement_list[j], REG_NONE);
+			cond = new_temp(rc);
+			reg_emit(rc, REG_EQ, cond, value, label, 0, NULL);
+			if(count == capacity) {
+				capacity *= 2;
+				jumps = realloc(jumps, sizeof(size_t) * capacity);
+				targets = realloc(targets, sizeof(size_t) * capacity);
+			}
+			targets[count] = i;
+			jumps[count++] = reg_emit(rc, REG_JNZ, 0, cond, 0, 0, NULL);
+			rc->temp = mark;
+		}
+	}
+
+	rc->temp = 0;
+	other = reg_emit(rc, REG_JMP, 0, 0, 0, 0, NULL);
+
+	for(i = 0; i < cases->count; i++) {
+		for(j = 0; j < count; j++) {
+			if(targets[j] == i) {
+				patch_jump(rc, jumps[j], rc->fn->count);
+			}
+		}
+		if(fallback == (long)i) {
+			patch_jump(rc, other, rc->fn->count);
+		}
+		compile_statement(rc, cases->statement_list[i]->u1.case_node.body);
+		exits[i] = reg_emit(rc, REG_JMP, 0, 0, 0, 0, NULL);
+	}
+
+	for(i = 0; i < cases->count; i++) {
+		patch_jump(rc, exits[i], rc->fn->count);
+	}
+	if(fallback < 0) {
+		patch_jump(rc, other, rc->fn->count);
+	}
+
+	free(jumps);
+	free(exits);
+	free(targets);
+}
+
+static void compile_statement(ComoRegCompiler *rc, ast_node *p)
+{
+	unsigned int cond;
+	size_t i, top, exit, skip;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				compile_statement(rc, p->u1.statements_node.statement_list[i]);
+			}
+		break;
+		/* Bound before the top level code runs, see como_reg_run */
+		case AST_NODE_TYPE_FUNC_DECL:
+		break;
+		case AST_NODE_TYPE_PRINT:
+			reg_emit(rc, REG_PRINT, 0,
+				compile_expression(rc, p->u1.print_node.expr, REG_NONE), 0, 0,
+				NULL);
+		break;
+		case AST_NODE_TYPE_RET:
+			if(p->u1.return_node.expr != NULL) {
+				reg_emit(rc, REG_RETURN, 0,
+					compile_expression(rc, p->u1.return_node.expr, REG_NONE), 0, 0,
+					NULL);
+			} else {
+				reg_emit(rc, REG_RETURN_NONE, 0, 0, 0, 0, NULL);
+			}
+		break;
+		case AST_NODE_TYPE_IF:
+			cond = compile_expression(rc, p->u1.if_node.condition, REG_NONE);
+			rc->temp = 0;
+			skip = reg_emit(rc, REG_JZ, 0, cond, 0, 0, NULL);
+			compile_statement(rc, p->u1.if_node.b1);
+			if(p->u1.if_node.b2 != NULL) {
+				exit = reg_emit(rc, REG_JMP, 0, 0, 0, 0, NULL);
+				patch_jump(rc, skip, rc->fn->count);
+				compile_statement(rc, p->u1.if_node.b2);
+				patch_jump(rc, exit, rc->fn->count);
+			} else {
+				patch_jump(rc, skip, rc->fn->count);
+			}
+		break;
+		case AST_NODE_TYPE_WHILE:
+			top = rc->fn->count;
+			cond = compile_expression(rc, p->u1.while_node.condition, REG_NONE);
+			rc->temp = 0;
+			exit = reg_emit(rc, REG_JZ, 0, cond, 0, 0, NULL);
+			compile_statement(rc, p->u1.while_node.body);
+			reg_emit(rc, REG_JMP, 0, (unsigned int)top, 0, 0, NULL);
+			patch_jump(rc, exit, rc->fn->count);
+		break;
+		case AST_NODE_TYPE_FOR:
+			compile_statement(rc, p->u1.for_node.initialization);
+			top = rc->fn->count;
+			cond = compile_expression(rc, p->u1.for_node.condition, REG_NONE);
+			rc->temp = 0;
+			exit = reg_emit(rc, REG_JZ, 0, cond, 0, 0, NULL);
+			compile_statement(rc, p->u1.for_node.body);
+			compile_statement(rc, p->u1.for_node.final_expression);
+			reg_emit(rc, REG_JMP, 0, (unsigned int)top, 0, 0, NULL);
+			patch_jump(rc, exit, rc->fn->count);
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			compile_switch(rc, p);
+		break;
+		/* i++; needs no copy of the value before */
+		case AST_NODE_TYPE_POSTFIX:
+			compile_step(rc, p);
+		break;
+		default:
+			compile_expression(rc, p, REG_NONE);
+		break;
+	}
+
+	rc->temp = 0;
+}
+
+/* Constants go after the temporaries, now that their number is known */
+static void reg_relocate(ComoRegFunction *fn)
+{
+	unsigned int base = fn->nslots + fn->ntemps;
+	size_t i;
+
+	for(i = 0; i < fn->count; i++) {
+		ComoRegOp *ins = &fn->code[i];
+		int fields = reg_fields(ins->op);
+
+		if((fields & REG_FIELD_DST) && (ins->dst & REG_CONSTANT)) {
+			ins->dst = base + (ins->dst & ~REG_CONSTANT);
+		}
+		if((fields & REG_FIELD_A) && (ins->a & REG_CONSTANT)) {
+			ins->a = base + (ins->a & ~REG_CONSTANT);
+		}
+		if((fields & REG_FIELD_B) && (ins->b & REG_CONSTANT)) {
+			ins->b = base + (ins->b & ~REG_CONSTANT);
+		}
+	}
+
+	for(i = 0; i < fn->nargs; i++) {
+		if(fn->args[i] & REG_CONSTANT) {
+			fn->args[i] = base + (fn->args[i] & ~REG_CONSTANT);
+		}
+	}
+}
+
+/* Sizes the register file of fn once all of its code is emitted */
+static void finish_function(ComoRegFunction *fn, Object *values)
+{
+	Array *constants = O_AVAL(values);
+	size_t i;
+
+	fn->nconstants = (unsigned int)constants->size;
+	fn->regs = calloc(fn->nslots + fn->ntemps + fn->nconstants + 1,
+		sizeof(Object *));
+
+	for(i = 0; i < constants->size; i++) {
+		fn->regs[fn->nslots + fn->ntemps + i] = constants->table[i];
+	}
+
+	reg_relocate(fn);
+}
+
+/*
+ * Compiles a function, or the top level code when slots are the top level
+ * ones. With --ssa it is only lowered, see generate_ssa
+ */
+static ComoRegFunction *compile_function(ComoRegCompiler *rc,
+	const char *name, Object *slots, ast_node *parameters, ast_node *body)
+{
+	ComoRegFunction *fn = calloc(1, sizeof(ComoRegFunction));
+	Map *map = O_MVAL(slots);
+	size_t i;
+
+	fn->name = strdup(name);
+	fn->name_value = newString(name);
+	fn->nslots = (unsigned int)map->size;
+	fn->names = calloc(fn->nslots + 1, sizeof(char *));
+
+	for(i = 0; i < map->capacity; i++) {
+		Bucket *b;
+		for(b = map->buckets[i]; b != NULL; b = b->next) {
+			fn->names[O_LVAL(b->value)] = b->key->value;
+		}
+	}
+
+	if(parameters != NULL) {
+		ast_node_statements *list = &parameters->u1.statements_node;
+		fn->parameters = list->count;
+		fn->parameter_regs = malloc(sizeof(unsigned int) * (list->count + 1));
+		for(i = 0; i < list->count; i++) {
+			fn->parameter_regs[i] = slot_of(slots,
+				AST_NODE_AS_ID(list->statement_list[i]));
+		}
+	}
+	fn->function_name_reg = slot_of(slots, "__FUNCTION__");
+
+	rc->fn = fn;
+	rc->slots = slots;
+	rc->constants = newArray(16);
+	rc->strings = newMap(16);
+	rc->temp = 0;
+
+	arrayPushEx(reg_functions, newPointer((void *)fn));
+
+	if(como_options.ssa) {
+		arrayPushEx(rc->ssa, newPointer((void *)como_ssa_lower(fn, slots,
+			rc->globals, slots == rc->globals, body, rc->constants)));
+	} else {
+		compile_statement(rc, body);
+		reg_emit(rc, REG_RETURN_NONE, 0, 0, 0, 0, NULL);
+		finish_function(fn, rc->constants);
+	}
+
+	objectDestroy(rc->strings);
+
+	return fn;
+}
+
+/*
+ * Types are inferred across the whole program, then the code of every
+ * function is generated from its SSA form
+ */
+static void generate_ssa(ComoRegCompiler *rc)
+{
+	Array *list = O_AVAL(rc->ssa);
+	ComoSsaFunction **functions = malloc(sizeof(ComoSsaFunction *)
+		* (list->size + 1));
+	uint64_t start;
+	size_t i;
+
+	for(i = 0; i < list->size; i++) {
+		functions[i] = (ComoSsaFunction *)O_PTVAL(list->table[i]);
+	}
+
+	como_ssa_infer_types(functions, list->size);
+
+	for(i = 0; i < list->size; i++) {
+		como_ssa_forward_loads(functions[i]);
+	}
+
+	if(como_pass_enabled(COMO_PASS_SSA_EVALUATE)) {
+		start = como_pass_clock();
+		como_ssa_evaluate(functions, list->size);
+		como_pass_record(COMO_PASS_SSA_EVALUATE, start, 0);
+	}
+
+	if(como_pass_enabled(COMO_PASS_SSA_INLINE)) {
+		start = como_pass_clock();
+		como_ssa_inline(functions, list->size);
+		como_pass_record(COMO_PASS_SSA_INLINE, start, 0);
+	}
+
+	/* Whether a call is pure depends on its callee, freed below */
+	for(i = 0; i < list->size; i++) {
+		como_ssa_forward_loads(functions[i]);
+		if(como_pass_enabled(COMO_PASS_SSA_LICM)) {
+			start = como_pass_clock();
+			como_ssa_hoist(functions[i]);
+			como_pass_record(COMO_PASS_SSA_LICM, start, 0);
+		}
+		if(como_options.ssa_dump) {
+			como_ssa_dump(functions[i]);
+		}
+	}
+
+	for(i = 0; i < list->size; i++) {
+		como_ssa_codegen(functions[i]);
+		finish_function(functions[i]->reg, functions[i]->constants);
+		como_ssa_free(functions[i]);
+	}
+
+	free(functions);
+}
+
+static Object *como_reg_undefined(ComoRegFunction *fn, unsigned int reg)
+{
+	como_rt_undefined(reg < fn->nslots ? fn->names[reg] : "?");
+}
+
+/* A slot may not have been assigned yet, nothing else can be NULL */
+#define READ(reg) \
+	(regs[(reg)] != NULL ? regs[(reg)] : como_reg_undefined(fn, (reg)))
+
+#define REG_BINARY_LONG(op, result, fallback) \
+	case op: { \
+		Object *left = READ(ins->a), *right = READ(ins->b); \
+		if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) { \
+			long l = O_LVAL(left), r = O_LVAL(right); \
+			regs[ins->dst] = newLong(result); \
+		} else { \
+			regs[ins->dst] = fallback(left, right); \
+		} \
+		break; \
+	}
+
+/* Operands --ssa proved to be longs, so set too */
+#define REG_LONG(op, result) \
+	case op: { \
+		long l = O_LVAL(regs[ins->a]), r = O_LVAL(regs[ins->b]); \
+		regs[ins->dst] = como_reg_long(fn, ins, result); \
+		break; \
+	}
+
+/* The result of a *_LONG op, in its scratch long if it has one */
+static Object *como_reg_long(ComoRegFunction *fn, ComoRegOp *ins, long value)
+{
+	if(ins->c == REG_NONE) {
+		return newLong(value);
+	}
+
+	O_LVAL(fn->scratch[ins->c]) = value;
+
+	return fn->scratch[ins->c];
+}
+
+static long como_reg_division_by_zero(void)
+{
+	como_error_noreturn("division by zero");
+}
+
+static Object *como_reg_execute(ComoRegFunction *fn);
+
+static Object *como_reg_call(ComoRegFunction *fn, ComoRegOp *ins)
+{
+	Object **regs = fn->regs;
+	Object *callee = READ(ins->a), *result;
+	Object *args[ins->c + 1];
+	ComoRegFunction *target;
+	size_t i;
+
+	if(O_TYPE(callee) != IS_POINTER) {
+		como_error_noreturn("name '%s' is not callable", ins->name);
+	}
+
+	target = (ComoRegFunction *)O_PTVAL(callee);
+
+	if(ins->c != target->parameters) {
+		como_error_noreturn("callable '%s' expects %ld arguments, "
+			"but %ld were given", ins->name, (long)target->parameters,
+			(long)ins->c);
+	}
+
+	/* Read before binding, a recursive call binds into the same slots */
+	for(i = 0; i < ins->c; i++) {
+		args[i] = READ(fn->args[ins->b + i]);
+	}
+
+	/*
+	 * A recursive call shares the slots, but not the temporaries of the
+	 * activation it was made from
+	 */
+	Object *saved[target->active > 0 ? target->ntemps + 1 : 1];
+
+	if(target->active > 0) {
+		memcpy(saved, &target->regs[target->nslots],
+			sizeof(Object *) * target->ntemps);
+	}
+
+	/* CALL_FUNCTION binds the last argument first */
+	for(i = ins->c; i-- > 0; ) {
+		target->regs[target->parameter_regs[i]] = args[i];
+	}
+	target->regs[target->function_name_reg] = target->name_value;
+
+	target->active++;
+	target->calls++;
+	result = como_reg_execute(target);
+	target->active--;
+
+	if(target->active > 0) {
+		memcpy(&target->regs[target->nslots], saved,
+			sizeof(Object *) * target->ntemps);
+	}
+
+	return result;
+}
+
+static Object *como_reg_execute(ComoRegFunction *fn)
+{
+	Object **regs = fn->regs;
+	ComoRegOp *code = fn->code;
+	size_t pc = 0;
+
+	for(;;) {
+		ComoRegOp *ins = &code[pc++];
+
+		fn->executed++;
+
+		switch(ins->op) {
+			case REG_MOVE:
+				regs[ins->dst] = READ(ins->a);
+			break;
+			case REG_LOAD_GLOBAL: {
+				Object *value = reg_main->regs[ins->a];
+				regs[ins->dst] = value != NULL ? value
+					: como_rt_undefined(ins->name);
+				break;
+			}
+			case REG_LOAD_LOCAL_OR_GLOBAL: {
+				Object *value = regs[ins->a];
+				if(value == NULL) {
+					value = reg_main->regs[ins->b];
+				}
+				regs[ins->dst] = value != NULL ? value
+					: como_rt_undefined(ins->name);
+				break;
+			}
+			case REG_UNDEFINED:
+				como_rt_undefined(ins->name);
+			break;
+			REG_BINARY_LONG(REG_ADD, l + r, como_rt_add)
+			REG_BINARY_LONG(REG_SUB, l - r, como_rt_minus)
+			REG_BINARY_LONG(REG_MUL, l * r, como_rt_times)
+			REG_BINARY_LONG(REG_LT, (long)(l < r), como_rt_is_less_than)
+			REG_BINARY_LONG(REG_LTE, (long)(l <= r),
+				como_rt_is_less_than_or_equal)
+			REG_BINARY_LONG(REG_GT, (long)(l > r), como_rt_is_greater_than)
+			REG_BINARY_LONG(REG_GTE, (long)(l >= r),
+				como_rt_is_greater_than_or_equal)
+			REG_BINARY_LONG(REG_EQ, (long)(l == r), como_rt_is_equal)
+			REG_BINARY_LONG(REG_NEQ, (long)(l != r), como_rt_is_not_equal)
+			case REG_DIV:
+				regs[ins->dst] = como_rt_div(READ(ins->a), READ(ins->b));
+			break;
+			case REG_REM:
+				regs[ins->dst] = como_rt_rem(READ(ins->a), READ(ins->b));
+			break;
+			case REG_NEG:
+				regs[ins->dst] = como_rt_unary_minus(READ(ins->a));
+			break;
+			case REG_INC:
+				regs[ins->dst] = como_rt_step(regs[ins->a], 1, ins->name);
+			break;
+			case REG_DEC:
+				regs[ins->dst] = como_rt_step(regs[ins->a], -1, ins->name);
+			break;
+			case REG_JMP:
+				pc = ins->a;
+			break;
+			case REG_JZ:
+				if(como_rt_is_false(READ(ins->a))) {
+					pc = ins->b;
+				}
+			break;
+			case REG_CALL: {
+				Object *result = como_reg_call(fn, ins);
+				regs[ins->dst] = result;
+				break;
+			}
+			case REG_RETURN:
+				return READ(ins->a);
+			case REG_RETURN_NONE:
+				return newLong(0L);
+			case REG_PRINT:
+				como_rt_print(READ(ins->a));
+			break;
+			case REG_COPY:
+				regs[ins->dst] = regs[ins->a];
+			break;
+			case REG_CHECK:
+				if(regs[ins->a] == NULL) {
+					como_rt_undefined(ins->name);
+				}
+			break;
+			REG_LONG(REG_ADD_LONG, l + r)
+			REG_LONG(REG_SUB_LONG, l - r)
+			REG_LONG(REG_MUL_LONG, l * r)
+			REG_LONG(REG_DIV_LONG, r != 0 ? l / r : como_reg_division_by_zero())
+			REG_LONG(REG_REM_LONG, r != 0 ? l % r : como_reg_division_by_zero())
+			REG_LONG(REG_LT_LONG, (long)(l < r))
+			REG_LONG(REG_LTE_LONG, (long)(l <= r))
+			REG_LONG(REG_GT_LONG, (long)(l > r))
+			REG_LONG(REG_GTE_LONG, (long)(l >= r))
+			REG_LONG(REG_EQ_LONG, (long)(l == r))
+			REG_LONG(REG_NEQ_LONG, (long)(l != r))
+			case REG_NEG_LONG:
+				regs[ins->dst] = como_reg_long(fn, ins, -O_LVAL(regs[ins->a]));
+			break;
+			case REG_JZ_LONG:
+				if(O_LVAL(regs[ins->a]) == 0) {
+					pc = ins->b;
+				}
+			break;
+			case REG_CONCAT:
+				regs[ins->dst] = como_rt_concat(regs[ins->a], regs[ins->b]);
+			break;
+			case REG_JNZ:
+				if(!como_rt_is_false(READ(ins->a))) {
+					pc = ins->b;
+				}
+			break;
+			case REG_JNZ_LONG:
+				if(O_LVAL(regs[ins->a]) != 0) {
+					pc = ins->b;
+				}
+			break;
+			default:
+				como_error_noreturn("Invalid register OpCode got %d", ins->op);
+		}
+	}
+}
+
+static void como_reg_print_operand(ComoRegFunction *fn, unsigned int reg)
+{
+	if(reg < fn->nslots) {
+		fprintf(stderr, " %s", fn->names[reg]);
+	} else if(reg < fn->nslots + fn->ntemps) {
+		fprintf(stderr, " t%u", reg - fn->nslots);
+	} else {
+		char *value = objectToString(fn->regs[reg]);
+		fprintf(stderr, O_TYPE(fn->regs[reg]) == IS_STRING ? " \"%s\"" : " %s",
+			value);
+		free(value);
+	}
+}
+
+static const char *reg_type_name(unsigned char type)
+{
+	switch(type) {
+		case REG_TYPE_LONG:
+			return "long";
+		case REG_TYPE_STRING:
+			return "string";
+		case REG_TYPE_ANY:
+			return "any";
+	}
+	return "?";
+}
+
+static void como_reg_dump(ComoRegFunction *fn)
+{
+	size_t i;
+
+	fprintf(stderr, "%s: %u slots, %u temporaries, %u constants, "
+		"%u scratch\n", fn->name, fn->nslots, fn->ntemps, fn->nconstants,
+		fn->nscratch);
+
+	for(i = 0; i < fn->count; i++) {
+		ComoRegOp *ins = &fn->code[i];
+		int fields = reg_fields(ins->op);
+
+		fprintf(stderr, "%5zu  %-26s", i, como_reg_opcode_name(ins->op));
+
+		if(fields & REG_FIELD_DST) {
+			como_reg_print_operand(fn, ins->dst);
+			fprintf(stderr, " <-");
+		}
+		if(fields & REG_FIELD_A) {
+			como_reg_print_operand(fn, ins->a);
+		}
+		if(fields & REG_FIELD_B) {
+			como_reg_print_operand(fn, ins->b);
+		}
+
+		switch(ins->op) {
+			case REG_JMP:
+				fprintf(stderr, " %u", ins->a);
+			break;
+			case REG_JZ:
+			case REG_JZ_LONG:
+			case REG_JNZ:
+			case REG_JNZ_LONG:
+				fprintf(stderr, " %u", ins->b);
+			break;
+			case REG_LOAD_GLOBAL:
+			case REG_UNDEFINED:
+				fprintf(stderr, " %s", ins->name);
+			break;
+			case REG_CALL: {
+				unsigned int j;
+				fprintf(stderr, " (");
+				for(j = 0; j < ins->c; j++) {
+					como_reg_print_operand(fn, fn->args[ins->b + j]);
+				}
+				fprintf(stderr, " )");
+				break;
+			}
+			case REG_CHECK:
+				fprintf(stderr, " %s", ins->name);
+			break;
+			default:
+				if(ins->op >= REG_ADD_LONG && ins->op <= REG_NEG_LONG
+						&& ins->c != REG_NONE) {
+					fprintf(stderr, " in s%u", ins->c);
+				}
+			break;
+		}
+
+		if(como_options.dump_types && (fields & REG_FIELD_DST)
+				&& ins->op != REG_UNDEFINED) {
+			fprintf(stderr, "  ; %s", reg_type_name(ins->type));
+		}
+
+		fputc('\n', stderr);
+	}
+
+	fputc('\n', stderr);
+}
+
+static void como_reg_print_stats(void)
+{
+	Array *functions = O_AVAL(reg_functions);
+	size_t i, instructions = 0, executed = 0;
+
+	fprintf(stderr, "%-24s %12s %10s %10s %14s\n", "function", "instructions",
+		"registers", "calls", "executed");
+
+	for(i = 0; i < functions->size; i++) {
+		ComoRegFunction *fn = (ComoRegFunction *)O_PTVAL(functions->table[i]);
+		fprintf(stderr, "%-24s %12zu %10u %10zu %14zu\n", fn->name, fn->count,
+			fn->nslots + fn->ntemps + fn->nconstants, fn->calls, fn->executed);
+		instructions += fn->count;
+		executed += fn->executed;
+	}
+
+	fprintf(stderr, "register: %zu instructions, %zu executed\n",
+		instructions, executed);
+}
+
+int como_reg_run(ast_node *program)
+{
+	ComoRegCompiler rc;
+	Object *scopes = newArray(8);
+	Object *globals = newMap(16);
+	Array *list, *functions;
+	size_t i;
+
+	reg_functions = newArray(8);
+
+	declare(globals, "__FUNCTION__");
+	collect(scopes, globals, program, globals);
+
+	rc.globals = globals;
+	rc.ssa = newArray(8);
+	list = O_AVAL(scopes);
+
+	for(i = 0; i < list->size; i++) {
+		ComoRegScope *scope = (ComoRegScope *)O_PTVAL(list->table[i]);
+		ast_node *p = scope->node;
+		compile_function(&rc, p->u1.function_node.name, scope->slots,
+			p->u1.function_node.parameter_list, p->u1.function_node.body);
+	}
+
+	reg_main = compile_function(&rc, "__main__", globals, NULL, program);
+
+	if(como_options.ssa) {
+		generate_ssa(&rc);
+	}
+
+	reg_main->regs[reg_main->function_name_reg] = reg_main->name_value;
+
+	/* Bound before the top level code runs, in the order they were found */
+	functions = O_AVAL(reg_functions);
+	for(i = 0; i < list->size; i++) {
+		ComoRegScope *scope = (ComoRegScope *)O_PTVAL(list->table[i]);
+		reg_main->regs[slot_of(globals, scope->node->u1.function_node.name)] =
+			functions->table[i];
+		free(scope);
+	}
+
+	if(como_options.register_dump) {
+		for(i = 0; i < functions->size; i++) {
+			como_reg_dump((ComoRegFunction *)O_PTVAL(functions->table[i]));
+		}
+	}
+
+	reg_main->active++;
+	reg_main->calls++;
+	como_reg_execute(reg_main);
+	reg_main->active--;
+
+	if(como_options.register_stats) {
+		como_reg_print_stats();
+	}
+
+	objectDestroy(scopes);
+	objectDestroy(rc.ssa);
+
+	return 0;
+}
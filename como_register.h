@@ -0,0 +1,148 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMO_REGISTER_H
+#define COMO_REGISTER_H
+
+#include <stddef.h>
+#include <object.h>
+
+#include "ast.h"
+
+/*
+ * Register bytecode, run by --engine register. Every instruction names
+ * its operands and its result directly as registers of the function:
+ *
+ *   [ slots | temporaries | constants ]
+ *
+ * A slot is a name the function assigns or receives as a parameter. Like
+ * the symbol table of a ComoFrame, slots outlive a call, the temporaries
+ * are saved around a recursive call instead. Constants are filled in
+ * once, when the function is compiled. The top level code is a function
+ * too, __main__, and its slots are the top level names.
+ */
+#define REG_MOVE                  0x01  /* dst = a */
+#define REG_LOAD_GLOBAL           0x02  /* dst = top level slot a */
+#define REG_LOAD_LOCAL_OR_GLOBAL  0x03  /* dst = a if set, else top level b */
+#define REG_UNDEFINED             0x04  /* name isn't defined anywhere */
+#define REG_ADD                   0x05  /* dst = a + b */
+#define REG_SUB                   0x06
+#define REG_MUL                   0x07
+#define REG_DIV                   0x08
+#define REG_REM                   0x09
+#define REG_LT                    0x0a
+#define REG_LTE                   0x0b
+#define REG_GT                    0x0c
+#define REG_GTE                   0x0d
+#define REG_EQ                    0x0e
+#define REG_NEQ                   0x0f
+#define REG_NEG                   0x10  /* dst = -a */
+#define REG_INC                   0x11  /* dst = a + 1, a new long */
+#define REG_DEC                   0x12
+#define REG_JMP                   0x13  /* pc = a */
+#define REG_JZ                    0x14  /* pc = b if a is false */
+#define REG_CALL                  0x15  /* dst = a(args[b], ..., args[b + c - 1]) */
+#define REG_RETURN                0x16  /* return a */
+#define REG_RETURN_NONE           0x17
+#define REG_PRINT                 0x18  /* print a */
+#define REG_COPY                  0x19  /* dst = a, which may not be set yet */
+#define REG_CHECK                 0x1a  /* a must be set */
+
+/*
+ * Where --ssa proves both operands are longs, or both strings, these run
+ * without checking them. The binary ones are in the order of REG_ADD ...
+ * REG_NEQ. Unless c is REG_NONE, the long ones set scratch long c of the
+ * function and return it, instead of a new long
+ */
+#define REG_ADD_LONG              0x1b
+#define REG_SUB_LONG              0x1c
+#define REG_MUL_LONG              0x1d
+#define REG_DIV_LONG              0x1e
+#define REG_REM_LONG              0x1f
+#define REG_LT_LONG               0x20
+#define REG_LTE_LONG              0x21
+#define REG_GT_LONG               0x22
+#define REG_GTE_LONG              0x23
+#define REG_EQ_LONG               0x24
+#define REG_NEQ_LONG              0x25
+#define REG_NEG_LONG              0x26
+#define REG_JZ_LONG               0x27  /* pc = b if a is 0 */
+#define REG_CONCAT                0x28  /* dst = a + b, both strings */
+
+/* The test at the bottom of a rotated loop, back to its top */
+#define REG_JNZ                   0x29  /* pc = b if a is true */
+#define REG_JNZ_LONG              0x2a  /* pc = b if a isn't 0 */
+
+/* No register, and the tag of a constant until it has its register */
+#define REG_NONE                  0xffffffffU
+#define REG_CONSTANT              0x80000000U
+
+/* What --ssa infers a register to hold, for --dump-types */
+#define REG_TYPE_NONE             0x00  /* nothing reaches it */
+#define REG_TYPE_LONG             0x01
+#define REG_TYPE_STRING           0x02
+#define REG_TYPE_ANY              0x03
+
+typedef struct ComoRegOp {
+	unsigned char   op;
+	unsigned char   type;            /* of dst, REG_TYPE_* */
+	unsigned int    dst;
+	unsigned int    a;
+	unsigned int    b;
+	unsigned int    c;
+	const char     *name;            /* the name CALL, INC, DEC and loads use */
+} ComoRegOp;
+
+typedef struct ComoRegFunction {
+	char           *name;
+	Object         *name_value;       /* __FUNCTION__ */
+	size_t          parameters;
+	unsigned int   *parameter_regs;
+	unsigned int    function_name_reg;
+	ComoRegOp      *code;
+	size_t          count;
+	size_t          capacity;
+	unsigned int   *args;             /* argument registers of every CALL */
+	size_t          nargs;
+	size_t          args_capacity;
+	Object        **regs;
+	char          **names;            /* name of each slot */
+	unsigned int    nslots;
+	unsigned int    ntemps;
+	unsigned int    nconstants;
+	Object        **scratch;          /* longs *_LONG ops write in place */
+	unsigned int    nscratch;
+	long            active;           /* activations currently running */
+	size_t          calls;
+	size_t          executed;
+} ComoRegFunction;
+
+/* Compiles program to register bytecode and runs it */
+extern int como_reg_run(ast_node *program);
+
+/* Appends an instruction to fn, returns its pc */
+extern size_t como_reg_emit(ComoRegFunction *fn, unsigned char op,
+	unsigned int dst, unsigned int a, unsigned int b, unsigned int c,
+	const char *name);
+
+/* Appends the argument registers of a CALL, returns where they start */
+extern unsigned int como_reg_emit_args(ComoRegFunction *fn,
+	const unsigned int *regs, size_t count);
+
+extern const char *como_reg_opcode_name(unsigned char op);
+
+#endif /* !COMO_REGISTER_H */
@@ -0,0 +1,310 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "comodebug.h"
+#include "como_runtime.h"
+#include "como_opcode.h"
+
+#define LONG_OPERANDS(op) do { \
+	if(O_TYPE(left) != IS_LONG || O_TYPE(right) != IS_LONG) { \
+		como_error_noreturn("unsupported values for " #op); \
+	} \
+} while(0)
+
+/* 
+ * A string this long, the NUL included, or shorter is put together in a 
+ * buffer on the stack before newString copies it, rather than in one of
+ * its own on the heap. A long always fits
+ */
+#define COMO_RT_SHORT_STRING 24
+
+/* 
+ * The characters value is added as, formatted into buffer if it is a long,
+ * else in a copy returned in owned as well, which the caller frees. A
+ * string's own are used in place
+ */
+static const char *como_rt_text(Object *value, char *buffer, size_t *length,
+	char **owned)
+{
+	*owned = NULL;
+
+	if(O_TYPE(value) == IS_STRING) {
+		*length = O_SVAL(value)->length;
+		return O_SVAL(value)->value;
+	}
+
+	if(O_TYPE(value) == IS_LONG) {
+		*length = (size_t)snprintf(buffer, COMO_RT_SHORT_STRING, "%ld",
+			O_LVAL(value));
+		return buffer;
+	}
+
+	*owned = objectToStringLength(value, length);
+	return *owned;
+}
+
+static Object *como_rt_join(const char *left, size_t left_length,
+	const char *right, size_t right_length)
+{
+	char short_string[COMO_RT_SHORT_STRING];
+	size_t length = left_length + right_length;
+	char *buffer = length < COMO_RT_SHORT_STRING ? short_string
+		: malloc(length + 1);
+	Object *value;
+
+	memcpy(buffer, left, left_length);
+	memcpy(buffer + left_length, right, right_length);
+	buffer[length] = '\0';
+
+	value = newString(buffer);
+
+	if(buffer != short_string) {
+		free(buffer);
+	}
+
+	return value;
+}
+
+Object *como_rt_add(Object *left, Object *right)
+{
+	char left_buffer[COMO_RT_SHORT_STRING], right_buffer[COMO_RT_SHORT_STRING];
+	const char *left_text, *right_text;
+	size_t left_length, right_length;
+	char *left_owned, *right_owned;
+	Object *value;
+
+	if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) {
+		return newLong(O_LVAL(left) + O_LVAL(right));
+	}
+
+	left_text = como_rt_text(left, left_buffer, &left_length, &left_owned);
+	right_text = como_rt_text(right, right_buffer, &right_length, &right_owned);
+	value = como_rt_join(left_text, left_length, right_text, right_length);
+	free(left_owned);
+	free(right_owned);
+
+	return value;
+}
+
+Object *como_rt_concat(Object *left, Object *right)
+{
+	return como_rt_join(O_SVAL(left)->value, O_SVAL(left)->length,
+		O_SVAL(right)->value, O_SVAL(right)->length);
+}
+
+int como_rt_string_equals(Object *left, Object *right)
+{
+	/* String constants are interned, often it is the same object */
+	if(left == right) {
+		return 1;
+	}
+
+	return O_SVAL(left)->length == O_SVAL(right)->length
+		&& memcmp(O_SVAL(left)->value, O_SVAL(right)->value,
+			O_SVAL(left)->length) == 0;
+}
+
+/* Longs and strings by their own fields, anything else by libobject */
+static int como_rt_equals(Object *left, Object *right)
+{
+	if(O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG) {
+		return O_LVAL(left) == O_LVAL(right);
+	}
+
+	if(O_TYPE(left) == IS_STRING && O_TYPE(right) == IS_STRING) {
+		return como_rt_string_equals(left, right);
+	}
+
+	return objectValueCompare(left, right);
+}
+
+Object *como_rt_minus(Object *left, Object *right)
+{
+	LONG_OPERANDS(IMINUS);
+	return newLong(O_LVAL(left) - O_LVAL(right));
+}
+
+Object *como_rt_times(Object *left, Object *right)
+{
+	LONG_OPERANDS(ITIMES);
+	return newLong(O_LVAL(left) * O_LVAL(right));
+}
+
+Object *como_rt_div(Object *left, Object *right)
+{
+	LONG_OPERANDS(IDIV);
+	if(O_LVAL(right) == 0) {
+		como_error_noreturn("division by zero");
+	}
+	return newLong(O_LVAL(left) / O_LVAL(right));
+}
+
+Object *como_rt_rem(Object *left, Object *right)
+{
+	LONG_OPERANDS(IREM);
+	if(O_LVAL(right) == 0) {
+		como_error_noreturn("division by zero");
+	}
+	return newLong(O_LVAL(left) % O_LVAL(right));
+}
+
+Object *como_rt_is_less_than(Object *left, Object *right)
+{
+	return newLong((long)objectValueIsLessThan(left, right));
+}
+
+Object *como_rt_is_less_than_or_equal(Object *left, Object *right)
+{
+	return newLong((long)(objectValueCompare(left, right)
+		|| objectValueIsLessThan(left, right)));
+}
+
+Object *como_rt_is_greater_than(Object *left, Object *right)
+{
+	return newLong((long)objectValueIsGreaterThan(left, right));
+}
+
+Object *como_rt_is_greater_than_or_equal(Object *left, Object *right)
+{
+	return newLong((long)(objectValueCompare(left, right)
+		|| objectValueIsGreaterThan(left, right)));
+}
+
+Object *como_rt_is_equal(Object *left, Object *right)
+{
+	return newLong((long)como_rt_equals(left, right));
+}
+
+Object *como_rt_is_not_equal(Object *left, Object *right)
+{
+	return newLong((long)!como_rt_equals(left, right));
+}
+
+Object *como_rt_unary_minus(Object *value)
+{
+	if(O_TYPE(value) != IS_LONG) {
+		como_error_noreturn("unsupported value for UNARY_MINUS");
+	}
+	return newLong(-O_LVAL(value));
+}
+
+Object *como_rt_step(Object *value, long delta, const char *name)
+{
+	if(value == NULL) {
+		como_rt_undefined(name);
+	}
+
+	if(O_TYPE(value) != IS_LONG) {
+		como_error_noreturn("unsupported value for %s",
+			delta > 0 ? "POSTFIX_INC" : "POSTFIX_DEC");
+	}
+
+	return newLong(O_LVAL(value) + delta);
+}
+
+void como_rt_print(Object *value)
+{
+	size_t len = 0;
+	char *sval = objectToStringLength(value, &len);
+	fprintf(stdout, "%s\n", sval);
+	fflush(stdout);
+	free(sval);
+}
+
+/* 
+ * Long labels are looked up by index when there is a SWITCH_DENSE table, 
+ * by binary search otherwise, string labels by hash
+ */
+long como_rt_switch(Object *table, Object *value)
+{
+	Object **fields = O_AVAL(table)->table;
+
+	if(O_TYPE(value) == IS_LONG) {
+		Array *dense = O_AVAL(fields[SWITCH_DENSE]);
+		Array *keys = O_AVAL(fields[SWITCH_KEYS]);
+		long key = O_LVAL(value);
+		size_t low = 0, high = keys->size;
+
+		if(dense->size > 0) {
+			unsigned long index = (unsigned long)key
+				- (unsigned long)O_LVAL(fields[SWITCH_MIN]);
+			return index < dense->size ? O_LVAL(dense->table[index]) : -1;
+		}
+
+		while(low < high) {
+			size_t middle = low + (high - low) / 2;
+			long at = O_LVAL(keys->table[middle]);
+			if(at == key) {
+				return O_LVAL(O_AVAL(fields[SWITCH_CASES])->table[middle]);
+			} else if(at < key) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+	} else if(O_TYPE(value) == IS_STRING) {
+		Object *found = mapSearch(fields[SWITCH_STRINGS],
+			O_SVAL(value)->value);
+		if(found != NULL) {
+			return O_LVAL(found);
+		}
+	}
+
+	return -1;
+}
+
+Object *como_rt_undefined(const char *name)
+{
+	como_error_noreturn("undefined variable '%s'", name);
+}
+
+Object *como_rt_function(const char *name, size_t parameters,
+	como_rt_function_t fn)
+{
+	ComoRtFunction *function = malloc(sizeof(ComoRtFunction));
+
+	function->name = name;
+	function->parameters = parameters;
+	function->fn = fn;
+
+	return newPointer((void *)function);
+}
+
+Object *como_rt_call(Object *callee, const char *name, size_t argc,
+	Object **args)
+{
+	ComoRtFunction *function;
+
+	if(O_TYPE(callee) != IS_POINTER) {
+		como_error_noreturn("name '%s' is not callable", name);
+	}
+
+	function = (ComoRtFunction *)O_PTVAL(callee);
+
+	if(argc != function->parameters) {
+		como_error_noreturn("callable '%s' expects %ld arguments, "
+			"but %ld were given", name, (long)function->parameters,
+			(long)argc);
+	}
+
+	return function->fn(args);
+}
@@ -0,0 +1,98 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMO_RUNTIME_H
+#define COMO_RUNTIME_H
+
+#include <stddef.h>
+#include <object.h>
+
+/*
+ * Value semantics shared by como_execute and by the C emitted with
+ * --emit-c. Programs compiled ahead of time link against
+ * libcomo_runtime.a and libobject.
+ *
+ * Values are shared: assigning, passing or returning one never copies it,
+ * so none of these functions changes a value it is given, each returns a
+ * new one. Only a long nothing else can refer to is ever updated in place,
+ * see COMO_OWNED in como_compiler_ex.h
+ */
+
+/* JZ jumps on a long zero, every other value is true */
+static inline int como_rt_is_false(Object *value)
+{
+	return O_TYPE(value) == IS_LONG && O_LVAL(value) == 0;
+}
+
+extern Object *como_rt_add(Object *left, Object *right);
+extern Object *como_rt_minus(Object *left, Object *right);
+extern Object *como_rt_times(Object *left, Object *right);
+extern Object *como_rt_div(Object *left, Object *right);
+extern Object *como_rt_rem(Object *left, Object *right);
+extern Object *como_rt_is_less_than(Object *left, Object *right);
+extern Object *como_rt_is_less_than_or_equal(Object *left, Object *right);
+extern Object *como_rt_is_greater_than(Object *left, Object *right);
+extern Object *como_rt_is_greater_than_or_equal(Object *left, Object *right);
+extern Object *como_rt_is_equal(Object *left, Object *right);
+extern Object *como_rt_is_not_equal(Object *left, Object *right);
+extern Object *como_rt_unary_minus(Object *value);
+
+/* 
+ * IADD and IS_EQUAL of two strings, by their lengths and characters. A
+ * short result is put together without a buffer of its own on the heap
+ */
+extern Object *como_rt_concat(Object *left, Object *right);
+extern int como_rt_string_equals(Object *left, Object *right);
+
+/*
+ * POSTFIX_INC and POSTFIX_DEC, value is the variable's current value or
+ * NULL if it isn't defined. Returns the value to bind to it instead, a new
+ * long: value itself may be bound to other names as well, and is left as
+ * it is
+ */
+extern Object *como_rt_step(Object *value, long delta, const char *name);
+
+extern void como_rt_print(Object *value);
+
+/* 
+ * The case a switch on value takes, from the operand of a SWITCH, see 
+ * como_opcode.h. Returns -1 if no case has value as a label
+ */
+extern long como_rt_switch(Object *table, Object *value);
+
+extern Object *como_rt_undefined(const char *name)
+	__attribute__ ((noreturn));
+
+/*
+ * Functions of an ahead of time compiled program, bound to their names as
+ * a pointer to a ComoRtFunction
+ */
+typedef Object *(*como_rt_function_t)(Object **args);
+
+typedef struct ComoRtFunction {
+	const char         *name;
+	size_t              parameters;
+	como_rt_function_t  fn;
+} ComoRtFunction;
+
+extern Object *como_rt_function(const char *name, size_t parameters,
+	como_rt_function_t fn);
+
+extern Object *como_rt_call(Object *callee, const char *name, size_t argc,
+	Object **args);
+
+#endif /* !COMO_RUNTIME_H */
@@ -0,0 +1,1410 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "ast.h"
+#include "comodebug.h"
+#include "como_register.h"
+#include "como_ssa.h"
+#include "como_compiler_ex.h"
+
+/*
+ * Lowering to SSA form follows Braun et al., "Simple and Efficient
+ * Construction of Static Single Assignment Form": the value of a slot is
+ * looked up backwards from the block reading it, and a phi is only made
+ * where paths with different values meet. A block is sealed once all of
+ * its predecessors are known, a loop header only after its body.
+ *
+ * The passes run in order on the result are
+ *
+ *   - removing the blocks that can't be reached, e.g. after a return
+ *   - copy propagation, an assignment is a copy of its value
+ *   - removing phis that only ever see one value
+ *   - removing checks of values that are always set
+ *   - common subexpression elimination, within a block
+ *   - dead code elimination
+ *
+ * Once every function is lowered, como_ssa_infer_types works out what each
+ * value holds across the whole program, and como_ssa_codegen turns what is
+ * left into register code.
+ */
+
+/* What a slot holds when the block can't tell, see read_slot */
+static ComoSsaInsn ssa_memory;
+#define SSA_MEMORY (&ssa_memory)
+
+ComoSsaInsn *como_ssa_resolve(ComoSsaInsn *insn)
+{
+	while(insn->replacement != NULL) {
+		insn = insn->replacement;
+	}
+	return insn;
+}
+
+int como_ssa_has_effects(ComoSsaInsn *insn)
+{
+	switch(insn->op) {
+		case SSA_LOAD_GLOBAL:
+			return insn->callee == NULL;
+		case SSA_CONST:
+		case SSA_LOAD_SLOT:
+		case SSA_COPY:
+		case SSA_PHI:
+			return 0;
+		/* Only the arithmetic that can't fail goes away unused */
+		case SSA_BINARY:
+			switch(insn->binop) {
+				case REG_ADD:
+				case REG_LT:
+				case REG_LTE:
+				case REG_GT:
+				case REG_GTE:
+				case REG_EQ:
+				case REG_NEQ:
+					return 0;
+				default:
+					return 1;
+			}
+		default:
+			return 1;
+	}
+}
+
+static ComoSsaBlock *new_block(ComoSsaFunction *fn)
+{
+	ComoSsaBlock *b = calloc(1, sizeof(ComoSsaBlock));
+
+	if(fn->nblocks == fn->blocks_capacity) {
+		fn->blocks_capacity = fn->blocks_capacity ? fn->blocks_capacity * 2 : 16;
+		fn->blocks = realloc(fn->blocks,
+			sizeof(ComoSsaBlock *) * fn->blocks_capacity);
+	}
+
+	b->id = (unsigned int)fn->nblocks;
+	b->defs = calloc(fn->nslots + 1, sizeof(ComoSsaInsn *));
+	fn->blocks[fn->nblocks++] = b;
+
+	return b;
+}
+
+static ComoSsaInsn *new_insn(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned char op)
+{
+	ComoSsaInsn *insn = calloc(1, sizeof(ComoSsaInsn));
+
+	if(fn->nvalues == fn->values_capacity) {
+		fn->values_capacity = fn->values_capacity ? fn->values_capacity * 2 : 64;
+		fn->values = realloc(fn->values,
+			sizeof(ComoSsaInsn *) * fn->values_capacity);
+	}
+
+	insn->op = op;
+	insn->id = (unsigned int)fn->nvalues;
+	insn->block = b;
+	insn->reg = REG_NONE;
+	fn->values[fn->nvalues++] = insn;
+
+	return insn;
+}
+
+static void add_arg(ComoSsaInsn *insn, ComoSsaInsn *arg)
+{
+	if(insn->nargs == insn->args_capacity) {
+		insn->args_capacity = insn->args_capacity ? insn->args_capacity * 2 : 2;
+		insn->args = realloc(insn->args,
+			sizeof(ComoSsaInsn *) * insn->args_capacity);
+	}
+	insn->args[insn->nargs++] = arg;
+}
+
+/* Appends to the end of b, which needn't be the block being built */
+static ComoSsaInsn *append(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned char op)
+{
+	ComoSsaInsn *insn = new_insn(fn, b, op);
+
+	if(b->count == b->capacity) {
+		b->capacity = b->capacity ? b->capacity * 2 : 8;
+		b->insns = realloc(b->insns, sizeof(ComoSsaInsn *) * b->capacity);
+	}
+	b->insns[b->count++] = insn;
+
+	return insn;
+}
+
+ComoSsaBlock *como_ssa_new_block(ComoSsaFunction *fn)
+{
+	ComoSsaBlock *b = new_block(fn);
+	b->sealed = 1;
+	b->reachable = 1;
+	return b;
+}
+
+ComoSsaInsn *como_ssa_append(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned char op)
+{
+	return append(fn, b, op);
+}
+
+void como_ssa_add_arg(ComoSsaInsn *insn, ComoSsaInsn *arg)
+{
+	add_arg(insn, arg);
+}
+
+static ComoSsaInsn *emit(ComoSsaFunction *fn, unsigned char op)
+{
+	return append(fn, fn->current, op);
+}
+
+static void add_pred(ComoSsaBlock *b, ComoSsaBlock *pred)
+{
+	if(b->npreds == b->preds_capacity) {
+		b->preds_capacity = b->preds_capacity ? b->preds_capacity * 2 : 2;
+		b->preds = realloc(b->preds, sizeof(ComoSsaBlock *) * b->preds_capacity);
+	}
+	b->preds[b->npreds++] = pred;
+	pred->succs[pred->nsuccs++] = b;
+}
+
+static ComoSsaInsn *load_slot(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned int slot)
+{
+	ComoSsaInsn *load = append(fn, b, SSA_LOAD_SLOT);
+	load->slot = slot;
+	load->name = fn->names[slot];
+	/* Once set, a slot stays set */
+	load->nonnull = fn->entry_nonnull[slot];
+	return load;
+}
+
+ComoSsaInsn *como_ssa_add_phi(ComoSsaFunction *fn, ComoSsaBlock *b)
+{
+	ComoSsaInsn *phi = new_insn(fn, b, SSA_PHI);
+
+	if(b->nphis == b->phis_capacity) {
+		b->phis_capacity = b->phis_capacity ? b->phis_capacity * 2 : 4;
+		b->phis = realloc(b->phis, sizeof(ComoSsaInsn *) * b->phis_capacity);
+	}
+	b->phis[b->nphis++] = phi;
+
+	phi->slot = REG_NONE;
+
+	return phi;
+}
+
+static ComoSsaInsn *new_phi(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned int slot)
+{
+	ComoSsaInsn *phi = como_ssa_add_phi(fn, b);
+
+	phi->slot = slot;
+	phi->name = fn->names[slot];
+
+	return phi;
+}
+
+void como_ssa_add_pred(ComoSsaBlock *b, ComoSsaBlock *pred)
+{
+	add_pred(b, pred);
+}
+
+static ComoSsaInsn *read_slot(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned int slot);
+
+static void add_phi_operands(ComoSsaFunction *fn, ComoSsaInsn *phi)
+{
+	size_t i;
+
+	for(i = 0; i < phi->block->npreds; i++) {
+		add_arg(phi, read_slot(fn, phi->block->preds[i], phi->slot));
+	}
+}
+
+/* The value slot has at the end of b, or where b is being built */
+static ComoSsaInsn *read_slot(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned int slot)
+{
+	ComoSsaInsn *value = b->defs[slot];
+
+	if(value != NULL && value != SSA_MEMORY) {
+		return value;
+	}
+
+	if(value == SSA_MEMORY || b->npreds == 0) {
+		value = load_slot(fn, b, slot);
+	} else if(!b->sealed) {
+		value = new_phi(fn, b, slot);
+	} else if(b->npreds == 1) {
+		value = read_slot(fn, b->preds[0], slot);
+	} else {
+		/* Recorded first, a loop leads back here */
+		value = new_phi(fn, b, slot);
+		b->defs[slot] = value;
+		add_phi_operands(fn, value);
+	}
+
+	b->defs[slot] = value;
+
+	return value;
+}
+
+static void seal(ComoSsaFunction *fn, ComoSsaBlock *b)
+{
+	size_t i;
+
+	for(i = 0; i < b->nphis; i++) {
+		if(b->phis[i]->nargs == 0) {
+			add_phi_operands(fn, b->phis[i]);
+		}
+	}
+
+	b->sealed = 1;
+}
+
+static void write_slot(ComoSsaFunction *fn, unsigned int slot,
+	ComoSsaInsn *value)
+{
+	ComoSsaInsn *store = emit(fn, SSA_STORE_SLOT);
+	store->slot = slot;
+	store->name = fn->names[slot];
+	add_arg(store, value);
+	fn->current->defs[slot] = value;
+}
+
+static void finish_jmp(ComoSsaFunction *fn, ComoSsaBlock *target)
+{
+	fn->current->terminator = SSA_JMP;
+	add_pred(target, fn->current);
+}
+
+static void finish_branch(ComoSsaFunction *fn, ComoSsaInsn *cond,
+	ComoSsaBlock *taken, ComoSsaBlock *not_taken)
+{
+	fn->current->terminator = SSA_BRANCH;
+	fn->current->value = cond;
+	add_pred(taken, fn->current);
+	add_pred(not_taken, fn->current);
+}
+
+static void add_loop(ComoSsaFunction *fn, ComoSsaBlock *preheader,
+	ComoSsaBlock *header, ComoSsaBlock *latch)
+{
+	ComoSsaLoop *loop;
+
+	if(fn->nloops == fn->loops_capacity) {
+		fn->loops_capacity = fn->loops_capacity ? fn->loops_capacity * 2 : 4;
+		fn->loops = realloc(fn->loops, sizeof(ComoSsaLoop) * fn->loops_capacity);
+	}
+
+	loop = &fn->loops[fn->nloops++];
+	loop->preheader = preheader;
+	loop->header = header;
+	loop->latch = latch;
+}
+
+static unsigned int slot_of(Object *slots, const char *name)
+{
+	Object *index = mapSearch(slots, name);
+	return index != NULL ? (unsigned int)O_LVAL(index) : REG_NONE;
+}
+
+static unsigned char binary_op(ast_binary_op_type type)
+{
+	switch(type) {
+		case AST_BINARY_OP_ADD:   return REG_ADD;
+		case AST_BINARY_OP_MINUS: return REG_SUB;
+		case AST_BINARY_OP_TIMES: return REG_MUL;
+		case AST_BINARY_OP_DIV:   return REG_DIV;
+		case AST_BINARY_OP_REM:   return REG_REM;
+		case AST_BINARY_OP_LT:    return REG_LT;
+		case AST_BINARY_OP_LTE:   return REG_LTE;
+		case AST_BINARY_OP_GT:    return REG_GT;
+		case AST_BINARY_OP_GTE:   return REG_GTE;
+		case AST_BINARY_OP_CMP:   return REG_EQ;
+		case AST_BINARY_OP_NEQ:   return REG_NEQ;
+		default:
+			como_error_noreturn("--ssa: unknown binary operator %d", type);
+	}
+}
+
+static ComoSsaInsn *lower_expression(ComoSsaFunction *fn, ast_node *p)
+{
+	ComoSsaInsn *insn, *value;
+	size_t i;
+
+	switch(p->type) {
+		case AST_NODE_TYPE_NUMBER:
+			insn = emit(fn, SSA_CONST);
+			insn->constant = newLong(p->u1.number_value);
+			insn->nonnull = 1;
+		return insn;
+		case AST_NODE_TYPE_STRING: {
+			/* The same Object, so the code generator shares the constant */
+			Object *value = mapSearch(fn->strings, p->u1.string_value.value);
+			if(value == NULL) {
+				value = newPointer((void *)newString(p->u1.string_value.value));
+				mapInsertEx(fn->strings, p->u1.string_value.value, value);
+			}
+			insn = emit(fn, SSA_CONST);
+			insn->constant = (Object *)O_PTVAL(value);
+			insn->nonnull = 1;
+			return insn;
+		}
+		case AST_NODE_TYPE_ID: {
+			const char *name = AST_NODE_AS_ID(p);
+			unsigned int slot = slot_of(fn->slots, name);
+			unsigned int global = fn->top_level ? REG_NONE
+				: slot_of(fn->globals, name);
+
+			if(slot != REG_NONE) {
+				value = read_slot(fn, fn->current, slot);
+				if(global != REG_NONE) {
+					insn = emit(fn, SSA_LOAD_LOCAL_OR_GLOBAL);
+					insn->slot = global;
+					insn->name = name;
+					insn->nonnull = 1;
+					add_arg(insn, value);
+					return insn;
+				}
+				/* LOAD_NAME fails where the name is read */
+				insn = emit(fn, SSA_CHECK);
+				insn->name = name;
+				add_arg(insn, value);
+				return value;
+			}
+
+			insn = emit(fn, global != REG_NONE ? SSA_LOAD_GLOBAL : SSA_UNDEFINED);
+			insn->slot = global;
+			insn->name = name;
+			insn->nonnull = 1;
+			return insn;
+		}
+		case AST_NODE_TYPE_UNARY_OP:
+			value = lower_expression(fn, p->u1.unary_node.expr);
+			insn = emit(fn, SSA_NEG);
+			insn->nonnull = 1;
+			add_arg(insn, value);
+		return insn;
+		case AST_NODE_TYPE_POSTFIX: {
+			const char *name = AST_NODE_AS_ID(p->u1.postfix_node.expr);
+			unsigned int slot = slot_of(fn->slots, name);
+			/* como_rt_step reports an undefined name itself */
+			value = read_slot(fn, fn->current, slot);
+			insn = emit(fn, p->u1.postfix_node.type == AST_POSTFIX_OP_INC
+				? SSA_INC : SSA_DEC);
+			insn->name = name;
+			insn->nonnull = 1;
+			add_arg(insn, value);
+			write_slot(fn, slot, insn);
+			return value;
+		}
+		case AST_NODE_TYPE_PREFIX:
+			/* The assignment it stands for, whose value is the name's */
+			return lower_expression(fn, p->u1.prefix_node.expr);
+		case AST_NODE_TYPE_BIN_OP: {
+			ComoSsaInsn *left, *right;
+
+			if(p->u1.binary_node.type == AST_BINARY_OP_ASSIGN) {
+				value = lower_expression(fn, p->u1.binary_node.right);
+				insn = emit(fn, SSA_COPY);
+				insn->nonnull = value->nonnull;
+				add_arg(insn, value);
+				write_slot(fn, slot_of(fn->slots,
+					AST_NODE_AS_ID(p->u1.binary_node.left)), insn);
+				return insn;
+			}
+
+			left = lower_expression(fn, p->u1.binary_node.left);
+			right = lower_expression(fn, p->u1.binary_node.right);
+			insn = emit(fn, SSA_BINARY);
+			insn->binop = binary_op(p->u1.binary_node.type);
+			insn->nonnull = 1;
+			add_arg(insn, left);
+			add_arg(insn, right);
+			return insn;
+		}
+		case AST_NODE_TYPE_CALL: {
+			ast_node_statements *arguments =
+				&p->u1.call_node.arguments->u1.statements_node;
+			ComoSsaInsn **values = malloc(sizeof(ComoSsaInsn *)
+				* (arguments->count + 1));
+
+			for(i = 0; i < arguments->count; i++) {
+				values[i] = lower_expression(fn, arguments->statement_list[i]);
+			}
+
+			value = lower_expression(fn, p->u1.call_node.id);
+			insn = emit(fn, SSA_CALL);
+			insn->name = AST_NODE_AS_ID(p->u1.call_node.id);
+			insn->nonnull = 1;
+			add_arg(insn, value);
+			for(i = 0; i < arguments->count; i++) {
+				add_arg(insn, values[i]);
+			}
+			free(values);
+
+			/* The call may come back here and change any slot */
+			if(!fn->top_level) {
+				for(i = 0; i < fn->nslots; i++) {
+					fn->current->defs[i] = SSA_MEMORY;
+				}
+			}
+			return insn;
+		}
+		default:
+			como_error_noreturn("--ssa: node type %d isn't an expression",
+				p->type);
+	}
+}
+
+static void lower_statement(ComoSsaFunction *fn, ast_node *p);
+
+/*
+ * A chain of blocks comparing the value with each label, branching to the
+ * body of its case on a match, the last one jumping to the default or to
+ * the exit
+ */
+static void lower_switch(ComoSsaFunction *fn, ast_node *p)
+{
+	ast_node_statements *cases = &p->u1.switch_node.cases->u1.statements_node;
+	ComoSsaBlock **bodies = malloc(sizeof(ComoSsaBlock *) 
+		* (cases->count + 1));
+	ComoSsaBlock *exit, *next, *other;
+	ComoSsaInsn *value, *insn;
+	size_t i, j;
+
+	value = lower_expression(fn, p->u1.switch_node.expr);
+	exit = new_block(fn);
+	other = exit;
+
+	for(i = 0; i < cases->count; i++) {
+		bodies[i] = new_block(fn);
+		if(cases->statement_list[i]->u1.case_node.labels == NULL) {
+			other = bodies[i];
+		}
+	}
+
+	for(i = 0; i < cases->count; i++) {
+		ast_node *labels = cases->statement_list[i]->u1.case_node.labels;
+		for(j = 0; labels != NULL && j < labels->u1.statements_node.count; 
+				j++) {
+			ComoSsaInsn *label = lower_expression(fn, 
+				labels->u1.statements_node.statement_list[j]);
+			insn = emit(fn, SSA_BINARY);
+			insn->binop = REG_EQ;
+			insn->nonnull = 1;
+			add_arg(insn, value);
+			add_arg(insn, label);
+			next = new_block(fn);
+			finish_branch(fn, insn, bodies[i], next);
+			seal(fn, next);
+			fn->current = next;
+		}
+	}
+
+	finish_jmp(fn, other);
+
+	for(i = 0; i < cases->count; i++) {
+		seal(fn, bodies[i]);
+		fn->current = bodies[i];
+		lower_statement(fn, cases->statement_list[i]->u1.case_node.body);
+		finish_jmp(fn, exit);
+	}
+
+	seal(fn, exit);
+	fn->current = exit;
+	free(bodies);
+}
+
+static void lower_statement(ComoSsaFunction *fn, ast_node *p)
+{
+	ComoSsaBlock *header, *body, *exit, *other, *preheader;
+	ComoSsaInsn *value;
+	ast_node *condition;
+	size_t i;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				lower_statement(fn, p->u1.statements_node.statement_list[i]);
+			}
+		break;
+		/* Bound before the top level code runs, see como_reg_run */
+		case AST_NODE_TYPE_FUNC_DECL:
+		break;
+		case AST_NODE_TYPE_PRINT:
+			value = lower_expression(fn, p->u1.print_node.expr);
+			add_arg(emit(fn, SSA_PRINT), value);
+		break;
+		case AST_NODE_TYPE_RET:
+			if(p->u1.return_node.expr != NULL) {
+				fn->current->value = lower_expression(fn, p->u1.return_node.expr);
+				fn->current->terminator = SSA_RETURN;
+			} else {
+				fn->current->terminator = SSA_RETURN_NONE;
+			}
+			/* Whatever follows can't be reached */
+			fn->current = new_block(fn);
+			fn->current->sealed = 1;
+		break;
+		case AST_NODE_TYPE_IF:
+			value = lower_expression(fn, p->u1.if_node.condition);
+			body = new_block(fn);
+			exit = new_block(fn);
+			other = p->u1.if_node.b2 != NULL ? new_block(fn) : exit;
+			finish_branch(fn, value, body, other);
+			seal(fn, body);
+			if(other != exit) {
+				seal(fn, other);
+			}
+
+			fn->current = body;
+			lower_statement(fn, p->u1.if_node.b1);
+			finish_jmp(fn, exit);
+
+			if(other != exit) {
+				fn->current = other;
+				lower_statement(fn, p->u1.if_node.b2);
+				finish_jmp(fn, exit);
+			}
+
+			seal(fn, exit);
+			fn->current = exit;
+		break;
+		case AST_NODE_TYPE_WHILE:
+		case AST_NODE_TYPE_FOR:
+			/*
+			 * Rotated, the condition is tested once before the loop and then
+			 * at the bottom of every iteration, branching back to the top.
+			 * The preheader is left empty for como_ssa_hoist
+			 */
+			if(p->type == AST_NODE_TYPE_FOR) {
+				lower_statement(fn, p->u1.for_node.initialization);
+				condition = p->u1.for_node.condition;
+			} else {
+				condition = p->u1.while_node.condition;
+			}
+
+			value = lower_expression(fn, condition);
+			preheader = new_block(fn);
+			exit = new_block(fn);
+			finish_branch(fn, value, preheader, exit);
+			seal(fn, preheader);
+
+			fn->current = preheader;
+			header = new_block(fn);
+			finish_jmp(fn, header);
+
+			fn->current = header;
+			if(p->type == AST_NODE_TYPE_FOR) {
+				lower_statement(fn, p->u1.for_node.body);
+				lower_statement(fn, p->u1.for_node.final_expression);
+			} else {
+				lower_statement(fn, p->u1.while_node.body);
+			}
+
+			value = lower_expression(fn, condition);
+			add_loop(fn, preheader, header, fn->current);
+			finish_branch(fn, value, header, exit);
+			seal(fn, header);
+			seal(fn, exit);
+
+			fn->current = exit;
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			lower_switch(fn, p);
+		break;
+		default:
+			lower_expression(fn, p);
+		break;
+	}
+}
+
+/* Drops the edge from pred to b, and what b's phis had coming from it */
+static void remove_pred(ComoSsaBlock *b, ComoSsaBlock *pred)
+{
+	size_t i, j;
+
+	for(i = 0; i < b->npreds; i++) {
+		if(b->preds[i] != pred) {
+			continue;
+		}
+		for(j = 0; j < b->nphis; j++) {
+			ComoSsaInsn *phi = b->phis[j];
+			memmove(&phi->args[i], &phi->args[i + 1],
+				sizeof(ComoSsaInsn *) * (phi->nargs - i - 1));
+			phi->nargs--;
+		}
+		memmove(&b->preds[i], &b->preds[i + 1],
+			sizeof(ComoSsaBlock *) * (b->npreds - i - 1));
+		b->npreds--;
+		return;
+	}
+}
+
+static void mark_reachable(ComoSsaBlock *b)
+{
+	size_t i;
+
+	if(b->reachable) {
+		return;
+	}
+	b->reachable = 1;
+
+	for(i = 0; i < b->nsuccs; i++) {
+		mark_reachable(b->succs[i]);
+	}
+}
+
+static void remove_unreachable(ComoSsaFunction *fn)
+{
+	size_t i, j;
+
+	mark_reachable(fn->entry);
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		if(b->reachable) {
+			continue;
+		}
+		for(j = 0; j < b->nsuccs; j++) {
+			if(b->succs[j]->reachable) {
+				remove_pred(b->succs[j], b);
+			}
+		}
+		for(j = 0; j < b->count; j++) {
+			b->insns[j]->removed = 1;
+		}
+		for(j = 0; j < b->nphis; j++) {
+			b->phis[j]->removed = 1;
+		}
+		fn->unreachable++;
+	}
+}
+
+static void propagate_copies(ComoSsaFunction *fn)
+{
+	size_t i;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		if(insn->op == SSA_COPY && !insn->removed) {
+			insn->replacement = insn->args[0];
+			insn->removed = 1;
+			fn->copies++;
+		}
+	}
+}
+
+/* A phi whose operands are all one value, or itself, is that value */
+static void remove_trivial_phis(ComoSsaFunction *fn)
+{
+	int changed = 1;
+	size_t i, j;
+
+	while(changed) {
+		changed = 0;
+		for(i = 0; i < fn->nvalues; i++) {
+			ComoSsaInsn *phi = fn->values[i], *same = NULL;
+
+			if(phi->op != SSA_PHI || phi->removed) {
+				continue;
+			}
+
+			for(j = 0; j < phi->nargs; j++) {
+				ComoSsaInsn *arg = como_ssa_resolve(phi->args[j]);
+				if(arg == phi || arg == same) {
+					continue;
+				}
+				if(same != NULL) {
+					same = NULL;
+					break;
+				}
+				same = arg;
+			}
+
+			if(same != NULL && j == phi->nargs) {
+				phi->replacement = same;
+				phi->removed = 1;
+				fn->phis++;
+				changed = 1;
+			}
+		}
+	}
+}
+
+/*
+ * A slot stays set once it is, so it is read set wherever it was stored to
+ * on every way there
+ */
+static void mark_assigned(ComoSsaFunction *fn)
+{
+	size_t width = fn->nslots + 1, i, j, k;
+	unsigned char *assigned = malloc(fn->nblocks * width);
+	unsigned char in[width];
+	int changed = 1, last = 0;
+
+	memset(assigned, 1, fn->nblocks * width);
+
+	/* Once more when nothing changes, to mark the loads */
+	while(!last) {
+		last = !changed;
+		changed = 0;
+		for(i = 0; i < fn->nblocks; i++) {
+			ComoSsaBlock *b = fn->blocks[i];
+
+			if(!b->reachable) {
+				continue;
+			}
+
+			if(b == fn->entry) {
+				memcpy(in, fn->entry_nonnull, width);
+			} else {
+				memset(in, 1, width);
+				for(j = 0; j < b->npreds; j++) {
+					for(k = 0; k < width; k++) {
+						in[k] &= assigned[b->preds[j]->id * width + k];
+					}
+				}
+			}
+
+			for(j = 0; j < b->count; j++) {
+				ComoSsaInsn *insn = b->insns[j];
+				if(insn->removed) {
+					continue;
+				}
+				if(insn->op == SSA_LOAD_SLOT && in[insn->slot] && last) {
+					insn->nonnull = 1;
+				} else if(insn->op == SSA_STORE_SLOT) {
+					in[insn->slot] = 1;
+				}
+			}
+
+			if(memcmp(in, &assigned[b->id * width], width) != 0) {
+				memcpy(&assigned[b->id * width], in, width);
+				changed = 1;
+			}
+		}
+	}
+
+	free(assigned);
+}
+
+/*
+ * A phi is set if everything coming into it is, assumed until one of its
+ * operands turns out not to be
+ */
+static void remove_checks(ComoSsaFunction *fn)
+{
+	int changed = 1;
+	size_t i, j;
+
+	mark_assigned(fn);
+
+	for(i = 0; i < fn->nvalues; i++) {
+		if(fn->values[i]->op == SSA_PHI && !fn->values[i]->removed) {
+			fn->values[i]->nonnull = 1;
+		}
+	}
+
+	while(changed) {
+		changed = 0;
+		for(i = 0; i < fn->nvalues; i++) {
+			ComoSsaInsn *phi = fn->values[i];
+			if(phi->op != SSA_PHI || phi->removed || !phi->nonnull) {
+				continue;
+			}
+			for(j = 0; j < phi->nargs; j++) {
+				if(!como_ssa_resolve(phi->args[j])->nonnull) {
+					phi->nonnull = 0;
+					changed = 1;
+					break;
+				}
+			}
+		}
+	}
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		if(insn->removed || (insn->op != SSA_CHECK
+				&& insn->op != SSA_LOAD_LOCAL_OR_GLOBAL)
+				|| !como_ssa_resolve(insn->args[0])->nonnull) {
+			continue;
+		}
+		if(insn->op == SSA_CHECK) {
+			insn->removed = 1;
+			fn->checks++;
+		} else if(insn->op == SSA_LOAD_LOCAL_OR_GLOBAL) {
+			/* The local is set, the global is never looked at */
+			insn->replacement = como_ssa_resolve(insn->args[0]);
+			insn->removed = 1;
+			fn->checks++;
+		}
+	}
+}
+
+/*
+ * Whether every use of value only reads it. A long written into a scratch
+ * long of the function is overwritten the next time it is computed, so a
+ * value that can reach a slot, a callee or a caller must stay an Object of
+ * its own
+ */
+int como_ssa_only_read(ComoSsaFunction *fn, ComoSsaInsn *value)
+{
+	size_t i, j;
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		if(!b->reachable) {
+			continue;
+		}
+		if(b->terminator == SSA_RETURN && como_ssa_resolve(b->value) == value) {
+			return 0;
+		}
+		for(j = 0; j < b->nphis; j++) {
+			size_t k;
+			ComoSsaInsn *phi = b->phis[j];
+			if(phi->removed) {
+				continue;
+			}
+			for(k = 0; k < phi->nargs; k++) {
+				if(como_ssa_resolve(phi->args[k]) == value) {
+					return 0;
+				}
+			}
+		}
+		for(j = 0; j < b->count; j++) {
+			size_t k;
+			ComoSsaInsn *insn = b->insns[j];
+			if(insn->removed) {
+				continue;
+			}
+			switch(insn->op) {
+				case SSA_BINARY:
+				case SSA_NEG:
+				case SSA_INC:
+				case SSA_DEC:
+				case SSA_CHECK:
+				case SSA_PRINT:
+					continue;
+				case SSA_CALL:
+					/* The callee itself isn't passed anywhere */
+					for(k = 1; k < insn->nargs; k++) {
+						if(como_ssa_resolve(insn->args[k]) == value) {
+							return 0;
+						}
+					}
+					continue;
+				default:
+					for(k = 0; k < insn->nargs; k++) {
+						if(como_ssa_resolve(insn->args[k]) == value) {
+							return 0;
+						}
+					}
+				break;
+			}
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Local value numbering. Values are never changed in place, so one the
+ * block computed before, even before a call, is reused
+ */
+static void eliminate_common_subexpressions(ComoSsaFunction *fn)
+{
+	ComoSsaInsn **available = malloc(sizeof(ComoSsaInsn *) * (fn->nvalues + 1));
+	size_t i, j, k, navailable;
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+
+		if(!b->reachable) {
+			continue;
+		}
+
+		navailable = 0;
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+
+			if(insn->removed) {
+				continue;
+			}
+
+			switch(insn->op) {
+				case SSA_CHECK:
+				case SSA_BINARY:
+				case SSA_NEG:
+					for(k = 0; k < navailable; k++) {
+						ComoSsaInsn *other = available[k];
+						if(other->op != insn->op || other->binop != insn->binop
+								|| como_ssa_resolve(other->args[0])
+									!= como_ssa_resolve(insn->args[0])
+								|| (insn->nargs > 1
+									&& como_ssa_resolve(other->args[1])
+										!= como_ssa_resolve(insn->args[1]))) {
+							continue;
+						}
+						break;
+					}
+					if(k < navailable) {
+						if(insn->op != SSA_CHECK) {
+							insn->replacement = available[k];
+						}
+						insn->removed = 1;
+						fn->cse++;
+					} else {
+						available[navailable++] = insn;
+					}
+				break;
+			}
+		}
+	}
+
+	free(available);
+}
+
+static void mark_live(ComoSsaInsn *insn)
+{
+	size_t i;
+
+	insn = como_ssa_resolve(insn);
+
+	if(insn->uses++ > 0) {
+		return;
+	}
+
+	for(i = 0; i < insn->nargs; i++) {
+		mark_live(insn->args[i]);
+	}
+}
+
+static void eliminate_dead_code(ComoSsaFunction *fn)
+{
+	size_t i, j;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		fn->values[i]->uses = 0;
+	}
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		if(!b->reachable) {
+			continue;
+		}
+		if(b->value != NULL) {
+			mark_live(b->value);
+		}
+		for(j = 0; j < b->count; j++) {
+			if(!b->insns[j]->removed && como_ssa_has_effects(b->insns[j])) {
+				mark_live(b->insns[j]);
+			}
+		}
+	}
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		if(!insn->removed && insn->uses == 0) {
+			insn->removed = 1;
+			fn->dead++;
+		}
+	}
+}
+
+/* Every operand is the value it was replaced with from here on */
+static void resolve_operands(ComoSsaFunction *fn)
+{
+	size_t i, j;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		for(j = 0; j < insn->nargs; j++) {
+			insn->args[j] = como_ssa_resolve(insn->args[j]);
+		}
+	}
+
+	for(i = 0; i < fn->nblocks; i++) {
+		if(fn->blocks[i]->value != NULL) {
+			fn->blocks[i]->value = como_ssa_resolve(fn->blocks[i]->value);
+		}
+	}
+}
+
+/*
+ * Once it is known which calls are pure, see como_ssa_is_pure: what a pure
+ * call reaches can't call this function back, so a slot read after one is
+ * still what it was before it. What a slot holds is followed into a block
+ * from blocks before it that all agree on it
+ */
+void como_ssa_forward_loads(ComoSsaFunction *fn)
+{
+	size_t width = fn->nslots + 1, i, j, k, forwarded = 0;
+	ComoSsaInsn **known;
+	unsigned char *done;
+
+	if(fn->top_level) {
+		return;
+	}
+
+	known = calloc(fn->nblocks * width, sizeof(ComoSsaInsn *));
+	done = calloc(fn->nblocks, 1);
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		ComoSsaInsn **in = &known[b->id * width];
+
+		if(!b->reachable) {
+			continue;
+		}
+
+		for(j = 0; j < b->npreds && done[b->preds[j]->id]; j++)
+			;
+		if(b->npreds > 0 && j == b->npreds) {
+			for(k = 0; k < width; k++) {
+				in[k] = known[b->preds[0]->id * width + k];
+				for(j = 1; j < b->npreds && in[k] != NULL; j++) {
+					if(known[b->preds[j]->id * width + k] != in[k]) {
+						in[k] = NULL;
+					}
+				}
+			}
+		}
+
+		for(j = 0; j < b->nphis; j++) {
+			if(!b->phis[j]->removed && b->phis[j]->slot != REG_NONE) {
+				in[b->phis[j]->slot] = b->phis[j];
+			}
+		}
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+
+			if(insn->removed) {
+				continue;
+			}
+
+			switch(insn->op) {
+				case SSA_LOAD_SLOT:
+					if(in[insn->slot] != NULL) {
+						insn->replacement = in[insn->slot];
+						insn->removed = 1;
+						forwarded++;
+					} else {
+						in[insn->slot] = insn;
+					}
+				break;
+				case SSA_STORE_SLOT:
+					in[insn->slot] = insn->args[0];
+				break;
+				case SSA_CALL:
+					if(!como_ssa_is_pure(insn)) {
+						memset(in, 0, sizeof(ComoSsaInsn *) * width);
+					}
+				break;
+			}
+		}
+
+		done[b->id] = 1;
+	}
+
+	free(known);
+	free(done);
+
+	if(forwarded > 0) {
+		fn->copies += forwarded;
+		como_ssa_cleanup(fn);
+	}
+}
+
+/* Once values were replaced after the passes of como_ssa_lower */
+void como_ssa_cleanup(ComoSsaFunction *fn)
+{
+	remove_trivial_phis(fn);
+	eliminate_dead_code(fn);
+	resolve_operands(fn);
+}
+
+static void dump_value(ComoSsaInsn *insn)
+{
+	if(insn->op == SSA_CONST) {
+		char *value = objectToString(insn->constant);
+		fprintf(stderr, O_TYPE(insn->constant) == IS_STRING ? " \"%s\"" : " %s",
+			value);
+		free(value);
+	} else {
+		fprintf(stderr, " v%u", insn->id);
+	}
+}
+
+static const char *ssa_op_name(ComoSsaInsn *insn)
+{
+	switch(insn->op) {
+		case SSA_CONST:                return "const";
+		case SSA_LOAD_SLOT:            return "load";
+		case SSA_STORE_SLOT:           return "store";
+		case SSA_LOAD_GLOBAL:          return "load_global";
+		case SSA_LOAD_LOCAL_OR_GLOBAL: return "load_local_or_global";
+		case SSA_UNDEFINED:            return "undefined";
+		case SSA_CHECK:                return "check";
+		case SSA_COPY:                 return "copy";
+		case SSA_PHI:                  return "phi";
+		case SSA_BINARY:
+			switch(insn->binop) {
+				case REG_ADD: return "add";
+				case REG_SUB: return "sub";
+				case REG_MUL: return "mul";
+				case REG_DIV: return "div";
+				case REG_REM: return "rem";
+				case REG_LT:  return "lt";
+				case REG_LTE: return "lte";
+				case REG_GT:  return "gt";
+				case REG_GTE: return "gte";
+				case REG_EQ:  return "eq";
+				case REG_NEQ: return "neq";
+			}
+		break;
+		case SSA_NEG:                  return "neg";
+		case SSA_INC:                  return "inc";
+		case SSA_DEC:                  return "dec";
+		case SSA_CALL:                 return "call";
+		case SSA_PRINT:                return "print";
+	}
+	return "?";
+}
+
+static void dump_insn(ComoSsaInsn *insn)
+{
+	size_t i;
+
+	if(insn->op == SSA_CONST) {
+		return;
+	}
+
+	fprintf(stderr, "    ");
+	if(insn->op != SSA_STORE_SLOT && insn->op != SSA_CHECK
+			&& insn->op != SSA_PRINT) {
+		fprintf(stderr, "v%u = ", insn->id);
+	}
+	fprintf(stderr, "%s", ssa_op_name(insn));
+
+	if(insn->op == SSA_LOAD_SLOT || insn->op == SSA_STORE_SLOT
+			|| insn->op == SSA_PHI || insn->op == SSA_LOAD_GLOBAL
+			|| insn->op == SSA_LOAD_LOCAL_OR_GLOBAL || insn->op == SSA_CHECK
+			|| insn->op == SSA_UNDEFINED || insn->op == SSA_CALL
+			|| insn->op == SSA_INC || insn->op == SSA_DEC) {
+		fprintf(stderr, " %s", insn->name);
+	}
+
+	for(i = 0; i < insn->nargs; i++) {
+		if(insn->op == SSA_CALL && i == 0) {
+			continue;
+		}
+		dump_value(insn->args[i]);
+	}
+
+	fputc('\n', stderr);
+}
+
+void como_ssa_dump(ComoSsaFunction *fn)
+{
+	size_t i, j;
+
+	fprintf(stderr, "%s: %zu copies, %zu phis, %zu checks, %zu common "
+		"subexpressions, %zu dead, %zu unreachable blocks removed, "
+		"%zu calls evaluated, %zu calls inlined, %zu hoisted\n", fn->name,
+		fn->copies, fn->phis, fn->checks, fn->cse, fn->dead, fn->unreachable,
+		fn->evaluated, fn->inlined, fn->hoisted);
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+
+		if(!b->reachable) {
+			continue;
+		}
+
+		fprintf(stderr, "  b%u:", b->id);
+		if(b->npreds > 0) {
+			fprintf(stderr, " <-");
+			for(j = 0; j < b->npreds; j++) {
+				fprintf(stderr, " b%u", b->preds[j]->id);
+			}
+		}
+		fputc('\n', stderr);
+
+		for(j = 0; j < b->nphis; j++) {
+			if(!b->phis[j]->removed) {
+				dump_insn(b->phis[j]);
+			}
+		}
+		for(j = 0; j < b->count; j++) {
+			if(!b->insns[j]->removed) {
+				dump_insn(b->insns[j]);
+			}
+		}
+
+		switch(b->terminator) {
+			case SSA_JMP:
+				fprintf(stderr, "    jmp b%u\n", b->succs[0]->id);
+			break;
+			case SSA_BRANCH:
+				fprintf(stderr, "    branch");
+				dump_value(b->value);
+				fprintf(stderr, " b%u b%u\n", b->succs[0]->id, b->succs[1]->id);
+			break;
+			case SSA_RETURN:
+				fprintf(stderr, "    return");
+				dump_value(b->value);
+				fputc('\n', stderr);
+			break;
+			default:
+				fprintf(stderr, "    return\n");
+			break;
+		}
+	}
+
+	fputc('\n', stderr);
+}
+
+/* Functions are bound to their top level names before __main__ runs */
+static void mark_functions(ComoSsaFunction *fn, ast_node *p)
+{
+	size_t i;
+
+	if(p == NULL) {
+		return;
+	}
+
+	switch(p->type) {
+		case AST_NODE_TYPE_STATEMENT_LIST:
+			for(i = 0; i < p->u1.statements_node.count; i++) {
+				mark_functions(fn, p->u1.statements_node.statement_list[i]);
+			}
+		break;
+		case AST_NODE_TYPE_IF:
+			mark_functions(fn, p->u1.if_node.b1);
+			mark_functions(fn, p->u1.if_node.b2);
+		break;
+		case AST_NODE_TYPE_WHILE:
+			mark_functions(fn, p->u1.while_node.body);
+		break;
+		case AST_NODE_TYPE_FOR:
+			mark_functions(fn, p->u1.for_node.body);
+		break;
+		case AST_NODE_TYPE_SWITCH:
+			mark_functions(fn, p->u1.switch_node.cases);
+		break;
+		case AST_NODE_TYPE_CASE:
+			mark_functions(fn, p->u1.case_node.body);
+		break;
+		case AST_NODE_TYPE_FUNC_DECL:
+			fn->entry_nonnull[slot_of(fn->slots, p->u1.function_node.name)] = 1;
+			mark_functions(fn, p->u1.function_node.body);
+		break;
+		default:
+		break;
+	}
+}
+
+void como_ssa_free(ComoSsaFunction *fn)
+{
+	size_t i;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		free(fn->values[i]->args);
+		free(fn->values[i]);
+	}
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		free(b->phis);
+		free(b->insns);
+		free(b->preds);
+		free(b->defs);
+		free(b->live_in);
+		free(b->live_out);
+		free(b);
+	}
+
+	free(fn->values);
+	free(fn->blocks);
+	free(fn->loops);
+	free(fn->entry_nonnull);
+	free(fn->slot_types);
+	free(fn->parameter_types);
+	objectDestroy(fn->strings);
+	free(fn);
+}
+
+ComoSsaFunction *como_ssa_lower(ComoRegFunction *reg, Object *slots,
+	Object *globals, int top_level, ast_node *body, Object *constants)
+{
+	ComoSsaFunction *fn = calloc(1, sizeof(ComoSsaFunction));
+	size_t i;
+
+	fn->name = reg->name;
+	fn->reg = reg;
+	fn->constants = constants;
+	fn->top_level = top_level;
+	fn->nslots = reg->nslots;
+	fn->names = reg->names;
+	fn->slots = slots;
+	fn->globals = globals;
+	fn->strings = newMap(16);
+
+	/* Parameters and __FUNCTION__ are bound before the body runs */
+	fn->entry_nonnull = calloc(fn->nslots + 1, 1);
+	for(i = 0; i < reg->parameters; i++) {
+		fn->entry_nonnull[reg->parameter_regs[i]] = 1;
+	}
+	if(top_level) {
+		mark_functions(fn, body);
+	} else {
+		fn->entry_nonnull[reg->function_name_reg] = 1;
+	}
+
+	fn->entry = new_block(fn);
+	fn->entry->sealed = 1;
+	fn->current = fn->entry;
+
+	lower_statement(fn, body);
+	fn->current->terminator = SSA_RETURN_NONE;
+
+	remove_unreachable(fn);
+	propagate_copies(fn);
+	remove_trivial_phis(fn);
+	remove_checks(fn);
+	if(como_pass_enabled(COMO_PASS_SSA_CSE)) {
+		uint64_t start = como_pass_clock();
+		eliminate_common_subexpressions(fn);
+		como_pass_record(COMO_PASS_SSA_CSE, start, 0);
+	}
+	eliminate_dead_code(fn);
+	resolve_operands(fn);
+
+	return fn;
+}
@@ -0,0 +1,245 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMO_SSA_H
+#define COMO_SSA_H
+
+#include <stddef.h>
+#include <object.h>
+
+#include "ast.h"
+#include "como_register.h"
+
+/*
+ * The SSA form a function body is lowered to with --ssa, before register
+ * code is generated for it. A function is a graph of basic blocks, each a
+ * list of instructions ending in a jump, a branch or a return. Every
+ * instruction is also the value it computes.
+ *
+ * Slots keep their meaning from the register VM: a name the function
+ * assigns lives on between calls, and a recursive call may change it. So
+ * an assignment is always stored to the slot, STORE_SLOT, and reading a
+ * name is whatever was last stored to it on the way there, or LOAD_SLOT
+ * where that isn't known: on entry, and after a call in a function.
+ */
+#define SSA_CONST                 0x01  /* constant */
+#define SSA_LOAD_SLOT             0x02  /* slot, may not be set */
+#define SSA_STORE_SLOT            0x03  /* slot = args[0] */
+#define SSA_LOAD_GLOBAL           0x04  /* top level slot */
+#define SSA_LOAD_LOCAL_OR_GLOBAL  0x05  /* args[0] if set, else top level slot */
+#define SSA_UNDEFINED             0x06
+#define SSA_CHECK                 0x07  /* args[0] must be set */
+#define SSA_COPY                  0x08  /* args[0] */
+#define SSA_PHI                   0x09  /* args[i] coming from preds[i] */
+#define SSA_BINARY                0x0a  /* binop args[0], args[1] */
+#define SSA_NEG                   0x0b
+#define SSA_INC                   0x0c  /* args[0] + 1, a new long */
+#define SSA_DEC                   0x0d
+#define SSA_CALL                  0x0e  /* args[0](args[1], ...) */
+#define SSA_PRINT                 0x0f
+
+/* How a block ends */
+#define SSA_JMP                   0x01  /* to succs[0] */
+#define SSA_BRANCH                0x02  /* succs[0] if value is true */
+#define SSA_RETURN                0x03  /* value */
+#define SSA_RETURN_NONE           0x04
+
+typedef struct ComoSsaBlock ComoSsaBlock;
+typedef struct ComoSsaInsn ComoSsaInsn;
+typedef struct ComoSsaFunction ComoSsaFunction;
+
+struct ComoSsaInsn {
+	unsigned char   op;
+	unsigned char   binop;            /* REG_ADD ... REG_NEQ, for SSA_BINARY */
+	unsigned char   nonnull;          /* known to be set */
+	unsigned char   removed;
+	unsigned char   type;             /* REG_TYPE_*, see como_ssa_infer_types */
+	unsigned int    id;
+	ComoSsaInsn   **args;
+	size_t          nargs;
+	size_t          args_capacity;
+	Object         *constant;
+	unsigned int    slot;             /* own or top level, for slot ops */
+	const char     *name;
+	ComoSsaBlock   *block;
+	ComoSsaInsn    *replacement;      /* set once removed in favor of it */
+	size_t          uses;
+	unsigned int    reg;
+	size_t          pos;
+	ComoSsaFunction *callee;          /* called by name, for SSA_CALL, or
+	                                     named, for SSA_LOAD_GLOBAL */
+};
+
+struct ComoSsaBlock {
+	unsigned int    id;
+	ComoSsaInsn   **phis;
+	size_t          nphis;
+	size_t          phis_capacity;
+	ComoSsaInsn   **insns;
+	size_t          count;
+	size_t          capacity;
+	ComoSsaBlock  **preds;
+	size_t          npreds;
+	size_t          preds_capacity;
+	ComoSsaBlock   *succs[2];
+	size_t          nsuccs;
+	unsigned char   terminator;
+	ComoSsaInsn    *value;
+	ComoSsaInsn   **defs;             /* value of each slot, while building */
+	int             sealed;
+	int             reachable;
+	size_t          from;             /* positions, see como_ssa_codegen */
+	size_t          to;
+	unsigned char  *live_in;
+	unsigned char  *live_out;
+};
+
+/*
+ * A loop, as lowered: the preheader runs once before it, the header first
+ * in every iteration and the latch last, branching back to the header
+ */
+typedef struct ComoSsaLoop {
+	ComoSsaBlock   *preheader;
+	ComoSsaBlock   *header;
+	ComoSsaBlock   *latch;
+} ComoSsaLoop;
+
+struct ComoSsaFunction {
+	const char     *name;
+	ComoRegFunction *reg;             /* what the code is generated into */
+	Object         *constants;        /* Array, the values of its constants */
+	int             top_level;
+	unsigned int    nslots;
+	char          **names;
+	unsigned char  *entry_nonnull;    /* slots set whenever the body starts */
+	Object         *slots;            /* Map, name to slot */
+	Object         *globals;          /* Map, name to top level slot */
+	Object         *strings;          /* Map, string literal to its constant */
+	ComoSsaBlock  **blocks;
+	size_t          nblocks;
+	size_t          blocks_capacity;
+	ComoSsaInsn   **values;           /* every instruction, by id */
+	size_t          nvalues;
+	size_t          values_capacity;
+	ComoSsaBlock   *entry;
+	ComoSsaBlock   *current;
+	size_t          copies;           /* what each pass did, for --ssa-dump */
+	size_t          phis;
+	size_t          cse;
+	size_t          checks;
+	size_t          dead;
+	size_t          unreachable;
+	size_t          hoisted;
+	size_t          evaluated;
+	size_t          inlined;
+	ComoSsaLoop    *loops;            /* innermost first */
+	size_t          nloops;
+	size_t          loops_capacity;
+	unsigned char  *slot_types;       /* of whatever a slot may hold */
+	unsigned char  *parameter_types;  /* of every argument passed by name */
+	unsigned char   return_type;
+	int             escapes;          /* may be called other than by name */
+	int             pure;             /* see como_ssa_is_pure */
+	int             evaluable;        /* see como_ssa_evaluate */
+	int             inline_state;     /* see como_ssa_inline */
+};
+
+/* The value an instruction was replaced with, or itself */
+extern ComoSsaInsn *como_ssa_resolve(ComoSsaInsn *insn);
+
+/* Whether removing an unused insn would change what the program does */
+extern int como_ssa_has_effects(ComoSsaInsn *insn);
+
+/*
+ * Lowers body, the code of reg, and optimizes it. The values of constants
+ * are appended to constants and named by index, tagged with REG_CONSTANT
+ */
+extern ComoSsaFunction *como_ssa_lower(ComoRegFunction *reg, Object *slots,
+	Object *globals, int top_level, ast_node *body, Object *constants);
+
+extern void como_ssa_dump(ComoSsaFunction *fn);
+
+extern void como_ssa_free(ComoSsaFunction *fn);
+
+/*
+ * Defined in como_ssa_types.c, infers the type of every value of the
+ * whole program, __main__ last
+ */
+extern void como_ssa_infer_types(ComoSsaFunction **functions, size_t count);
+
+/*
+ * Defined in como_ssa_types.c, whether insn computes its value without
+ * doing anything else, and can't fail. A call is, to a function that is
+ * called by name and only does such things itself, without loops
+ */
+extern int como_ssa_is_pure(ComoSsaInsn *insn);
+
+/*
+ * For the passes in other files. Blocks are made reachable, and a phi
+ * belongs to no slot until it is given one
+ */
+extern ComoSsaBlock *como_ssa_new_block(ComoSsaFunction *fn);
+extern ComoSsaInsn *como_ssa_append(ComoSsaFunction *fn, ComoSsaBlock *b,
+	unsigned char op);
+extern ComoSsaInsn *como_ssa_add_phi(ComoSsaFunction *fn, ComoSsaBlock *b);
+extern void como_ssa_add_arg(ComoSsaInsn *insn, ComoSsaInsn *arg);
+extern void como_ssa_add_pred(ComoSsaBlock *b, ComoSsaBlock *pred);
+
+/*
+ * Whether every use of value only reads it, rather than keeping it in a
+ * slot or passing it to a function
+ */
+extern int como_ssa_only_read(ComoSsaFunction *fn, ComoSsaInsn *value);
+
+/*
+ * Removes the phis, and whatever else, that values replaced since
+ * como_ssa_lower leave trivial or unused
+ */
+extern void como_ssa_cleanup(ComoSsaFunction *fn);
+
+/*
+ * Reads slots again after calls that turned out to be pure, once the types
+ * are known
+ */
+extern void como_ssa_forward_loads(ComoSsaFunction *fn);
+
+/*
+ * Defined in como_ssa_eval.c, replaces the calls whose arguments are
+ * constants, to functions that only compute their result, with that result,
+ * once the types are known
+ */
+extern void como_ssa_evaluate(ComoSsaFunction **functions, size_t count);
+
+/*
+ * Defined in como_ssa_inline.c, inlines the calls of small functions by
+ * name across the whole program, once the types are known
+ */
+extern void como_ssa_inline(ComoSsaFunction **functions, size_t count);
+
+/*
+ * Defined in como_ssa_loops.c, moves what doesn't change within a loop
+ * before it, once the types are known
+ */
+extern void como_ssa_hoist(ComoSsaFunction *fn);
+
+/*
+ * Defined in como_ssa_codegen.c, allocates registers for the values of fn
+ * and emits its register code
+ */
+extern void como_ssa_codegen(ComoSsaFunction *fn);
+
+#endif /* !COMO_SSA_H */
@@ -0,0 +1,801 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "comodebug.h"
+#include "como_register.h"
+#include "como_ssa.h"
+
+/*
+ * Register code for a function in SSA form. Blocks are laid out in reverse
+ * postorder and every instruction gets a position, two apart. A value
+ * lives over a range [from, to) of each block it is live in, from its
+ * definition or the start of the block to its last use or the end of the
+ * block. A value goes into the register of a slot where that saves a move
+ * and the slot can't change under it, every other value into the first
+ * temporary none of whose values it overlaps.
+ *
+ * A slot register always holds what was last stored to the slot, both
+ * LOAD_SLOT and a recursive call read it from there. A value only shares
+ * it while it is that value: a LOAD_SLOT or phi of the slot, or a value
+ * stored to the slot right after it is computed. A phi in the register of
+ * its slot so never needs a copy, what comes into it is already there.
+ *
+ * A long that is only read, by arithmetic, a branch or print, doesn't
+ * escape the function. Its instruction writes it into a long of its own,
+ * field c of the instruction, which it reuses every time it runs.
+ */
+
+#define BIT_SET(set, i)   ((set)[(i) >> 3] |= (unsigned char)(1 << ((i) & 7)))
+#define BIT_CLEAR(set, i) ((set)[(i) >> 3] &= (unsigned char)~(1 << ((i) & 7)))
+#define BIT_TEST(set, i)  ((set)[(i) >> 3] & (1 << ((i) & 7)))
+
+typedef struct ComoSsaRange {
+	size_t          from;
+	size_t          to;
+} ComoSsaRange;
+
+typedef struct ComoSsaLive {
+	ComoSsaRange   *ranges;         /* in order */
+	size_t          count;
+	size_t          capacity;
+} ComoSsaLive;
+
+typedef struct ComoSsaPatch {
+	size_t          pc;
+	ComoSsaBlock   *target;
+} ComoSsaPatch;
+
+typedef struct ComoSsaCodegen {
+	ComoSsaFunction *fn;
+	ComoRegFunction *reg;
+	Object          *constants;
+	ComoSsaBlock   **order;
+	size_t           norder;
+	ComoSsaInsn    **values;        /* live values, by position */
+	size_t           nvalues;
+	ComoSsaLive     *live;          /* by value id */
+	size_t           nbytes;        /* of a live_in or live_out set */
+	size_t          *pcs;           /* by block id */
+	ComoSsaPatch    *patches;
+	size_t           npatches;
+	size_t           patches_capacity;
+	unsigned int     ntemps;
+	int              scratch;       /* a temporary breaks a cycle of copies */
+} ComoSsaCodegen;
+
+static int has_value(ComoSsaInsn *insn)
+{
+	return insn->op != SSA_STORE_SLOT && insn->op != SSA_CHECK
+		&& insn->op != SSA_PRINT;
+}
+
+static void postorder(ComoSsaBlock *b, unsigned char *visited,
+	ComoSsaBlock **order, size_t *count)
+{
+	size_t i;
+
+	visited[b->id] = 1;
+
+	/* The taken successor comes right after b */
+	for(i = b->nsuccs; i-- > 0; ) {
+		if(!visited[b->succs[i]->id]) {
+			postorder(b->succs[i], visited, order, count);
+		}
+	}
+
+	order[(*count)++] = b;
+}
+
+static void layout(ComoSsaCodegen *cg)
+{
+	ComoSsaFunction *fn = cg->fn;
+	unsigned char *visited = calloc(fn->nblocks + 1, 1);
+	size_t i, pos = 0;
+
+	cg->order = malloc(sizeof(ComoSsaBlock *) * (fn->nblocks + 1));
+	postorder(fn->entry, visited, cg->order, &cg->norder);
+	free(visited);
+
+	for(i = 0; i < cg->norder / 2; i++) {
+		ComoSsaBlock *b = cg->order[i];
+		cg->order[i] = cg->order[cg->norder - i - 1];
+		cg->order[cg->norder - i - 1] = b;
+	}
+
+	cg->values = malloc(sizeof(ComoSsaInsn *) * (fn->nvalues + 1));
+
+	for(i = 0; i < cg->norder; i++) {
+		ComoSsaBlock *b = cg->order[i];
+		size_t j;
+
+		b->from = pos;
+		pos += 2;
+
+		for(j = 0; j < b->nphis; j++) {
+			if(!b->phis[j]->removed) {
+				b->phis[j]->pos = b->from;
+				cg->values[cg->nvalues++] = b->phis[j];
+			}
+		}
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+			if(insn->removed) {
+				continue;
+			}
+			insn->pos = pos;
+			pos += 2;
+			if(has_value(insn)) {
+				cg->values[cg->nvalues++] = insn;
+			}
+		}
+
+		/* The terminator, after the copies for the phis of the successors */
+		pos += 2;
+		b->to = pos;
+	}
+}
+
+static size_t pred_index(ComoSsaBlock *b, ComoSsaBlock *pred)
+{
+	size_t i;
+
+	for(i = 0; i < b->npreds; i++) {
+		if(b->preds[i] == pred) {
+			return i;
+		}
+	}
+
+	como_error_noreturn("--ssa: b%u isn't a predecessor of b%u", pred->id,
+		b->id);
+}
+
+/* Recomputes the live sets of b, returns whether they changed */
+static int live_step(ComoSsaCodegen *cg, ComoSsaBlock *b, unsigned char *live)
+{
+	size_t i, j;
+	int changed;
+
+	memset(live, 0, cg->nbytes);
+
+	for(i = 0; i < b->nsuccs; i++) {
+		ComoSsaBlock *succ = b->succs[i];
+		size_t index = pred_index(succ, b);
+
+		for(j = 0; j < cg->nbytes; j++) {
+			live[j] |= succ->live_in[j];
+		}
+		for(j = 0; j < succ->nphis; j++) {
+			if(!succ->phis[j]->removed) {
+				BIT_SET(live, succ->phis[j]->args[index]->id);
+			}
+		}
+	}
+
+	changed = memcmp(live, b->live_out, cg->nbytes) != 0;
+	memcpy(b->live_out, live, cg->nbytes);
+
+	if(b->value != NULL) {
+		BIT_SET(live, b->value->id);
+	}
+
+	for(i = b->count; i-- > 0; ) {
+		ComoSsaInsn *insn = b->insns[i];
+		if(insn->removed) {
+			continue;
+		}
+		BIT_CLEAR(live, insn->id);
+		for(j = 0; j < insn->nargs; j++) {
+			BIT_SET(live, insn->args[j]->id);
+		}
+	}
+
+	for(i = 0; i < b->nphis; i++) {
+		BIT_CLEAR(live, b->phis[i]->id);
+	}
+
+	changed |= memcmp(live, b->live_in, cg->nbytes) != 0;
+	memcpy(b->live_in, live, cg->nbytes);
+
+	return changed;
+}
+
+static void add_range(ComoSsaLive *live, size_t from, size_t to)
+{
+	if(live->count == live->capacity) {
+		live->capacity = live->capacity ? live->capacity * 2 : 4;
+		live->ranges = realloc(live->ranges,
+			sizeof(ComoSsaRange) * live->capacity);
+	}
+	live->ranges[live->count].from = from;
+	live->ranges[live->count].to = to;
+	live->count++;
+}
+
+static void ranges(ComoSsaCodegen *cg)
+{
+	ComoSsaFunction *fn = cg->fn;
+	unsigned char *live;
+	size_t *last;
+	size_t i, j, k;
+	int changed = 1;
+
+	cg->nbytes = fn->nvalues / 8 + 1;
+	live = malloc(cg->nbytes);
+
+	for(i = 0; i < cg->norder; i++) {
+		cg->order[i]->live_in = calloc(cg->nbytes, 1);
+		cg->order[i]->live_out = calloc(cg->nbytes, 1);
+	}
+
+	while(changed) {
+		changed = 0;
+		for(i = cg->norder; i-- > 0; ) {
+			changed |= live_step(cg, cg->order[i], live);
+		}
+	}
+
+	free(live);
+
+	cg->live = calloc(fn->nvalues + 1, sizeof(ComoSsaLive));
+	last = malloc(sizeof(size_t) * (fn->nvalues + 1));
+
+	for(i = 0; i < cg->norder; i++) {
+		ComoSsaBlock *b = cg->order[i];
+
+		/* Where each value is last used in b, 0 if it isn't */
+		memset(last, 0, sizeof(size_t) * (fn->nvalues + 1));
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+			if(insn->removed) {
+				continue;
+			}
+			for(k = 0; k < insn->nargs; k++) {
+				last[insn->args[k]->id] = insn->pos;
+			}
+		}
+		if(b->value != NULL) {
+			last[b->value->id] = b->to - 2;
+		}
+
+		for(j = 0; j < cg->nvalues; j++) {
+			ComoSsaInsn *value = cg->values[j];
+			size_t from, to;
+
+			if(BIT_TEST(b->live_in, value->id)) {
+				from = b->from;
+			} else if(value->block == b) {
+				from = value->pos;
+			} else {
+				continue;
+			}
+
+			if(BIT_TEST(b->live_out, value->id)) {
+				to = b->to;
+			} else if(last[value->id] > from) {
+				to = last[value->id];
+			} else {
+				/* Nothing uses it, it still takes its register for a moment */
+				to = from + 1;
+			}
+
+			add_range(&cg->live[value->id], from, to);
+		}
+	}
+
+	free(last);
+}
+
+static int overlap(ComoSsaCodegen *cg, ComoSsaInsn *a, ComoSsaInsn *b)
+{
+	ComoSsaLive *x = &cg->live[a->id], *y = &cg->live[b->id];
+	size_t i = 0, j = 0;
+
+	while(i < x->count && j < y->count) {
+		if(x->ranges[i].to <= y->ranges[j].from) {
+			i++;
+		} else if(y->ranges[j].to <= x->ranges[i].from) {
+			j++;
+		} else {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* Whether pos is strictly inside a range of value */
+static int covers(ComoSsaCodegen *cg, ComoSsaInsn *value, size_t pos)
+{
+	ComoSsaLive *live = &cg->live[value->id];
+	size_t i;
+
+	for(i = 0; i < live->count; i++) {
+		if(live->ranges[i].from < pos && pos < live->ranges[i].to) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Whether value can live in the register of slot: nothing else there
+ * while it does, no other value stored to the slot, and in a function no
+ * call that may come back and store to it
+ */
+static int fits_slot(ComoSsaCodegen *cg, ComoSsaInsn *value, unsigned int slot)
+{
+	size_t i, j;
+
+	for(i = 0; i < cg->nvalues; i++) {
+		ComoSsaInsn *other = cg->values[i];
+		if(other != value && other->reg == slot && overlap(cg, value, other)) {
+			return 0;
+		}
+	}
+
+	for(i = 0; i < cg->norder; i++) {
+		ComoSsaBlock *b = cg->order[i];
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+			if(insn->removed || !covers(cg, value, insn->pos)) {
+				continue;
+			}
+			if(insn->op == SSA_STORE_SLOT && insn->slot == slot
+					&& insn->args[0] != value) {
+				return 0;
+			}
+			if(insn->op == SSA_CALL && !cg->fn->top_level) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+static void assign_slots(ComoSsaCodegen *cg)
+{
+	size_t i, j;
+
+	for(i = 0; i < cg->norder; i++) {
+		ComoSsaBlock *b = cg->order[i];
+
+		for(j = 0; j < b->nphis; j++) {
+			ComoSsaInsn *phi = b->phis[j];
+			if(!phi->removed && phi->slot != REG_NONE
+					&& fits_slot(cg, phi, phi->slot)) {
+				phi->reg = phi->slot;
+			}
+		}
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j], *next = NULL;
+			size_t k;
+
+			if(insn->removed || !has_value(insn)) {
+				continue;
+			}
+
+			if(insn->op == SSA_LOAD_SLOT) {
+				if(fits_slot(cg, insn, insn->slot)) {
+					insn->reg = insn->slot;
+				}
+				continue;
+			}
+
+			if(insn->op == SSA_CONST || insn->op == SSA_UNDEFINED) {
+				continue;
+			}
+
+			for(k = j + 1; k < b->count; k++) {
+				if(!b->insns[k]->removed) {
+					next = b->insns[k];
+					break;
+				}
+			}
+
+			if(next != NULL && next->op == SSA_STORE_SLOT
+					&& next->args[0] == insn && fits_slot(cg, insn, next->slot)) {
+				insn->reg = next->slot;
+			}
+		}
+	}
+}
+
+static unsigned int constant_reg(ComoSsaCodegen *cg, Object *value)
+{
+	Array *constants = O_AVAL(cg->constants);
+	size_t i;
+
+	for(i = 0; i < constants->size; i++) {
+		if(constants->table[i] == value) {
+			return REG_CONSTANT | (unsigned int)i;
+		}
+	}
+
+	arrayPushEx(cg->constants, value);
+
+	return REG_CONSTANT | (unsigned int)(constants->size - 1);
+}
+
+static void assign_temps(ComoSsaCodegen *cg)
+{
+	ComoSsaInsn **assigned = malloc(sizeof(ComoSsaInsn *) * (cg->nvalues + 1));
+	unsigned int nslots = cg->reg->nslots;
+	size_t i, j, nassigned = 0;
+	unsigned int t;
+
+	for(i = 0; i < cg->nvalues; i++) {
+		ComoSsaInsn *value = cg->values[i];
+
+		if(value->op == SSA_CONST) {
+			value->reg = constant_reg(cg, value->constant);
+			continue;
+		}
+
+		if(value->reg != REG_NONE) {
+			continue;
+		}
+
+		for(t = 0; t < cg->ntemps; t++) {
+			for(j = 0; j < nassigned; j++) {
+				if(assigned[j]->reg == nslots + t
+						&& overlap(cg, assigned[j], value)) {
+					break;
+				}
+			}
+			if(j == nassigned) {
+				break;
+			}
+		}
+
+		if(t == cg->ntemps) {
+			cg->ntemps++;
+		}
+
+		value->reg = nslots + t;
+		assigned[nassigned++] = value;
+	}
+
+	free(assigned);
+}
+
+static void emit_jump(ComoSsaCodegen *cg, unsigned char op, unsigned int a,
+	ComoSsaBlock *target)
+{
+	if(cg->npatches == cg->patches_capacity) {
+		cg->patches_capacity = cg->patches_capacity ? cg->patches_capacity * 2 : 16;
+		cg->patches = realloc(cg->patches,
+			sizeof(ComoSsaPatch) * cg->patches_capacity);
+	}
+
+	cg->patches[cg->npatches].target = target;
+	cg->patches[cg->npatches].pc = como_reg_emit(cg->reg, op, 0, a, 0, 0, NULL);
+	cg->npatches++;
+}
+
+static int edge_has_copies(ComoSsaBlock *pred, ComoSsaBlock *b)
+{
+	size_t index = pred_index(b, pred), i;
+
+	for(i = 0; i < b->nphis; i++) {
+		ComoSsaInsn *phi = b->phis[i];
+		if(!phi->removed && phi->reg != phi->slot
+				&& phi->args[index]->reg != phi->reg) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* The phis of b all take their value from pred at once */
+static void emit_copies(ComoSsaCodegen *cg, ComoSsaBlock *pred, ComoSsaBlock *b)
+{
+	unsigned int scratch = cg->reg->nslots + cg->ntemps;
+	unsigned int dst[b->nphis + 1], src[b->nphis + 1];
+	unsigned char types[b->nphis + 1];
+	size_t index = pred_index(b, pred), n = 0, i, j, pc;
+
+	for(i = 0; i < b->nphis; i++) {
+		ComoSsaInsn *phi = b->phis[i];
+		if(!phi->removed && phi->reg != phi->slot
+				&& phi->args[index]->reg != phi->reg) {
+			dst[n] = phi->reg;
+			src[n] = phi->args[index]->reg;
+			types[n] = phi->type;
+			n++;
+		}
+	}
+
+	while(n > 0) {
+		for(i = 0; i < n; i++) {
+			for(j = 0; j < n; j++) {
+				if(src[j] == dst[i]) {
+					break;
+				}
+			}
+			if(j == n) {
+				break;
+			}
+		}
+
+		if(i == n) {
+			/* Every register left is still to be read, set one aside */
+			pc = como_reg_emit(cg->reg, REG_COPY, scratch, dst[0], 0, 0, NULL);
+			cg->reg->code[pc].type = REG_TYPE_ANY;
+			for(j = 0; j < n; j++) {
+				if(src[j] == dst[0]) {
+					src[j] = scratch;
+				}
+			}
+			cg->scratch = 1;
+			i = 0;
+		}
+
+		pc = como_reg_emit(cg->reg, REG_COPY, dst[i], src[i], 0, 0, NULL);
+		cg->reg->code[pc].type = types[i];
+		dst[i] = dst[n - 1];
+		src[i] = src[n - 1];
+		types[i] = types[n - 1];
+		n--;
+	}
+}
+
+/* Emits the instruction computing insn, annotated with its type */
+static size_t emit_value(ComoSsaCodegen *cg, ComoSsaInsn *insn,
+	unsigned char op, unsigned int a, unsigned int b, unsigned int c)
+{
+	size_t pc = como_reg_emit(cg->reg, op, insn->reg, a, b, c, insn->name);
+	cg->reg->code[pc].type = insn->type;
+	return pc;
+}
+
+static int both(ComoSsaInsn *insn, unsigned char type)
+{
+	return insn->args[0]->type == type && insn->args[1]->type == type;
+}
+
+/*
+ * Where the long insn computes can be written into an Object of the
+ * function each time, instead of a new one: nothing keeps it past its
+ * uses, and in a function no call comes while it lives, one that may come
+ * back and compute it again. Returns REG_NONE where it can't
+ */
+static unsigned int scratch_of(ComoSsaCodegen *cg, ComoSsaInsn *insn)
+{
+	ComoRegFunction *reg = cg->reg;
+	size_t i, j;
+
+	if(!como_ssa_only_read(cg->fn, insn)) {
+		return REG_NONE;
+	}
+
+	for(i = 0; i < cg->norder && !cg->fn->top_level; i++) {
+		ComoSsaBlock *b = cg->order[i];
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *other = b->insns[j];
+			if(!other->removed && other->op == SSA_CALL
+					&& covers(cg, insn, other->pos)) {
+				return REG_NONE;
+			}
+		}
+	}
+
+	reg->scratch = realloc(reg->scratch,
+		sizeof(Object *) * (reg->nscratch + 1));
+	reg->scratch[reg->nscratch] = newLong(0L);
+
+	return reg->nscratch++;
+}
+
+static void emit_insn(ComoSsaCodegen *cg, ComoSsaInsn *insn)
+{
+	ComoRegFunction *reg = cg->reg;
+	unsigned char op;
+	size_t i;
+
+	switch(insn->op) {
+		case SSA_CONST:
+		case SSA_PHI:
+		break;
+		case SSA_LOAD_SLOT:
+			if(insn->reg != insn->slot) {
+				emit_value(cg, insn, REG_COPY, insn->slot, 0, 0);
+			}
+		break;
+		case SSA_STORE_SLOT:
+			if(insn->args[0]->reg != insn->slot) {
+				size_t pc = como_reg_emit(reg, REG_COPY, insn->slot,
+					insn->args[0]->reg, 0, 0, NULL);
+				reg->code[pc].type = insn->args[0]->type;
+			}
+		break;
+		case SSA_LOAD_GLOBAL:
+			emit_value(cg, insn, REG_LOAD_GLOBAL, insn->slot, 0, 0);
+		break;
+		case SSA_LOAD_LOCAL_OR_GLOBAL:
+			emit_value(cg, insn, REG_LOAD_LOCAL_OR_GLOBAL, insn->args[0]->reg,
+				insn->slot, 0);
+		break;
+		case SSA_UNDEFINED:
+			como_reg_emit(reg, REG_UNDEFINED, 0, 0, 0, 0, insn->name);
+		break;
+		case SSA_CHECK:
+			como_reg_emit(reg, REG_CHECK, 0, insn->args[0]->reg, 0, 0, insn->name);
+		break;
+		case SSA_BINARY:
+			op = insn->binop;
+			if(both(insn, REG_TYPE_LONG)) {
+				emit_value(cg, insn, REG_ADD_LONG + (insn->binop - REG_ADD),
+					insn->args[0]->reg, insn->args[1]->reg, scratch_of(cg, insn));
+				break;
+			}
+			if(op == REG_ADD && both(insn, REG_TYPE_STRING)) {
+				op = REG_CONCAT;
+			}
+			emit_value(cg, insn, op, insn->args[0]->reg, insn->args[1]->reg, 0);
+		break;
+		case SSA_NEG:
+			if(insn->args[0]->type == REG_TYPE_LONG) {
+				emit_value(cg, insn, REG_NEG_LONG, insn->args[0]->reg, 0,
+					scratch_of(cg, insn));
+				break;
+			}
+			emit_value(cg, insn, REG_NEG, insn->args[0]->reg, 0, 0);
+		break;
+		case SSA_INC:
+		case SSA_DEC:
+			emit_value(cg, insn, insn->op == SSA_INC ? REG_INC : REG_DEC,
+				insn->args[0]->reg, 0, 0);
+		break;
+		case SSA_CALL: {
+			unsigned int args[insn->nargs];
+			unsigned int at;
+
+			for(i = 1; i < insn->nargs; i++) {
+				args[i - 1] = insn->args[i]->reg;
+			}
+			at = como_reg_emit_args(reg, args, insn->nargs - 1);
+			emit_value(cg, insn, REG_CALL, insn->args[0]->reg, at,
+				(unsigned int)(insn->nargs - 1));
+			break;
+		}
+		case SSA_PRINT:
+			como_reg_emit(reg, REG_PRINT, 0, insn->args[0]->reg, 0, 0, NULL);
+		break;
+		default:
+			como_error_noreturn("--ssa: unexpected instruction %d", insn->op);
+	}
+}
+
+static void emit_block(ComoSsaCodegen *cg, ComoSsaBlock *b, ComoSsaBlock *next)
+{
+	ComoRegFunction *reg = cg->reg;
+	ComoSsaBlock *taken, *not_taken;
+	unsigned char jz_op, jnz_op;
+	size_t i, jz;
+
+	cg->pcs[b->id] = reg->count;
+
+	for(i = 0; i < b->count; i++) {
+		if(!b->insns[i]->removed) {
+			emit_insn(cg, b->insns[i]);
+		}
+	}
+
+	switch(b->terminator) {
+		case SSA_JMP:
+			emit_copies(cg, b, b->succs[0]);
+			if(b->succs[0] != next) {
+				emit_jump(cg, REG_JMP, 0, b->succs[0]);
+			}
+		break;
+		case SSA_BRANCH:
+			taken = b->succs[0];
+			not_taken = b->succs[1];
+			jz_op = b->value->type == REG_TYPE_LONG ? REG_JZ_LONG : REG_JZ;
+			jnz_op = b->value->type == REG_TYPE_LONG ? REG_JNZ_LONG : REG_JNZ;
+
+			/* The bottom of a loop, falling out of it */
+			if(not_taken == next && taken != next
+					&& !edge_has_copies(b, taken)) {
+				emit_jump(cg, jnz_op, b->value->reg, taken);
+				emit_copies(cg, b, not_taken);
+				break;
+			}
+
+			if(!edge_has_copies(b, not_taken)) {
+				emit_jump(cg, jz_op, b->value->reg, not_taken);
+				emit_copies(cg, b, taken);
+				if(taken != next) {
+					emit_jump(cg, REG_JMP, 0, taken);
+				}
+				break;
+			}
+
+			/* The copies for the edge not taken go in between */
+			jz = como_reg_emit(reg, jz_op, 0, b->value->reg, 0, 0, NULL);
+			emit_copies(cg, b, taken);
+			emit_jump(cg, REG_JMP, 0, taken);
+			reg->code[jz].b = (unsigned int)reg->count;
+			emit_copies(cg, b, not_taken);
+			if(not_taken != next) {
+				emit_jump(cg, REG_JMP, 0, not_taken);
+			}
+		break;
+		case SSA_RETURN:
+			como_reg_emit(reg, REG_RETURN, 0, b->value->reg, 0, 0, NULL);
+		break;
+		default:
+			como_reg_emit(reg, REG_RETURN_NONE, 0, 0, 0, 0, NULL);
+		break;
+	}
+}
+
+void como_ssa_codegen(ComoSsaFunction *fn)
+{
+	ComoRegFunction *reg = fn->reg;
+	ComoSsaCodegen cg;
+	size_t i;
+
+	memset(&cg, 0, sizeof(cg));
+	cg.fn = fn;
+	cg.reg = reg;
+	cg.constants = fn->constants;
+
+	layout(&cg);
+	ranges(&cg);
+	assign_slots(&cg);
+	assign_temps(&cg);
+
+	cg.pcs = calloc(fn->nblocks + 1, sizeof(size_t));
+
+	for(i = 0; i < cg.norder; i++) {
+		emit_block(&cg, cg.order[i],
+			i + 1 < cg.norder ? cg.order[i + 1] : NULL);
+	}
+
+	for(i = 0; i < cg.npatches; i++) {
+		ComoRegOp *ins = &reg->code[cg.patches[i].pc];
+		unsigned int target = (unsigned int)cg.pcs[cg.patches[i].target->id];
+		if(ins->op == REG_JMP) {
+			ins->a = target;
+		} else {
+			ins->b = target;
+		}
+	}
+
+	reg->ntemps = cg.ntemps + (cg.scratch ? 1 : 0);
+
+	free(cg.order);
+	free(cg.values);
+	for(i = 0; i < fn->nvalues; i++) {
+		free(cg.live[i].ranges);
+	}
+	free(cg.live);
+	free(cg.pcs);
+	free(cg.patches);
+}
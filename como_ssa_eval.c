@@ -0,0 +1,516 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "como_register.h"
+#include "como_runtime.h"
+#include "como_ssa.h"
+
+/*
+ * Compile time evaluation. A call by name whose arguments are constants,
+ * to a function that does nothing but compute its result, is run here, on
+ * the SSA form, and replaced with what it returns.
+ *
+ * Such a function, evaluable, may loop and recurse, unlike a pure one, but
+ * reads no slot other than its parameters and only calls evaluable
+ * functions. Slots outlive a call, so the slots of every function entered
+ * are kept for the whole evaluation, and a call is left alone if one of
+ * them may still be running when it is made.
+ *
+ * Anything the runtime would report, a division by zero or an operand of
+ * the wrong type, and running out of steps or depth, leaves the call to
+ * run as it always did.
+ */
+#define EVAL_STEPS   100000   /* blocks run, in all */
+#define EVAL_DEPTH   256      /* nested calls */
+#define EVAL_STRING  4096     /* longest string a step may make */
+
+typedef struct ComoSsaFrameSlots {
+	ComoSsaFunction *fn;
+	Object         **slots;
+} ComoSsaFrameSlots;
+
+typedef struct ComoSsaEval {
+	size_t             steps;
+	size_t             depth;
+	ComoSsaFrameSlots *entered;
+	size_t             nentered;
+	Object           **made;     /* every Object made, freed once done */
+	size_t             nmade;
+	size_t             made_capacity;
+	int                failed;
+} ComoSsaEval;
+
+static Object *made(ComoSsaEval *ev, Object *value)
+{
+	if(ev->nmade == ev->made_capacity) {
+		ev->made_capacity = ev->made_capacity ? ev->made_capacity * 2 : 32;
+		ev->made = realloc(ev->made, sizeof(Object *) * ev->made_capacity);
+	}
+	ev->made[ev->nmade++] = value;
+	return value;
+}
+
+static Object **slots_of(ComoSsaEval *ev, ComoSsaFunction *fn)
+{
+	size_t i;
+
+	for(i = 0; i < ev->nentered; i++) {
+		if(ev->entered[i].fn == fn) {
+			return ev->entered[i].slots;
+		}
+	}
+
+	ev->entered = realloc(ev->entered, sizeof(ComoSsaFrameSlots)
+		* (ev->nentered + 1));
+	ev->entered[ev->nentered].fn = fn;
+	ev->entered[ev->nentered].slots = calloc(fn->nslots + 1, sizeof(Object *));
+
+	return ev->entered[ev->nentered++].slots;
+}
+
+static Object *fail(ComoSsaEval *ev)
+{
+	ev->failed = 1;
+	return NULL;
+}
+
+/* What BINARY and NEG compute, where the runtime wouldn't report an error */
+static Object *eval_operator(ComoSsaEval *ev, ComoSsaInsn *insn,
+	Object *left, Object *right)
+{
+	Object *value;
+	int longs;
+
+	if(left == NULL || (insn->op == SSA_BINARY && right == NULL)) {
+		return fail(ev);
+	}
+
+	if(insn->op != SSA_BINARY) {
+		if(O_TYPE(left) != IS_LONG) {
+			return fail(ev);
+		}
+		return made(ev, newLong(insn->op == SSA_NEG ? -O_LVAL(left)
+			: O_LVAL(left) + (insn->op == SSA_INC ? 1 : -1)));
+	}
+
+	longs = O_TYPE(left) == IS_LONG && O_TYPE(right) == IS_LONG;
+
+	switch(insn->binop) {
+		case REG_ADD:
+			value = made(ev, como_rt_add(left, right));
+			if(O_TYPE(value) == IS_STRING
+					&& O_SVAL(value)->length > EVAL_STRING) {
+				return fail(ev);
+			}
+		return value;
+		case REG_SUB:
+		case REG_MUL:
+			if(!longs) {
+				return fail(ev);
+			}
+			return made(ev, insn->binop == REG_SUB ? como_rt_minus(left, right)
+				: como_rt_times(left, right));
+		case REG_DIV:
+		case REG_REM:
+			if(!longs || O_LVAL(right) == 0) {
+				return fail(ev);
+			}
+			return made(ev, insn->binop == REG_DIV ? como_rt_div(left, right)
+				: como_rt_rem(left, right));
+		case REG_LT:  return made(ev, como_rt_is_less_than(left, right));
+		case REG_LTE: return made(ev, como_rt_is_less_than_or_equal(left, right));
+		case REG_GT:  return made(ev, como_rt_is_greater_than(left, right));
+		case REG_GTE: return made(ev, como_rt_is_greater_than_or_equal(left,
+			right));
+		case REG_EQ:  return made(ev, como_rt_is_equal(left, right));
+		case REG_NEQ: return made(ev, como_rt_is_not_equal(left, right));
+	}
+
+	return fail(ev);
+}
+
+static Object *eval_call(ComoSsaEval *ev, ComoSsaFunction *fn, Object **args);
+
+static Object *value_of(Object **values, ComoSsaInsn *insn)
+{
+	insn = como_ssa_resolve(insn);
+	return insn->op == SSA_CONST ? insn->constant : values[insn->id];
+}
+
+static int eval_insn(ComoSsaEval *ev, Object **slots, Object **values,
+	ComoSsaInsn *insn)
+{
+	Object *value = NULL;
+	size_t i;
+
+	switch(insn->op) {
+		case SSA_CONST:
+			return 1;
+		case SSA_LOAD_SLOT:
+			value = slots[insn->slot];
+		break;
+		case SSA_STORE_SLOT:
+			slots[insn->slot] = value_of(values, insn->args[0]);
+		return slots[insn->slot] != NULL;
+		/* The function called, only ever read by the CALL */
+		case SSA_LOAD_GLOBAL:
+		return 1;
+		case SSA_CHECK:
+		return value_of(values, insn->args[0]) != NULL;
+		case SSA_COPY:
+			value = value_of(values, insn->args[0]);
+		break;
+		case SSA_BINARY:
+			value = eval_operator(ev, insn, value_of(values, insn->args[0]),
+				value_of(values, insn->args[1]));
+		break;
+		case SSA_NEG:
+		case SSA_INC:
+		case SSA_DEC:
+			value = eval_operator(ev, insn, value_of(values, insn->args[0]),
+				NULL);
+		break;
+		case SSA_CALL: {
+			Object **args = malloc(sizeof(Object *) * insn->nargs);
+			for(i = 1; i < insn->nargs; i++) {
+				args[i - 1] = value_of(values, insn->args[i]);
+				if(args[i - 1] == NULL) {
+					free(args);
+					return 0;
+				}
+			}
+			value = eval_call(ev, insn->callee, args);
+			free(args);
+			break;
+		}
+		default:
+		return 0;
+	}
+
+	values[insn->id] = value;
+
+	return value != NULL;
+}
+
+static Object *eval_call(ComoSsaEval *ev, ComoSsaFunction *fn, Object **args)
+{
+	ComoRegFunction *reg = fn->reg;
+	Object **slots = slots_of(ev, fn);
+	Object **values, **incoming, *result = NULL;
+	ComoSsaBlock *b = fn->entry, *pred = NULL;
+	size_t i, j;
+
+	if(!fn->evaluable || ++ev->depth > EVAL_DEPTH) {
+		return fail(ev);
+	}
+
+	for(i = 0; i < reg->parameters; i++) {
+		slots[reg->parameter_regs[i]] = args[i];
+	}
+	slots[reg->function_name_reg] = reg->name_value;
+
+	values = calloc(fn->nvalues, sizeof(Object *));
+	incoming = malloc(sizeof(Object *) * (fn->nvalues + 1));
+
+	while(!ev->failed) {
+		if(ev->steps == 0) {
+			fail(ev);
+			break;
+		}
+		ev->steps--;
+
+		/* Every phi reads what its edge brings, before any is set */
+		if(pred != NULL) {
+			for(i = 0; i < b->npreds && b->preds[i] != pred; i++)
+				;
+			for(j = 0; j < b->nphis; j++) {
+				ComoSsaInsn *phi = b->phis[j];
+				if(!phi->removed) {
+					incoming[j] = value_of(values, phi->args[i]);
+				}
+			}
+			for(j = 0; j < b->nphis; j++) {
+				if(!b->phis[j]->removed) {
+					values[b->phis[j]->id] = incoming[j];
+				}
+			}
+		}
+
+		for(j = 0; j < b->count && !ev->failed; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+			if(!insn->removed && !eval_insn(ev, slots, values, insn)) {
+				fail(ev);
+			}
+		}
+
+		if(ev->failed) {
+			break;
+		}
+
+		pred = b;
+		if(b->terminator == SSA_JMP) {
+			b = b->succs[0];
+		} else if(b->terminator == SSA_BRANCH) {
+			Object *condition = value_of(values, b->value);
+			if(condition == NULL) {
+				fail(ev);
+				break;
+			}
+			b = como_rt_is_false(condition) ? b->succs[1] : b->succs[0];
+		} else {
+			result = b->terminator == SSA_RETURN ? value_of(values, b->value)
+				: made(ev, newLong(0L));
+			if(result == NULL) {
+				fail(ev);
+			}
+			break;
+		}
+	}
+
+	free(values);
+	free(incoming);
+	ev->depth--;
+
+	return ev->failed ? NULL : result;
+}
+
+/* What fn does besides computing its result, given what is known so far */
+static int may_evaluate(ComoSsaFunction *fn)
+{
+	ComoRegFunction *reg = fn->reg;
+	size_t i, j;
+
+	if(fn->top_level) {
+		return 0;
+	}
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		int parameter = 0;
+
+		if(insn->removed) {
+			continue;
+		}
+
+		switch(insn->op) {
+			case SSA_CONST:
+			case SSA_STORE_SLOT:
+			case SSA_CHECK:
+			case SSA_COPY:
+			case SSA_PHI:
+			case SSA_BINARY:
+			case SSA_NEG:
+			case SSA_INC:
+			case SSA_DEC:
+			break;
+			case SSA_LOAD_SLOT:
+				for(j = 0; j < reg->parameters; j++) {
+					parameter |= reg->parameter_regs[j] == insn->slot;
+				}
+				if(!parameter && insn->slot != reg->function_name_reg) {
+					return 0;
+				}
+			break;
+			case SSA_LOAD_GLOBAL:
+				if(insn->callee == NULL) {
+					return 0;
+				}
+			break;
+			case SSA_CALL:
+				if(insn->callee == NULL || !insn->callee->evaluable
+						|| insn->nargs - 1 != insn->callee->reg->parameters) {
+					return 0;
+				}
+			break;
+			default:
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Recursion is fine, a function is until it calls one that isn't */
+static void find_evaluable(ComoSsaFunction **functions, size_t count)
+{
+	int changed = 1;
+	size_t i;
+
+	for(i = 0; i < count; i++) {
+		functions[i]->evaluable = !functions[i]->top_level;
+	}
+
+	while(changed) {
+		changed = 0;
+		for(i = 0; i < count; i++) {
+			ComoSsaFunction *fn = functions[i];
+			if(fn->evaluable && !may_evaluate(fn)) {
+				fn->evaluable = 0;
+				changed = 1;
+			}
+		}
+	}
+}
+
+/* Whether from may call to, through any number of calls */
+static int reaches(ComoSsaFunction *from, ComoSsaFunction *to,
+	ComoSsaFunction **seen, size_t *nseen)
+{
+	size_t i;
+
+	if(from == to) {
+		return 1;
+	}
+
+	for(i = 0; i < *nseen; i++) {
+		if(seen[i] == from) {
+			return 0;
+		}
+	}
+	seen[(*nseen)++] = from;
+
+	for(i = 0; i < from->nvalues; i++) {
+		ComoSsaInsn *insn = from->values[i];
+		if(!insn->removed && insn->op == SSA_CALL && insn->callee != NULL
+				&& reaches(insn->callee, to, seen, nseen)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * The constant a value is, when it's known, a fresh one made for it below
+ * included
+ */
+static Object *constant_of(ComoSsaEval *ev, ComoSsaInsn *insn)
+{
+	Object *left, *right = NULL;
+
+	insn = como_ssa_resolve(insn);
+
+	if(insn->op == SSA_CONST) {
+		return insn->constant;
+	}
+
+	if(insn->op != SSA_BINARY && insn->op != SSA_NEG && insn->op != SSA_INC
+			&& insn->op != SSA_DEC) {
+		return NULL;
+	}
+
+	left = constant_of(ev, insn->args[0]);
+	if(insn->op == SSA_BINARY) {
+		right = constant_of(ev, insn->args[1]);
+	}
+
+	return eval_operator(ev, insn, left, right);
+}
+
+static void evaluate_call(ComoSsaFunction *fn, ComoSsaInsn *insn,
+	size_t count)
+{
+	ComoSsaEval ev;
+	ComoSsaFunction **seen;
+	Object **args, *result = NULL;
+	size_t i, j;
+
+	memset(&ev, 0, sizeof(ComoSsaEval));
+	ev.steps = EVAL_STEPS;
+
+	args = malloc(sizeof(Object *) * insn->nargs);
+	for(i = 1; i < insn->nargs; i++) {
+		args[i - 1] = constant_of(&ev, insn->args[i]);
+		if(args[i - 1] == NULL) {
+			fail(&ev);
+			break;
+		}
+	}
+
+	if(!ev.failed) {
+		result = eval_call(&ev, insn->callee, args);
+	}
+
+	if(result != NULL && O_TYPE(result) != IS_LONG
+			&& O_TYPE(result) != IS_STRING) {
+		result = NULL;
+	}
+
+	/* The slots of a function still running would have been changed */
+	seen = malloc(sizeof(ComoSsaFunction *) * count);
+	for(i = 0; result != NULL && fn->evaluable && i < ev.nentered; i++) {
+		size_t nseen = 0;
+		if(reaches(ev.entered[i].fn, fn, seen, &nseen)) {
+			result = NULL;
+		}
+	}
+	free(seen);
+
+	if(result != NULL) {
+		insn->op = SSA_CONST;
+		insn->constant = result;
+		insn->nargs = 0;
+		insn->type = O_TYPE(result) == IS_LONG ? REG_TYPE_LONG
+			: REG_TYPE_STRING;
+		insn->nonnull = 1;
+		insn->callee = NULL;
+		fn->evaluated++;
+	}
+
+	for(i = 0; i < ev.nmade; i++) {
+		if(ev.made[i] != result) {
+			objectDestroy(ev.made[i]);
+		}
+	}
+	for(j = 0; j < ev.nentered; j++) {
+		free(ev.entered[j].slots);
+	}
+	free(ev.made);
+	free(ev.entered);
+	free(args);
+}
+
+void como_ssa_evaluate(ComoSsaFunction **functions, size_t count)
+{
+	size_t i, j;
+
+	find_evaluable(functions, count);
+
+	for(i = 0; i < count; i++) {
+		ComoSsaFunction *fn = functions[i];
+		size_t before = fn->evaluated;
+
+		/* By id, so a call's arguments are evaluated before it */
+		for(j = 0; j < fn->nvalues; j++) {
+			ComoSsaInsn *insn = fn->values[j];
+			if(!insn->removed && insn->op == SSA_CALL && insn->callee != NULL
+					&& insn->callee->evaluable
+					&& insn->nargs - 1 == insn->callee->reg->parameters) {
+				evaluate_call(fn, insn, count);
+			}
+		}
+
+		if(fn->evaluated != before) {
+			como_ssa_cleanup(fn);
+		}
+	}
+}
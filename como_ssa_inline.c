@@ -0,0 +1,433 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "como_register.h"
+#include "como_ssa.h"
+#include "como_compiler_ex.h"
+
+/*
+ * Inlining. A call to a function by its name is replaced with a copy of the
+ * function's body, where its parameters are the arguments and its returns
+ * jump to what follows the call.
+ *
+ * Slots live on between calls, so a function is only inlined if nothing it
+ * stores could be read by a later call of it: it may only read parameters
+ * it doesn't assign, and call nothing but pure functions, that can't call
+ * it back. What it stores is then dropped. It must also have
+ * no loops, always return a value, and be small, see --inline-limit.
+ *
+ * Functions are inlined into in the order they call each other, so what is
+ * copied is already what was inlined into it.
+ */
+
+#define COMO_SSA_INLINE_NONE      0
+#define COMO_SSA_INLINE_STARTED   1
+#define COMO_SSA_INLINE_DONE      2
+
+static const char too_large[] = "too large";
+
+static int is_parameter(ComoRegFunction *reg, unsigned int slot)
+{
+	size_t i;
+
+	for(i = 0; i < reg->parameters; i++) {
+		if(reg->parameter_regs[i] == slot) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* With only pure calls, nothing else changes a parameter's slot */
+static int assigns(ComoSsaFunction *fn, unsigned int slot)
+{
+	size_t i;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		if(!insn->removed && insn->op == SSA_STORE_SLOT && insn->slot == slot) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Why a call can't be inlined, or NULL, with the size of its callee */
+static const char *why_not(ComoSsaFunction *fn, ComoSsaInsn *call,
+	size_t *size)
+{
+	ComoSsaFunction *callee = call->callee;
+	ComoRegFunction *reg;
+	size_t i, j;
+
+	*size = 0;
+
+	if(callee == NULL) {
+		return "not called by the name of one function";
+	}
+
+	reg = callee->reg;
+
+	if(como_options.inline_limit == 0) {
+		return "inlining is off";
+	}
+	if(callee == fn) {
+		return "recursive";
+	}
+	if(call->nargs - 1 != reg->parameters) {
+		return "wrong number of arguments";
+	}
+	if(callee->nloops > 0) {
+		return "has a loop";
+	}
+
+	for(i = 0; i < callee->nblocks; i++) {
+		ComoSsaBlock *b = callee->blocks[i];
+
+		if(!b->reachable) {
+			continue;
+		}
+		if(b->terminator == SSA_RETURN_NONE) {
+			return "may return nothing";
+		}
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *insn = b->insns[j];
+
+			if(insn->removed) {
+				continue;
+			}
+
+			switch(insn->op) {
+				case SSA_CONST:
+				case SSA_STORE_SLOT:
+				break;
+				case SSA_LOAD_SLOT:
+					if(insn->slot == reg->function_name_reg) {
+						break;
+					}
+					if(!is_parameter(reg, insn->slot)) {
+						return "reads a name an earlier call may have set";
+					}
+					if(assigns(callee, insn->slot)) {
+						return "reads a parameter it assigned";
+					}
+				break;
+				case SSA_CALL:
+					if(insn->callee == callee) {
+						return "recursive";
+					}
+					if(!como_ssa_is_pure(insn)) {
+						return "calls a function that isn't pure";
+					}
+					(*size)++;
+				break;
+				default:
+					(*size)++;
+				break;
+			}
+		}
+	}
+
+	if(*size > (size_t)como_options.inline_limit) {
+		return too_large;
+	}
+
+	return NULL;
+}
+
+/* Replaces call, insns[index] of b, with a copy of its callee */
+static void inline_call(ComoSsaFunction *fn, ComoSsaBlock *b, size_t index,
+	ComoSsaBlock **rest_of)
+{
+	ComoSsaInsn *call = b->insns[index], *result = NULL, *phi;
+	ComoSsaFunction *callee = call->callee;
+	ComoRegFunction *reg = callee->reg;
+	ComoSsaBlock **blocks = calloc(callee->nblocks, sizeof(ComoSsaBlock *));
+	ComoSsaInsn **values = calloc(callee->nvalues, sizeof(ComoSsaInsn *));
+	ComoSsaBlock *rest;
+	size_t i, j, k, returns = 0;
+
+	for(i = 0; i < callee->nblocks; i++) {
+		if(callee->blocks[i]->reachable) {
+			blocks[i] = como_ssa_new_block(fn);
+		}
+	}
+	rest = como_ssa_new_block(fn);
+	*rest_of = rest;
+
+	/* What follows the call goes on after the copy */
+	for(i = index + 1; i < b->count; i++) {
+		if(rest->count == rest->capacity) {
+			rest->capacity = rest->capacity ? rest->capacity * 2 : 8;
+			rest->insns = realloc(rest->insns,
+				sizeof(ComoSsaInsn *) * rest->capacity);
+		}
+		rest->insns[rest->count++] = b->insns[i];
+		b->insns[i]->block = rest;
+	}
+	b->count = index + 1;
+
+	rest->terminator = b->terminator;
+	rest->value = b->value;
+	for(i = 0; i < b->nsuccs; i++) {
+		ComoSsaBlock *succ = b->succs[i];
+		rest->succs[rest->nsuccs++] = succ;
+		for(j = 0; j < succ->npreds; j++) {
+			if(succ->preds[j] == b) {
+				succ->preds[j] = rest;
+			}
+		}
+	}
+	b->nsuccs = 0;
+	b->terminator = SSA_JMP;
+	b->value = NULL;
+	como_ssa_add_pred(blocks[callee->entry->id], b);
+
+	for(i = 0; i < fn->nloops; i++) {
+		if(fn->loops[i].latch == b) {
+			fn->loops[i].latch = rest;
+		}
+	}
+
+	/* Every value first, an operand may be computed in a later block */
+	for(i = 0; i < callee->nblocks; i++) {
+		ComoSsaBlock *from = callee->blocks[i];
+
+		if(!from->reachable) {
+			continue;
+		}
+
+		for(j = 0; j < from->nphis; j++) {
+			ComoSsaInsn *insn = from->phis[j];
+			if(!insn->removed) {
+				phi = como_ssa_add_phi(fn, blocks[i]);
+				phi->name = insn->name;
+				phi->type = insn->type;
+				phi->nonnull = insn->nonnull;
+				values[insn->id] = phi;
+			}
+		}
+
+		for(j = 0; j < from->count; j++) {
+			ComoSsaInsn *insn = from->insns[j], *copy;
+
+			if(insn->removed || insn->op == SSA_STORE_SLOT) {
+				continue;
+			}
+
+			if(insn->op == SSA_LOAD_SLOT) {
+				if(insn->slot == reg->function_name_reg) {
+					copy = como_ssa_append(fn, blocks[i], SSA_CONST);
+					copy->constant = reg->name_value;
+					copy->type = REG_TYPE_STRING;
+					copy->nonnull = 1;
+					values[insn->id] = copy;
+					continue;
+				}
+				for(k = 0; reg->parameter_regs[k] != insn->slot; k++)
+					;
+				values[insn->id] = call->args[k + 1];
+				continue;
+			}
+
+			copy = como_ssa_append(fn, blocks[i], insn->op);
+			copy->binop = insn->binop;
+			copy->nonnull = insn->nonnull;
+			copy->type = insn->type;
+			copy->constant = insn->constant;
+			copy->slot = insn->slot;
+			copy->name = insn->name;
+			copy->callee = insn->callee;
+			values[insn->id] = copy;
+		}
+	}
+
+	for(i = 0; i < callee->nvalues; i++) {
+		ComoSsaInsn *insn = callee->values[i];
+		if(values[i] == NULL || insn->op == SSA_PHI
+				|| insn->op == SSA_LOAD_SLOT) {
+			continue;
+		}
+		for(j = 0; j < insn->nargs; j++) {
+			como_ssa_add_arg(values[i],
+				values[como_ssa_resolve(insn->args[j])->id]);
+		}
+	}
+
+	/* Then the edges, in the order of the successors of each block */
+	for(i = 0; i < callee->nblocks; i++) {
+		ComoSsaBlock *from = callee->blocks[i];
+
+		if(!from->reachable) {
+			continue;
+		}
+
+		switch(from->terminator) {
+			case SSA_BRANCH:
+				blocks[i]->value = values[como_ssa_resolve(from->value)->id];
+				/* Fall through */
+			case SSA_JMP:
+				blocks[i]->terminator = from->terminator;
+				for(j = 0; j < from->nsuccs; j++) {
+					como_ssa_add_pred(blocks[from->succs[j]->id], blocks[i]);
+				}
+			break;
+			default:
+				blocks[i]->terminator = SSA_JMP;
+				como_ssa_add_pred(rest, blocks[i]);
+				result = values[como_ssa_resolve(from->value)->id];
+				returns++;
+			break;
+		}
+	}
+
+	/* A phi's operands in the order its copy's predecessors came out */
+	for(i = 0; i < callee->nblocks; i++) {
+		ComoSsaBlock *from = callee->blocks[i];
+
+		if(!from->reachable) {
+			continue;
+		}
+
+		for(j = 0; j < from->nphis; j++) {
+			ComoSsaInsn *insn = from->phis[j];
+
+			if(insn->removed) {
+				continue;
+			}
+
+			for(k = 0; k < blocks[i]->npreds; k++) {
+				size_t p;
+				for(p = 0; blocks[from->preds[p]->id] != blocks[i]->preds[k]; p++)
+					;
+				como_ssa_add_arg(values[insn->id],
+					values[como_ssa_resolve(insn->args[p])->id]);
+			}
+		}
+	}
+
+	if(returns > 1) {
+		phi = como_ssa_add_phi(fn, rest);
+		phi->name = callee->name;
+		phi->type = call->type;
+		phi->nonnull = 1;
+		for(i = 0; i < callee->nblocks; i++) {
+			ComoSsaBlock *from = callee->blocks[i];
+			if(from->reachable && from->terminator == SSA_RETURN) {
+				como_ssa_add_arg(phi, values[como_ssa_resolve(from->value)->id]);
+			}
+		}
+		result = phi;
+	}
+
+	call->removed = 1;
+	call->replacement = result;
+	fn->inlined++;
+
+	free(blocks);
+	free(values);
+}
+
+static void inline_function(ComoSsaFunction *fn)
+{
+	ComoSsaBlock **scan;
+	size_t count = 0, i, j;
+
+	if(fn->inline_state != COMO_SSA_INLINE_NONE) {
+		return;
+	}
+	fn->inline_state = COMO_SSA_INLINE_STARTED;
+
+	/* What is copied has what it calls inlined already */
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		if(!insn->removed && insn->op == SSA_CALL && insn->callee != NULL) {
+			inline_function(insn->callee);
+		}
+	}
+
+	/* Blocks of copies are not looked at again, what follows a call is */
+	scan = malloc(sizeof(ComoSsaBlock *) * (fn->nblocks + 1));
+	for(i = 0; i < fn->nblocks; i++) {
+		if(fn->blocks[i]->reachable) {
+			scan[count++] = fn->blocks[i];
+		}
+	}
+
+	for(i = 0; i < count; i++) {
+		ComoSsaBlock *b = scan[i], *rest;
+
+		for(j = 0; j < b->count; j++) {
+			ComoSsaInsn *call = b->insns[j];
+			const char *reason;
+			size_t size;
+
+			if(call->removed || call->op != SSA_CALL) {
+				continue;
+			}
+
+			reason = why_not(fn, call, &size);
+
+			if(como_options.inline_report) {
+				const char *name = call->args[0]->name != NULL
+					? call->args[0]->name : "a value";
+				if(reason == NULL) {
+					fprintf(stderr, "%s: call to %s inlined, %zu instructions\n",
+						fn->name, name, size);
+				} else if(reason == too_large) {
+					fprintf(stderr, "%s: call to %s not inlined, %s, "
+						"%zu instructions\n", fn->name, name, reason, size);
+				} else {
+					fprintf(stderr, "%s: call to %s not inlined, %s\n", fn->name,
+						name, reason);
+				}
+			}
+
+			if(reason == NULL) {
+				inline_call(fn, b, j, &rest);
+				scan = realloc(scan, sizeof(ComoSsaBlock *) * (count + 1));
+				scan[count++] = rest;
+				break;
+			}
+		}
+	}
+
+	free(scan);
+
+	/* Slots read after the calls inlined may be known now */
+	if(fn->inlined > 0) {
+		como_ssa_cleanup(fn);
+		como_ssa_forward_loads(fn);
+	}
+
+	fn->inline_state = COMO_SSA_INLINE_DONE;
+}
+
+void como_ssa_inline(ComoSsaFunction **functions, size_t count)
+{
+	size_t i;
+
+	for(i = 0; i < count; i++) {
+		inline_function(functions[i]);
+	}
+}
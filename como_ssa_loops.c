@@ -0,0 +1,192 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "como_register.h"
+#include "como_ssa.h"
+
+/*
+ * Loop invariant code motion. A pure instruction, see como_ssa_is_pure,
+ * whose operands are all computed before a loop computes the same value in
+ * every iteration, and is moved to the loop's preheader. Loops are rotated
+ * when lowered, so the preheader only runs when the body does. Values are
+ * never changed in place, POSTFIX_INC binds its name to a new long, so the
+ * same value is the same Object wherever it is read.
+ *
+ * A call is only hoisted from a block that dominates the latch, one every
+ * iteration runs: hoisted from under an if, a call the loop might never
+ * make would be made anyway. A call in a conditional stays in its block.
+ */
+
+/* The blocks of loop, whatever leads to its latch without its header */
+static void find_blocks(ComoSsaFunction *fn, ComoSsaLoop *loop,
+	unsigned char *in_loop)
+{
+	ComoSsaBlock **worklist = malloc(sizeof(ComoSsaBlock *) * fn->nblocks);
+	size_t count = 0, i;
+
+	memset(in_loop, 0, fn->nblocks);
+
+	in_loop[loop->header->id] = 1;
+	if(!in_loop[loop->latch->id]) {
+		in_loop[loop->latch->id] = 1;
+		worklist[count++] = loop->latch;
+	}
+
+	while(count > 0) {
+		ComoSsaBlock *b = worklist[--count];
+		for(i = 0; i < b->npreds; i++) {
+			if(!in_loop[b->preds[i]->id]) {
+				in_loop[b->preds[i]->id] = 1;
+				worklist[count++] = b->preds[i];
+			}
+		}
+	}
+
+	free(worklist);
+}
+
+/* Whether every way from the loop's header to its latch goes through b */
+static int dominates_latch(ComoSsaFunction *fn, ComoSsaLoop *loop,
+	unsigned char *in_loop, ComoSsaBlock *b)
+{
+	ComoSsaBlock **worklist;
+	unsigned char *seen;
+	size_t count = 0, i;
+	int dominates = 1;
+
+	if(b == loop->header || b == loop->latch) {
+		return 1;
+	}
+
+	worklist = malloc(sizeof(ComoSsaBlock *) * fn->nblocks);
+	seen = calloc(fn->nblocks, 1);
+
+	seen[b->id] = 1;
+	seen[loop->latch->id] = 1;
+	worklist[count++] = loop->latch;
+
+	while(count > 0 && dominates) {
+		ComoSsaBlock *from = worklist[--count];
+		for(i = 0; i < from->npreds; i++) {
+			ComoSsaBlock *pred = from->preds[i];
+			if(pred == loop->header) {
+				dominates = 0;
+				break;
+			}
+			if(in_loop[pred->id] && !seen[pred->id]) {
+				seen[pred->id] = 1;
+				worklist[count++] = pred;
+			}
+		}
+	}
+
+	free(seen);
+	free(worklist);
+
+	return dominates;
+}
+
+static int can_hoist(ComoSsaFunction *fn, ComoSsaLoop *loop,
+	unsigned char *in_loop, ComoSsaInsn *insn)
+{
+	size_t i;
+
+	if(insn->removed || insn->op == SSA_CONST || !como_ssa_is_pure(insn)) {
+		return 0;
+	}
+
+	if(insn->op == SSA_CALL && !dominates_latch(fn, loop, in_loop, 
+			insn->block)) {
+		return 0;
+	}
+
+	for(i = 0; i < insn->nargs; i++) {
+		ComoSsaInsn *arg = insn->args[i];
+		if(arg->op != SSA_CONST && in_loop[arg->block->id]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void move(ComoSsaBlock *b, size_t index, ComoSsaBlock *to)
+{
+	ComoSsaInsn *insn = b->insns[index];
+
+	memmove(&b->insns[index], &b->insns[index + 1],
+		sizeof(ComoSsaInsn *) * (b->count - index - 1));
+	b->count--;
+
+	if(to->count == to->capacity) {
+		to->capacity = to->capacity ? to->capacity * 2 : 8;
+		to->insns = realloc(to->insns, sizeof(ComoSsaInsn *) * to->capacity);
+	}
+	to->insns[to->count++] = insn;
+	insn->block = to;
+}
+
+void como_ssa_hoist(ComoSsaFunction *fn)
+{
+	unsigned char *in_loop;
+	size_t l, i, j;
+
+	if(fn->nloops == 0) {
+		return;
+	}
+
+	in_loop = malloc(fn->nblocks);
+
+	/* Inner loops first, what leaves one may then leave the next */
+	for(l = 0; l < fn->nloops; l++) {
+		ComoSsaLoop *loop = &fn->loops[l];
+		int moved = 1;
+
+		if(!loop->preheader->reachable || !loop->header->reachable
+				|| !loop->latch->reachable) {
+			continue;
+		}
+
+		find_blocks(fn, loop, in_loop);
+
+		while(moved) {
+			moved = 0;
+			for(i = 0; i < fn->nblocks; i++) {
+				ComoSsaBlock *b = fn->blocks[i];
+
+				if(!in_loop[b->id]) {
+					continue;
+				}
+
+				for(j = 0; j < b->count; j++) {
+					if(can_hoist(fn, loop, in_loop, b->insns[j])) {
+						move(b, j--, loop->preheader);
+						fn->hoisted++;
+						moved = 1;
+					}
+				}
+			}
+		}
+	}
+
+	free(in_loop);
+}
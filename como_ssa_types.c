@@ -0,0 +1,460 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <object.h>
+
+#include "como_register.h"
+#include "como_ssa.h"
+
+/*
+ * Type inference over the SSA form of the whole program. Every value is a
+ * long, a string, or anything, REG_TYPE_ANY. Values start out as
+ * REG_TYPE_NONE, nothing reaching them yet, and only ever move up until
+ * nothing changes:
+ *
+ *   - arithmetic and comparisons always make a long, or fail
+ *   - + makes a long of two longs, and a string as soon as either is one
+ *   - a phi is whatever comes into it
+ *   - a slot holds whatever the function stores to it, or is passed in it
+ *   - a top level name is read in a function as whatever __main__ stores
+ *
+ * A function called by its name, that is only ever called that way, takes
+ * the types passed at its call sites as those of its parameters, and the
+ * call the type of what it returns. Any other call makes anything.
+ */
+
+static unsigned char join(unsigned char a, unsigned char b)
+{
+	if(a == REG_TYPE_NONE) {
+		return b;
+	}
+	if(b == REG_TYPE_NONE || a == b) {
+		return a;
+	}
+	return REG_TYPE_ANY;
+}
+
+typedef struct ComoSsaProgram {
+	ComoSsaFunction **functions;
+	size_t            count;
+	ComoSsaFunction  *main;
+	ComoSsaFunction **by_slot;     /* the function a top level slot names */
+} ComoSsaProgram;
+
+/*
+ * The function a value is, if it is read from the top level name of a
+ * function that nothing else is stored to
+ */
+static ComoSsaFunction *function_of(ComoSsaProgram *program,
+	ComoSsaFunction *fn, ComoSsaInsn *value)
+{
+	if((value->op == SSA_LOAD_SLOT && fn->top_level)
+			|| value->op == SSA_LOAD_GLOBAL) {
+		return program->by_slot[value->slot];
+	}
+	return NULL;
+}
+
+/* Which top level names call a function by name, and nothing else */
+static void find_functions(ComoSsaProgram *program)
+{
+	ComoSsaFunction *main = program->main;
+	size_t i;
+
+	program->by_slot = calloc(main->nslots + 1, sizeof(ComoSsaFunction *));
+
+	for(i = 0; i + 1 < program->count; i++) {
+		ComoSsaFunction *fn = program->functions[i];
+		Object *index = mapSearch(main->slots, fn->name);
+		unsigned int slot = (unsigned int)O_LVAL(index);
+
+		/* Declared twice, which one a call finds depends on the order */
+		if(program->by_slot[slot] != NULL) {
+			program->by_slot[slot]->escapes = 1;
+			fn->escapes = 1;
+		}
+		program->by_slot[slot] = fn;
+	}
+
+	/* A name __main__ assigns may hold anything */
+	for(i = 0; i < main->nvalues; i++) {
+		ComoSsaInsn *insn = main->values[i];
+		if(!insn->removed && insn->op == SSA_STORE_SLOT
+				&& program->by_slot[insn->slot] != NULL) {
+			program->by_slot[insn->slot]->escapes = 1;
+			program->by_slot[insn->slot] = NULL;
+		}
+	}
+}
+
+static void escape(ComoSsaProgram *program, ComoSsaFunction *fn,
+	ComoSsaInsn *value)
+{
+	ComoSsaFunction *target = function_of(program, fn, value);
+
+	if(target != NULL) {
+		target->escapes = 1;
+	}
+}
+
+/* Functions whose value is passed, stored or returned may be called by it */
+static void find_escapes(ComoSsaProgram *program)
+{
+	size_t f, i, j;
+
+	for(f = 0; f < program->count; f++) {
+		ComoSsaFunction *fn = program->functions[f];
+
+		for(i = 0; i < fn->nvalues; i++) {
+			ComoSsaInsn *insn = fn->values[i];
+
+			if(insn->removed) {
+				continue;
+			}
+
+			switch(insn->op) {
+				case SSA_CALL:
+					for(j = 1; j < insn->nargs; j++) {
+						escape(program, fn, insn->args[j]);
+					}
+				break;
+				case SSA_STORE_SLOT:
+				case SSA_PHI:
+					for(j = 0; j < insn->nargs; j++) {
+						escape(program, fn, insn->args[j]);
+					}
+				break;
+				case SSA_LOAD_LOCAL_OR_GLOBAL:
+					if(program->by_slot[insn->slot] != NULL) {
+						program->by_slot[insn->slot]->escapes = 1;
+					}
+				break;
+			}
+		}
+
+		for(i = 0; i < fn->nblocks; i++) {
+			ComoSsaBlock *b = fn->blocks[i];
+			if(b->reachable && b->terminator == SSA_RETURN) {
+				escape(program, fn, b->value);
+			}
+		}
+	}
+}
+
+static unsigned char value_type(ComoSsaProgram *program, ComoSsaFunction *fn,
+	ComoSsaInsn *insn)
+{
+	ComoSsaFunction *target;
+	unsigned char type = REG_TYPE_NONE;
+	size_t i;
+
+	switch(insn->op) {
+		case SSA_CONST:
+			switch(O_TYPE(insn->constant)) {
+				case IS_LONG:
+					return REG_TYPE_LONG;
+				case IS_STRING:
+					return REG_TYPE_STRING;
+				default:
+					return REG_TYPE_ANY;
+			}
+		case SSA_LOAD_SLOT:
+			return fn->slot_types[insn->slot];
+		case SSA_LOAD_GLOBAL:
+			return program->main->slot_types[insn->slot];
+		case SSA_LOAD_LOCAL_OR_GLOBAL:
+			return join(insn->args[0]->type,
+				program->main->slot_types[insn->slot]);
+		case SSA_PHI:
+			for(i = 0; i < insn->nargs; i++) {
+				type = join(type, insn->args[i]->type);
+			}
+			return type;
+		case SSA_BINARY:
+			if(insn->binop != REG_ADD) {
+				return REG_TYPE_LONG;
+			}
+			if(insn->args[0]->type == REG_TYPE_STRING
+					|| insn->args[1]->type == REG_TYPE_STRING) {
+				return REG_TYPE_STRING;
+			}
+			if(insn->args[0]->type == REG_TYPE_NONE
+					|| insn->args[1]->type == REG_TYPE_NONE) {
+				return REG_TYPE_NONE;
+			}
+			if(insn->args[0]->type == REG_TYPE_LONG
+					&& insn->args[1]->type == REG_TYPE_LONG) {
+				return REG_TYPE_LONG;
+			}
+			return REG_TYPE_ANY;
+		case SSA_NEG:
+		case SSA_INC:
+		case SSA_DEC:
+			return REG_TYPE_LONG;
+		case SSA_CALL:
+			target = function_of(program, fn, insn->args[0]);
+			return target != NULL && !target->escapes ? target->return_type
+				: REG_TYPE_ANY;
+		default:
+			return REG_TYPE_NONE;
+	}
+}
+
+/* One round over fn, returns whether anything it knows changed */
+static int infer(ComoSsaProgram *program, ComoSsaFunction *fn)
+{
+	ComoRegFunction *reg = fn->reg;
+	unsigned char slot_types[fn->nslots + 1], return_type = REG_TYPE_NONE;
+	int changed = 0;
+	size_t i, j;
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		unsigned char type;
+
+		if(insn->removed) {
+			continue;
+		}
+
+		type = value_type(program, fn, insn);
+		if(type != insn->type) {
+			insn->type = type;
+			changed = 1;
+		}
+	}
+
+	memset(slot_types, REG_TYPE_NONE, fn->nslots + 1);
+
+	slot_types[reg->function_name_reg] = REG_TYPE_STRING;
+
+	if(fn->top_level) {
+		/* Functions are bound to their names */
+		for(i = 0; i < fn->nslots; i++) {
+			if(fn->entry_nonnull[i]) {
+				slot_types[i] = REG_TYPE_ANY;
+			}
+		}
+	} else {
+		for(i = 0; i < reg->parameters; i++) {
+			slot_types[reg->parameter_regs[i]] = join(
+				slot_types[reg->parameter_regs[i]],
+				fn->escapes ? REG_TYPE_ANY : fn->parameter_types[i]);
+		}
+	}
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		ComoSsaFunction *target;
+
+		if(insn->removed) {
+			continue;
+		}
+
+		switch(insn->op) {
+			case SSA_STORE_SLOT:
+				slot_types[insn->slot] = join(slot_types[insn->slot],
+					insn->args[0]->type);
+			break;
+			case SSA_CALL:
+				target = function_of(program, fn, insn->args[0]);
+				if(target == NULL || target->escapes
+						|| insn->nargs - 1 != target->reg->parameters) {
+					break;
+				}
+				for(j = 1; j < insn->nargs; j++) {
+					unsigned char type = join(target->parameter_types[j - 1],
+						insn->args[j]->type);
+					if(type != target->parameter_types[j - 1]) {
+						target->parameter_types[j - 1] = type;
+						changed = 1;
+					}
+				}
+			break;
+		}
+	}
+
+	if(memcmp(slot_types, fn->slot_types, fn->nslots + 1) != 0) {
+		memcpy(fn->slot_types, slot_types, fn->nslots + 1);
+		changed = 1;
+	}
+
+	for(i = 0; i < fn->nblocks; i++) {
+		ComoSsaBlock *b = fn->blocks[i];
+		if(!b->reachable) {
+			continue;
+		}
+		if(b->terminator == SSA_RETURN) {
+			return_type = join(return_type, b->value->type);
+		} else if(b->terminator == SSA_RETURN_NONE) {
+			return_type = join(return_type, REG_TYPE_LONG);
+		}
+	}
+
+	if(return_type != fn->return_type) {
+		fn->return_type = return_type;
+		changed = 1;
+	}
+
+	return changed;
+}
+
+int como_ssa_is_pure(ComoSsaInsn *insn)
+{
+	switch(insn->op) {
+		case SSA_CONST:
+			return 1;
+		case SSA_BINARY:
+			switch(insn->binop) {
+				case REG_SUB:
+				case REG_MUL:
+					return insn->args[0]->type == REG_TYPE_LONG
+						&& insn->args[1]->type == REG_TYPE_LONG;
+				/* By zero */
+				case REG_DIV:
+				case REG_REM:
+					return 0;
+				default:
+					return 1;
+			}
+		case SSA_NEG:
+		case SSA_INC:
+		case SSA_DEC:
+			return insn->args[0]->type == REG_TYPE_LONG;
+		case SSA_CALL:
+			return insn->callee != NULL && insn->callee->pure
+				&& insn->nargs - 1 == insn->callee->reg->parameters;
+		/* The name of a function, bound for good */
+		case SSA_LOAD_GLOBAL:
+			return insn->callee != NULL;
+		default:
+			return 0;
+	}
+}
+
+/*
+ * Whether fn is pure, given what is known so far. Its parameters are the
+ * only slots it may read, the rest may have been left by an earlier call
+ */
+static int is_pure(ComoSsaFunction *fn)
+{
+	ComoRegFunction *reg = fn->reg;
+	size_t i, j;
+
+	if(fn->top_level || fn->nloops > 0) {
+		return 0;
+	}
+
+	for(i = 0; i < fn->nvalues; i++) {
+		ComoSsaInsn *insn = fn->values[i];
+		int parameter = 0;
+
+		if(insn->removed) {
+			continue;
+		}
+
+		switch(insn->op) {
+			case SSA_PHI:
+			case SSA_STORE_SLOT:
+			break;
+			case SSA_LOAD_SLOT:
+				for(j = 0; j < reg->parameters; j++) {
+					parameter |= reg->parameter_regs[j] == insn->slot;
+				}
+				if(!parameter && insn->slot != reg->function_name_reg) {
+					return 0;
+				}
+			break;
+			default:
+				if(!como_ssa_is_pure(insn)) {
+					return 0;
+				}
+			break;
+		}
+	}
+
+	return 1;
+}
+
+/* Recursion is never pure, a function is only once everything it calls is */
+static void find_pure(ComoSsaProgram *program)
+{
+	int changed = 1;
+	size_t i, j;
+
+	for(i = 0; i < program->count; i++) {
+		ComoSsaFunction *fn = program->functions[i];
+		for(j = 0; j < fn->nvalues; j++) {
+			ComoSsaInsn *insn = fn->values[j];
+			if(insn->removed) {
+				continue;
+			}
+			if(insn->op == SSA_CALL) {
+				ComoSsaFunction *target = function_of(program, fn, insn->args[0]);
+				if(target != NULL && !target->escapes) {
+					insn->callee = target;
+				}
+			} else if(insn->op == SSA_LOAD_GLOBAL) {
+				insn->callee = program->by_slot[insn->slot];
+			}
+		}
+	}
+
+	while(changed) {
+		changed = 0;
+		for(i = 0; i < program->count; i++) {
+			ComoSsaFunction *fn = program->functions[i];
+			if(!fn->pure && is_pure(fn)) {
+				fn->pure = 1;
+				changed = 1;
+			}
+		}
+	}
+}
+
+void como_ssa_infer_types(ComoSsaFunction **functions, size_t count)
+{
+	ComoSsaProgram program;
+	int changed = 1;
+	size_t i;
+
+	program.functions = functions;
+	program.count = count;
+	program.main = functions[count - 1];
+
+	for(i = 0; i < count; i++) {
+		ComoSsaFunction *fn = functions[i];
+		fn->slot_types = calloc(fn->nslots + 1, 1);
+		fn->parameter_types = calloc(fn->reg->parameters + 1, 1);
+	}
+
+	find_functions(&program);
+	find_escapes(&program);
+
+	while(changed) {
+		changed = 0;
+		for(i = 0; i < count; i++) {
+			changed |= infer(&program, functions[i]);
+		}
+	}
+
+	find_pure(&program);
+
+	free(program.by_slot);
+}
@@ -0,0 +1,233 @@
+/*
+*  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation, either version 3 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <object.h>
+
+#include "comodebug.h"
+#include "como_opcode.h"
+#include "como_compiler_ex.h"
+
+#define DEPTH_UNKNOWN ((size_t)-1)
+
+#define CODE_AT(code, i) ((ComoOpCode *)O_PTVAL(O_AVAL((code))->table[(i)]))
+
+/*
+ * The bytecode verifier. Every path through a code array is walked,
+ * keeping track of how many operands are on the stack before each
+ * instruction. The code is rejected if an instruction could pop from an
+ * empty stack, or if two paths reach the same instruction with different
+ * depths. Once verified, como_execute can push and pop without bounds
+ * checks, provided the frame stack holds the depth returned here.
+ */
+
+static void __attribute__ ((noreturn)) verify_error(const char *name, 
+	size_t pc, const char *reason)
+{
+	como_error_noreturn("bytecode verification of '%s' failed at #%zu: %s",
+		name, pc, reason);
+}
+
+/*
+ * CALL_FUNCTION pops the function, then the argument count the compiler
+ * emitted as the LOAD_CONST two instructions earlier, then the arguments
+ */
+static long verify_argcount(Object *code, size_t pc, const char *name)
+{
+	ComoOpCode *argcount, *fn;
+
+	if(pc < 2) {
+		verify_error(name, pc, "CALL_FUNCTION without argument count");
+	}
+
+	argcount = CODE_AT(code, pc - 2);
+	fn = CODE_AT(code, pc - 1);
+
+	if(argcount->op_code != LOAD_CONST || O_TYPE(argcount->operand) != IS_LONG
+			|| O_LVAL(argcount->operand) < 0 || fn->op_code != LOAD_NAME) {
+		verify_error(name, pc, "CALL_FUNCTION without argument count");
+	}
+
+	return O_LVAL(argcount->operand);
+}
+
+static size_t verify_jump_target(Object *code, size_t pc, Object *label,
+	const char *name)
+{
+	long target = O_LVAL(label);
+
+	if(target < 0 || (size_t)target >= O_AVAL(code)->size
+			|| CODE_AT(code, target)->op_code != LABEL) {
+		verify_error(name, pc, "jump target is not a LABEL");
+	}
+
+	/* como_execute resumes after the LABEL itself */
+	return (size_t)target + 1;
+}
+
+static void verify_merge(size_t *depths, size_t *worklist, size_t *top,
+	size_t pc, size_t depth, size_t size, const char *name)
+{
+	if(pc >= size) {
+		return;
+	}
+
+	if(depths[pc] == DEPTH_UNKNOWN) {
+		depths[pc] = depth;
+		worklist[(*top)++] = pc;
+	} else if(depths[pc] != depth) {
+		verify_error(name, pc, "stack depth differs between paths");
+	}
+}
+
+size_t como_verify_code(Object *code, const char *name)
+{
+	size_t size = O_AVAL(code)->size;
+	size_t *depths, *worklist;
+	size_t top = 0, max_depth = 0;
+	size_t i;
+
+	if(size == 0) {
+		return 0;
+	}
+
+	depths = malloc(sizeof(size_t) * size);
+	/* Every pc enters the worklist at most once */
+	worklist = malloc(sizeof(size_t) * size);
+
+	for(i = 0; i < size; i++) {
+		depths[i] = DEPTH_UNKNOWN;
+	}
+
+	depths[0] = 0;
+	worklist[top++] = 0;
+
+	while(top > 0) {
+		size_t pc = worklist[--top];
+		size_t depth = depths[pc];
+		ComoOpCode *opcode = CODE_AT(code, pc);
+		size_t pops = 0, pushes = 0;
+		int falls_through = 1;
+
+		/* A quickened form, from a --profile, moves the stack as its own */
+		switch(como_opcode_generic(opcode->op_code)) {
+			default:
+				verify_error(name, pc, "unknown opcode");
+			case NOP:
+			case LABEL:
+			case HALT:
+			break;
+			case LOAD_CONST:
+			case LOAD_NAME:
+			case POSTFIX_INC:
+			case POSTFIX_DEC:
+			case PREFIX_INC:
+			case PREFIX_DEC:
+				pushes = 1;
+			break;
+			case STORE_NAME:
+			case POP_TOP:
+			case IPRINT:
+			case INPLACE_ADD:
+			case INPLACE_MINUS:
+			case INPLACE_TIMES:
+			case INPLACE_DIV:
+			case INPLACE_REM:
+				pops = 1;
+			break;
+			case INPLACE_INC:
+			case INPLACE_DEC:
+			break;
+			case UNARY_MINUS:
+				pops = 1;
+				pushes = 1;
+			break;
+			case IS_LESS_THAN:
+			case IS_LESS_THAN_OR_EQUAL:
+			case IS_GREATER_THAN:
+			case IS_GREATER_THAN_OR_EQUAL:
+			case IS_EQUAL:
+			case IS_NOT_EQUAL:
+			case IADD:
+			case IMINUS:
+			case ITIMES:
+			case IDIV:
+			case IREM:
+				pops = 2;
+				pushes = 1;
+			break;
+			case CALL_FUNCTION:
+				pops = 2 + (size_t)verify_argcount(code, pc, name);
+				pushes = 1;
+			break;
+			case JZ:
+				pops = 1;
+			break;
+			case FOR_RANGE:
+			break;
+			case SWITCH:
+				pops = 1;
+				falls_through = 0;
+			break;
+			case JMP:
+				falls_through = 0;
+			break;
+			case IRETURN:
+				/* The value is either on the stack, or pushed by IRETURN */
+				if(O_LVAL(opcode->operand)) {
+					pops = 1;
+				} else {
+					pushes = 1;
+				}
+				falls_through = 0;
+			break;
+		}
+
+		if(depth < pops) {
+			verify_error(name, pc, "stack underflow");
+		}
+
+		depth = depth - pops + pushes;
+
+		if(depth > max_depth) {
+			max_depth = depth;
+		}
+
+		if(opcode->op_code == JZ || opcode->op_code == JMP
+				|| opcode->op_code == FOR_RANGE) {
+			verify_merge(depths, worklist, &top, verify_jump_target(code, pc,
+				COMO_JUMP_TARGET(opcode), name), depth, size, name);
+		} else if(opcode->op_code == SWITCH) {
+			Array *targets = O_AVAL(O_AVAL(opcode->operand)
+				->table[SWITCH_TARGETS]);
+			for(i = 0; i < targets->size; i++) {
+				verify_merge(depths, worklist, &top, verify_jump_target(code, 
+					pc, targets->table[i], name), depth, size, name);
+			}
+		}
+
+		if(falls_through) {
+			verify_merge(depths, worklist, &top, pc + 1, depth, size, name);
+		}
+	}
+
+	free(depths);
+	free(worklist);
+
+	return max_depth;
+}
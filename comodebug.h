@@ -44,7 +44,11 @@ static void __attribute__ ((noreturn)) como_error_noreturn_ex(const char *f,
 
 #define como_error_noreturn(format, ...) como_error_noreturn_ex(__FILE__, __func__, __LINE__, format, ##__VA_ARGS__)
 
+#ifdef COMO_DEBUG
 #define como_debug(format, ...) como_debug_ex(__FILE__, __func__, __LINE__, format, ##__VA_ARGS__)
+#else
+#define como_debug(format, ...) do { } while(0)
+#endif
 
 #define COMO_OOM() do { \
 	como_error_noreturn("out of memory"); \
@@ -378,8 +378,8 @@ static void yy_fatal_error (yyconst char msg[] ,yyscan_t yyscanner );
 	*yy_cp = '\0'; \
 	yyg->yy_c_buf_p = yy_cp;
 
-#define YY_NUM_RULES 26
-#define YY_END_OF_BUFFER 27
+#define YY_NUM_RULES 34
+#define YY_END_OF_BUFFER 35
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -387,127 +387,161 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[78] =
+static yyconst flex_int16_t yy_accept[96] =
     {   0,
-       21,   21,    0,    0,   27,   25,   21,   21,   25,   25,
-       25,   25,   25,   23,   25,   25,   25,   22,   22,   22,
-       22,   22,   22,   22,   22,    6,    6,    6,    6,   21,
-       16,    0,   24,    0,   19,   20,    2,    0,   23,   17,
-       15,   18,   22,    0,   22,   22,   22,    7,   22,   22,
-       22,    4,    3,    0,    0,    1,   22,   10,   22,   22,
-       22,   22,    5,    8,   11,   22,   22,   22,   22,   13,
-       22,    9,   22,   14,   22,   12,    0
+      29,   29,    0,    0,   35,   33,   29,   33,   33,   33,
+      33,   33,   33,   33,   31,   33,   33,   33,   30,   30,
+      30,   30,   30,   30,   30,   30,   30,   30,   30,    6,
+       6,    6,    6,   19,    0,   32,    0,   28,   26,   22,
+      24,   23,   25,    2,    0,   27,   20,   18,   21,   30,
+      30,   30,   30,   30,    7,   30,   30,   30,   30,    4,
+       3,    0,    1,   30,   30,   30,   10,   30,   30,   30,
+      30,   30,    5,   14,   30,    8,   11,   30,   30,   30,
+      30,   30,   30,   16,   30,   30,    9,   30,   30,   17,
+      13,   15,   30,   12,    0
     } ;
 
 static yyconst flex_int32_t yy_ec[256] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    2,    3,
-        1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    2,    4,    5,    1,    1,    1,    1,    1,    1,
-        1,    6,    7,    1,    8,    1,    9,   10,   10,   10,
-       10,   10,   10,   10,   10,   10,   10,    1,    1,   11,
-       12,   13,    1,    1,   14,   14,   14,   14,   15,   16,
-       14,   14,   14,   14,   14,   17,   14,   14,   18,   14,
-       14,   14,   14,   14,   14,   14,   14,   14,   14,   14,
-        1,   19,    1,    1,   14,    1,   14,   14,   20,   14,
-
-       21,   22,   14,   23,   24,   14,   14,   25,   14,   26,
-       27,   28,   14,   29,   30,   31,   32,   14,   33,   14,
-       14,   14,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1
+       1,    1,    1,    1,    1,    1,    1,    1,    2,    3,
+       1,    1,    2,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    2,    4,    5,    1,    1,    6,    1,    1,    1,
+       1,    7,    8,    1,    9,    1,   10,   11,   11,   11,
+      11,   11,   11,   11,   11,   11,   11,    1,    1,   12,
+      13,   14,    1,    1,   15,   15,   15,   15,   16,   17,
+      15,   15,   15,   15,   15,   18,   15,   15,   19,   15,
+      15,   15,   15,   15,   15,   15,   15,   15,   15,   15,
+       1,   20,    1,    1,   15,    1,   21,   15,   22,   23,
+
+      24,   25,   15,   26,   27,   15,   15,   28,   15,   29,
+      30,   31,   15,   32,   33,   34,   35,   15,   36,   15,
+      15,   15,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int32_t yy_meta[34] =
+static yyconst flex_int32_t yy_meta[37] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    2,
-        1,    1,    1,    2,    2,    2,    2,    2,    1,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int16_t yy_base[82] =
+static yyconst flex_int16_t yy_base[96] =
     {   0,
-        0,    0,   28,   29,  103,  104,   37,   39,   90,   31,
-       94,   92,   39,   89,   86,   85,   84,    0,   90,   69,
-       19,   71,   63,   70,   67,  104,   80,   82,   69,   50,
-      104,   42,  104,   83,  104,  104,  104,   82,   74,  104,
-      104,  104,    0,   44,   53,   53,   55,    0,   56,   48,
-       54,  104,  104,   61,   73,  104,   54,    0,   54,   47,
-       40,   46,  104,    0,   39,   31,   31,   38,   34,    0,
-       31,    0,   29,    0,   29,    0,  104,   63,   65,   52,
-       67
+      38,    1,   74,    1,    1,  111,  110,  101,  114,  138,
+     139,  145,  146,  147,  145,  148,  149,  150,  153,  160,
+     145,  143,  145,  160,  166,  160,  169,  158,  170,    1,
+     187,  191,  180,    1,    1,    1,  197,    1,    1,    1,
+       1,    1,    1,    1,  207,    1,    1,    1,    1,  168,
+     178,  171,  173,  177,    1,  180,  210,  218,  219,    1,
+       1,  230,    1,  224,  228,  226,    1,  229,  223,  218,
+     220,  227,    1,    1,  221,    1,  223,  224,  227,  238,
+     237,  234,  236,    1,  235,  239,    1,  232,  237,    1,
+       1,    1,  239,    1,    1
     } ;
 
-static yyconst flex_int16_t yy_def[82] =
+static yyconst flex_int16_t yy_def[96] =
     {   0,
-       77,    1,   78,   78,   77,   77,   77,   77,   77,   79,
-       77,   77,   77,   77,   77,   77,   77,   80,   80,   80,
-       80,   80,   80,   80,   80,   77,   77,   77,   77,   77,
-       77,   79,   77,   79,   77,   77,   77,   81,   77,   77,
-       77,   77,   80,   79,   80,   80,   80,   80,   80,   80,
-       80,   77,   77,   77,   81,   77,   80,   80,   80,   80,
-       80,   80,   77,   80,   80,   80,   80,   80,   80,   80,
-       80,   80,   80,   80,   80,   80,    0,   77,   77,   77,
-       77
+      95,    1,    1,    3,   95,   95,    6,    6,    1,    6,
+       6,    6,    6,    6,    6,    6,    6,    6,    6,   19,
+      19,   19,   19,   19,   19,   19,   19,   19,   19,    6,
+       6,    6,    6,    6,    9,    6,    9,    6,    6,    6,
+       6,    6,    6,    6,   14,    6,    6,    6,    6,   19,
+      19,   19,   19,   19,   19,   19,   19,   19,   19,    6,
+       6,    6,    6,   19,   19,   19,   19,   19,   19,   19,
+      19,   19,    6,   19,   19,   19,   19,   19,   19,   19,
+      19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+      19,   19,   19,   19,    0
     } ;
 
-static yyconst flex_int16_t yy_nxt[138] =
+static yyconst flex_int16_t yy_nxt[276] =
     {   0,
-        6,    7,    8,    9,   10,    6,   11,   12,   13,   14,
-       15,   16,   17,   18,   18,   18,   19,   18,    6,   18,
-       20,   21,   18,   22,   18,   18,   18,   23,   24,   18,
-       18,   18,   25,   27,   27,   33,   28,   28,   30,   30,
-       30,   30,   29,   29,   37,   46,   33,   38,   33,   34,
-       47,   30,   30,   43,   76,   75,   74,   73,   72,   71,
-       34,   70,   34,   26,   26,   32,   32,   55,   55,   69,
-       68,   67,   66,   65,   64,   56,   63,   62,   61,   60,
-       59,   58,   57,   39,   56,   77,   54,   53,   52,   51,
-       50,   49,   48,   45,   44,   42,   41,   40,   39,   36,
-
-       35,   31,   77,    5,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,    5,    6,    7,
+       7,    8,    9,   10,   11,   12,   13,   14,   15,   16,
+      17,   18,   19,   19,   19,   20,   19,    6,   19,   21,
+      22,   23,   24,   19,   25,   19,   19,   19,   26,   27,
+      28,   19,   19,   29,   30,   30,   30,   30,   30,   30,
+      31,   30,   30,   32,   30,   30,   30,   30,   30,   33,
+      30,   30,   30,   30,   30,   30,   30,   30,   30,   30,
+
+      30,   30,   30,   30,   30,   30,   30,   30,   30,   30,
+       5,    7,    7,   34,   35,   35,   35,   35,   36,   35,
+      35,   35,   35,   35,   35,   35,   35,   35,   35,   35,
+      35,   35,   35,   37,   35,   35,   35,   35,   35,   35,
+      35,   35,   35,   35,   35,   35,   35,   35,   35,   35,
+      38,   39,   40,   44,   42,   15,   45,   41,   43,   46,
+      47,   48,   49,   19,   35,   50,   51,   19,   19,   19,
+      19,   19,   52,   19,   19,   19,   19,   19,   19,   19,
+      19,   19,   19,   19,   19,   19,   19,   19,   19,   53,
+      55,   56,   57,   58,   54,   59,   60,   61,   62,   95,
+
+      64,   35,   65,   66,   67,   68,   69,   45,   45,   63,
+      45,   45,   45,   45,   45,   45,   35,   45,   45,   45,
+      45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+      45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+      45,   45,   45,   70,   71,   72,   73,   74,   75,   76,
+      77,   78,   79,   80,   81,   82,   83,   84,   85,   86,
+      87,   88,   89,   90,   91,   92,   93,   94,    0,    0,
+       0,    0,    0,    0,    0
     } ;
 
-static yyconst flex_int16_t yy_chk[138] =
+static yyconst flex_int16_t yy_chk[276] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    3,    4,   10,    3,    4,    7,    7,
-        8,    8,    3,    4,   13,   21,   32,   13,   44,   10,
-       21,   30,   30,   80,   75,   73,   71,   69,   68,   67,
-       32,   66,   44,   78,   78,   79,   79,   81,   81,   65,
-       62,   61,   60,   59,   57,   55,   54,   51,   50,   49,
-       47,   46,   45,   39,   38,   34,   29,   28,   27,   25,
-       24,   23,   22,   20,   19,   17,   16,   15,   14,   12,
-
-       11,    9,    5,   77,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77,   77,   77,   77,
-       77,   77,   77,   77,   77,   77,   77
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,   95,   95,   95,
+      95,   95,   95,   95,   95,   95,   95,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+       1,    1,    1,    1,    3,    3,    3,    3,    3,    3,
+       3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+       3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+
+       3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+       6,    7,    7,    8,    9,    9,    9,    9,    9,    9,
+       9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+       9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+       9,    9,    9,    9,    9,    9,    9,    9,    9,    9,
+      10,   11,   12,   14,   13,   15,   14,   12,   13,   14,
+      16,   17,   18,   19,   20,   21,   22,   19,   19,   19,
+      19,   19,   23,   19,   19,   19,   19,   19,   19,   19,
+      19,   19,   19,   19,   19,   19,   19,   19,   19,   24,
+      25,   26,   27,   28,   24,   29,   31,   32,   33,   37,
+
+      50,   37,   51,   52,   53,   54,   56,   45,   45,   45,
+      45,   45,   45,   45,   45,   45,   37,   45,   45,   45,
+      45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+      45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+      45,   45,   45,   57,   58,   59,   62,   64,   65,   66,
+      68,   69,   70,   71,   72,   75,   77,   78,   79,   80,
+      81,   82,   83,   85,   86,   88,   89,   93,    0,    0,
+       0,    0,    0,    0,    0
     } ;
 
 /* Table of booleans, true if rule could match eol. */
-static yyconst flex_int32_t yy_rule_can_match_eol[27] =
+static yyconst flex_int32_t yy_rule_can_match_eol[35] =
     {   0,
 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
-    0, 1, 0, 0, 1, 0, 0,     };
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0,     };
 
 /* The intent behind this definition is that it'll catch
  * any uses of REJECT which flex missed.
@@ -562,7 +596,7 @@ static void update_loc(YYLTYPE *loc, char* text)
 #define YY_NO_UNISTD_H 1
 #define YY_NO_INPUT 1
 
-#line 566 "lexer.c"
+#line 600 "lexer.c"
 
 #define INITIAL 0
 #define COMMENT 1
@@ -845,7 +879,7 @@ YY_DECL
 #line 59 "lexer.l"
 
 
-#line 849 "lexer.c"
+#line 883 "lexer.c"
 
 	while ( 1 )		/* loops until end-of-file is reached */
 		{
@@ -872,13 +906,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 78 )
+				if ( yy_current_state >= 96 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_current_state != 77 );
+		while ( yy_current_state != 95 );
 		yy_cp = yyg->yy_last_accepting_cpos;
 		yy_current_state = yyg->yy_last_accepting_state;
 
@@ -975,52 +1009,92 @@ YY_RULE_SETUP
 case 13:
 YY_RULE_SETUP
 #line 75 "lexer.l"
-{ return T_PRINT;  }
+{ return T_SWITCH;   }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
 #line 76 "lexer.l"
-{ return T_RETURN; }
+{ return T_CASE;     }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
 #line 77 "lexer.l"
-{ return T_CMP;    }
+{ return T_DEFAULT;  }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
 #line 78 "lexer.l"
-{ return T_NEQ;    }
+{ return T_PRINT;  }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
 #line 79 "lexer.l"
-{ return T_LTE;    }
+{ return T_RETURN; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
 #line 80 "lexer.l"
-{ return T_GTE;    }
+{ return T_CMP;    }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
 #line 81 "lexer.l"
-{ return T_INC;    }
+{ return T_NEQ;    }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
 #line 82 "lexer.l"
-{ return T_DEC;    }
+{ return T_LTE;    }
 	YY_BREAK
 case 21:
-/* rule 21 can match eol */
 YY_RULE_SETUP
-#line 84 "lexer.l"
-{ /* Skipping Blanks Today */ }
+#line 83 "lexer.l"
+{ return T_GTE;    }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
+#line 84 "lexer.l"
+{ return T_INC;    }
+	YY_BREAK
+case 23:
+YY_RULE_SETUP
 #line 85 "lexer.l"
+{ return T_DEC;    }
+	YY_BREAK
+case 24:
+YY_RULE_SETUP
+#line 86 "lexer.l"
+{ return T_ADD_ASSIGN;   }
+	YY_BREAK
+case 25:
+YY_RULE_SETUP
+#line 87 "lexer.l"
+{ return T_MINUS_ASSIGN; }
+	YY_BREAK
+case 26:
+YY_RULE_SETUP
+#line 88 "lexer.l"
+{ return T_TIMES_ASSIGN; }
+	YY_BREAK
+case 27:
+YY_RULE_SETUP
+#line 89 "lexer.l"
+{ return T_DIV_ASSIGN;   }
+	YY_BREAK
+case 28:
+YY_RULE_SETUP
+#line 90 "lexer.l"
+{ return T_REM_ASSIGN;   }
+	YY_BREAK
+case 29:
+/* rule 29 can match eol */
+YY_RULE_SETUP
+#line 92 "lexer.l"
+{ /* Skipping Blanks Today */ }
+	YY_BREAK
+case 30:
+YY_RULE_SETUP
+#line 93 "lexer.l"
 {
 	size_t len = strlen(yytext);
 	yylval->id = malloc(len + 1);
@@ -1028,15 +1102,15 @@ YY_RULE_SETUP
 	return T_ID;
 }
 	YY_BREAK
-case 23:
+case 31:
 YY_RULE_SETUP
-#line 92 "lexer.l"
+#line 100 "lexer.l"
 { yylval->number = strtol(yytext, NULL, 10); return T_NUM; }
 	YY_BREAK
-case 24:
-/* rule 24 can match eol */
+case 32:
+/* rule 32 can match eol */
 YY_RULE_SETUP
-#line 94 "lexer.l"
+#line 102 "lexer.l"
 { 
 	size_t len = strlen(yytext);
 	if(len > 2U) {
@@ -1051,17 +1125,17 @@ YY_RULE_SETUP
 	}
 }
 	YY_BREAK
-case 25:
+case 33:
 YY_RULE_SETUP
-#line 107 "lexer.l"
+#line 115 "lexer.l"
 { return yytext[0];				     }
 	YY_BREAK
-case 26:
+case 34:
 YY_RULE_SETUP
-#line 109 "lexer.l"
+#line 117 "lexer.l"
 YY_FATAL_ERROR( "flex scanner jammed" );
 	YY_BREAK
-#line 1065 "lexer.c"
+#line 1139 "lexer.c"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(COMMENT):
 	yyterminate();
@@ -1358,7 +1432,7 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 78 )
+			if ( yy_current_state >= 96 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1387,11 +1461,11 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 78 )
+		if ( yy_current_state >= 96 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 77);
+	yy_is_jam = (yy_current_state == 95);
 
 	(void)yyg;
 	return yy_is_jam ? 0 : yy_current_state;
@@ -2209,7 +2283,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 108 "lexer.l"
+#line 116 "lexer.l"
 
 
 
@@ -356,7 +356,7 @@ extern int yylex \
 #undef YY_DECL
 #endif
 
-#line 108 "lexer.l"
+#line 116 "lexer.l"
 
 
 #line 363 "lexer.h"
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.2"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,8 +66,8 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "parser.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 1 "parser.y"
 
 /*
 *  Copyright (c) 2016 Ryan McCullagh <me@ryanmccullagh.com>
@@ -81,10 +86,12 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
 #include "globals.h"
 #include "ast.h"
 #include "parser.h"
 #include "lexer.h"
+#include "como_compiler_ex.h"
 
 #define YYERROR_VERBOSE
 
@@ -96,143 +103,267 @@ int yyerror(YYLTYPE * lvalp, ast_node** ast, yyscan_t scanner, const char* msg)
 	exit(1);
 }
 
+/* 
+ * target op= value, as target = target op value. The expression on the
+ * left of op= is only known to be a name once it is parsed
+ */
+static ast_node *compound_assignment(YYLTYPE *lvalp, ast_node **ast,
+	yyscan_t scanner, ast_binary_op_type type, ast_node *target, 
+	ast_node *value)
+{
+	if(target->type != AST_NODE_TYPE_ID) {
+		yyerror(lvalp, ast, scanner, "syntax error, unexpected '=' after "
+			"an expression that isn't a name");
+	}
 
-#line 101 "parser.c" /* yacc.c:339  */
+	return ast_node_create_binary_op(AST_BINARY_OP_ASSIGN, 
+		ast_node_create_id(AST_NODE_AS_ID(target)), 
+		ast_node_create_binary_op(type, target, value));
+}
 
-# ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
-#  else
-#   define YY_NULLPTR 0
-#  endif
-# endif
+static int case_labels_equal(ast_node *a, ast_node *b)
+{
+	if(a->type != b->type) {
+		return 0;
+	}
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
+	if(a->type == AST_NODE_TYPE_NUMBER) {
+		return a->u1.number_value == b->u1.number_value;
+	}
 
-/* In a future release of Bison, this section will be replaced
-   by #include "parser.h".  */
-#ifndef YY_YY_PARSER_H_INCLUDED
-# define YY_YY_PARSER_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-/* "%code requires" blocks.  */
-#line 36 "parser.y" /* yacc.c:355  */
+	return strcmp(a->u1.string_value.value, b->u1.string_value.value) == 0;
+}
 
+/* A switch may have one default, and a label only once */
+static ast_node *switch_statement(YYLTYPE *lvalp, ast_node **ast,
+	yyscan_t scanner, ast_node *expr, ast_node *cases)
+{
+	ast_node_statements *list = &cases->u1.statements_node;
+	size_t i, j, k, l, defaults = 0;
+
+	for(i = 0; i < list->count; i++) {
+		ast_node *labels = list->statement_list[i]->u1.case_node.labels;
+
+		if(labels == NULL) {
+			if(++defaults > 1) {
+				yyerror(lvalp, ast, scanner, 
+					"syntax error, more than one default in switch");
+			}
+			continue;
+		}
+
+		for(j = 0; j < labels->u1.statements_node.count; j++) {
+			ast_node *label = labels->u1.statements_node.statement_list[j];
+			for(k = 0; k <= i; k++) {
+				ast_node *other = list->statement_list[k]->u1.case_node.labels;
+				size_t count = other == NULL ? 0 : k < i 
+					? other->u1.statements_node.count : j;
+				for(l = 0; l < count; l++) {
+					if(case_labels_equal(label, 
+							other->u1.statements_node.statement_list[l])) {
+						yyerror(lvalp, ast, scanner, 
+							"syntax error, duplicate case label in switch");
+					}
+				}
+			}
+		}
+	}
 
-#ifndef YY_TYPEDEF_YY_SCANNER_T
-#define YY_TYPEDEF_YY_SCANNER_T
-typedef void* yyscan_t;
-#endif
+	return ast_node_create_switch(expr, cases);
+}
 
 
-#line 140 "parser.c" /* yacc.c:355  */
+#line 177 "parser.c"
 
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    END = 0,
-    T_CMP = 258,
-    T_LTE = 259,
-    T_NEQ = 260,
-    T_GTE = 261,
-    T_IF = 262,
-    T_ELSE = 263,
-    T_WHILE = 264,
-    T_FOR = 265,
-    T_FUNC = 266,
-    T_RETURN = 267,
-    T_PRINT = 268,
-    T_NOELSE = 269,
-    T_INC = 270,
-    T_DEC = 271,
-    T_FUNCTION = 272,
-    T_NUM = 273,
-    T_ID = 274,
-    T_STR_LIT = 275
-  };
-#endif
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
-union YYSTYPE
+#include "parser.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 56 "parser.y" /* yacc.c:355  */
-
-	long number;
-	char* id;
-	char* stringliteral;
-	ast_node* ast;
-
-#line 181 "parser.c" /* yacc.c:355  */
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "EOF"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_3_ = 3,                         /* '%'  */
+  YYSYMBOL_4_ = 4,                         /* '-'  */
+  YYSYMBOL_5_ = 5,                         /* '+'  */
+  YYSYMBOL_6_ = 6,                         /* '*'  */
+  YYSYMBOL_7_ = 7,                         /* '/'  */
+  YYSYMBOL_8_ = 8,                         /* '<'  */
+  YYSYMBOL_9_ = 9,                         /* '>'  */
+  YYSYMBOL_T_IF = 10,                      /* T_IF  */
+  YYSYMBOL_T_LTE = 11,                     /* T_LTE  */
+  YYSYMBOL_T_ELSE = 12,                    /* T_ELSE  */
+  YYSYMBOL_T_WHILE = 13,                   /* T_WHILE  */
+  YYSYMBOL_T_FOR = 14,                     /* T_FOR  */
+  YYSYMBOL_T_FUNC = 15,                    /* T_FUNC  */
+  YYSYMBOL_T_RETURN = 16,                  /* T_RETURN  */
+  YYSYMBOL_T_CMP = 17,                     /* T_CMP  */
+  YYSYMBOL_T_PRINT = 18,                   /* T_PRINT  */
+  YYSYMBOL_T_NOELSE = 19,                  /* T_NOELSE  */
+  YYSYMBOL_T_NEQ = 20,                     /* T_NEQ  */
+  YYSYMBOL_T_GTE = 21,                     /* T_GTE  */
+  YYSYMBOL_T_INC = 22,                     /* T_INC  */
+  YYSYMBOL_T_DEC = 23,                     /* T_DEC  */
+  YYSYMBOL_T_FUNCTION = 24,                /* T_FUNCTION  */
+  YYSYMBOL_T_SWITCH = 25,                  /* T_SWITCH  */
+  YYSYMBOL_T_CASE = 26,                    /* T_CASE  */
+  YYSYMBOL_T_DEFAULT = 27,                 /* T_DEFAULT  */
+  YYSYMBOL_T_ADD_ASSIGN = 28,              /* T_ADD_ASSIGN  */
+  YYSYMBOL_T_MINUS_ASSIGN = 29,            /* T_MINUS_ASSIGN  */
+  YYSYMBOL_T_TIMES_ASSIGN = 30,            /* T_TIMES_ASSIGN  */
+  YYSYMBOL_T_DIV_ASSIGN = 31,              /* T_DIV_ASSIGN  */
+  YYSYMBOL_T_REM_ASSIGN = 32,              /* T_REM_ASSIGN  */
+  YYSYMBOL_T_NUM = 33,                     /* T_NUM  */
+  YYSYMBOL_T_ID = 34,                      /* T_ID  */
+  YYSYMBOL_T_STR_LIT = 35,                 /* T_STR_LIT  */
+  YYSYMBOL_36_ = 36,                       /* '='  */
+  YYSYMBOL_37_ = 37,                       /* '('  */
+  YYSYMBOL_38_ = 38,                       /* ')'  */
+  YYSYMBOL_39_ = 39,                       /* ';'  */
+  YYSYMBOL_40_ = 40,                       /* '{'  */
+  YYSYMBOL_41_ = 41,                       /* '}'  */
+  YYSYMBOL_42_ = 42,                       /* ':'  */
+  YYSYMBOL_43_ = 43,                       /* ','  */
+  YYSYMBOL_YYACCEPT = 44,                  /* $accept  */
+  YYSYMBOL_start = 45,                     /* start  */
+  YYSYMBOL_top_statement_list = 46,        /* top_statement_list  */
+  YYSYMBOL_top_statement = 47,             /* top_statement  */
+  YYSYMBOL_inner_statement_list = 48,      /* inner_statement_list  */
+  YYSYMBOL_inner_statement = 49,           /* inner_statement  */
+  YYSYMBOL_function_keyword = 50,          /* function_keyword  */
+  YYSYMBOL_statement = 51,                 /* statement  */
+  YYSYMBOL_assignment_statement = 52,      /* assignment_statement  */
+  YYSYMBOL_print_statement = 53,           /* print_statement  */
+  YYSYMBOL_return_statement = 54,          /* return_statement  */
+  YYSYMBOL_optional_expression = 55,       /* optional_expression  */
+  YYSYMBOL_compound_statement = 56,        /* compound_statement  */
+  YYSYMBOL_expression_statement = 57,      /* expression_statement  */
+  YYSYMBOL_if_statement_without_else = 58, /* if_statement_without_else  */
+  YYSYMBOL_selection_statement = 59,       /* selection_statement  */
+  YYSYMBOL_case_list = 60,                 /* case_list  */
+  YYSYMBOL_case_clause = 61,               /* case_clause  */
+  YYSYMBOL_case_label_list = 62,           /* case_label_list  */
+  YYSYMBOL_case_label = 63,                /* case_label  */
+  YYSYMBOL_function_decl_statement = 64,   /* function_decl_statement  */
+  YYSYMBOL_optional_parameter_list = 65,   /* optional_parameter_list  */
+  YYSYMBOL_parameter_list = 66,            /* parameter_list  */
+  YYSYMBOL_parameter = 67,                 /* parameter  */
+  YYSYMBOL_optional_argument_list = 68,    /* optional_argument_list  */
+  YYSYMBOL_argument_list = 69,             /* argument_list  */
+  YYSYMBOL_argument = 70,                  /* argument  */
+  YYSYMBOL_expr = 71                       /* expr  */
 };
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
-{
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
-};
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
 
 
 
-int yyparse (ast_node** ast, yyscan_t scanner);
+#ifdef short
+# undef short
+#endif
 
-#endif /* !YY_YY_PARSER_H_INCLUDED  */
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
-/* Copy the second part of user declarations.  */
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
 
-#line 209 "parser.c" /* yacc.c:358  */
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
 
-#ifdef short
-# undef short
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned char yytype_uint8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#else
-typedef signed char yytype_int8;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -240,15 +371,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -262,47 +406,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -315,8 +455,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -381,8 +535,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -392,18 +545,19 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
   YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE) + sizeof (YYLTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
       + 2 * YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -416,11 +570,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -432,12 +586,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -449,42 +603,45 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   259
+#define YYLAST   414
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  35
+#define YYNTOKENS  44
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  24
+#define YYNNTS  28
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  59
+#define YYNRULES  77
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  109
+#define YYNSTATES  148
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   275
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   283
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,    13,     2,     2,
-      29,    30,    11,    10,    34,     9,     2,    12,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    31,
-       7,    28,     8,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     3,     2,     2,
+      37,    38,     6,     5,    43,     4,     2,     7,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    42,    39,
+       8,    36,     9,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,    32,     2,    33,     2,     2,     2,     2,
+       2,     2,     2,    40,     2,    41,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -497,254 +654,309 @@ static const yytype_uint8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
-       5,     6,    14,    15,    16,    17,    18,    19,    20,    21,
-      22,    23,    24,    25,    26,    27
+       2,     2,     2,     2,     2,     2,     1,     2,    10,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    35
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,   117,   117,   121,   122,   126,   130,   131,   135,   139,
-     139,   143,   145,   147,   149,   151,   155,   162,   168,   172,
-     173,   177,   181,   183,   185,   189,   193,   195,   197,   201,
-     207,   214,   216,   220,   222,   226,   230,   232,   236,   238,
-     242,   247,   249,   251,   253,   255,   259,   263,   267,   271,
-     275,   279,   283,   288,   293,   298,   302,   304,   306,   308
+       0,   197,   197,   201,   208,   212,   216,   217,   221,   225,
+     225,   229,   231,   233,   235,   237,   241,   246,   250,   254,
+     258,   262,   268,   274,   278,   279,   283,   287,   289,   291,
+     295,   299,   301,   303,   307,   311,   315,   321,   322,   326,
+     330,   334,   336,   340,   342,   344,   348,   358,   360,   364,
+     366,   370,   374,   376,   380,   382,   386,   391,   393,   395,
+     397,   399,   403,   407,   411,   415,   419,   423,   427,   432,
+     437,   442,   447,   452,   456,   458,   460,   462
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "\"EOF\"", "error", "$undefined", "T_CMP", "T_LTE", "T_NEQ", "T_GTE",
-  "'<'", "'>'", "'-'", "'+'", "'*'", "'/'", "'%'", "T_IF", "T_ELSE",
-  "T_WHILE", "T_FOR", "T_FUNC", "T_RETURN", "T_PRINT", "T_NOELSE", "T_INC",
-  "T_DEC", "T_FUNCTION", "T_NUM", "T_ID", "T_STR_LIT", "'='", "'('", "')'",
-  "';'", "'{'", "'}'", "','", "$accept", "start", "top_statement_list",
+  "\"EOF\"", "error", "\"invalid token\"", "'%'", "'-'", "'+'", "'*'",
+  "'/'", "'<'", "'>'", "T_IF", "T_LTE", "T_ELSE", "T_WHILE", "T_FOR",
+  "T_FUNC", "T_RETURN", "T_CMP", "T_PRINT", "T_NOELSE", "T_NEQ", "T_GTE",
+  "T_INC", "T_DEC", "T_FUNCTION", "T_SWITCH", "T_CASE", "T_DEFAULT",
+  "T_ADD_ASSIGN", "T_MINUS_ASSIGN", "T_TIMES_ASSIGN", "T_DIV_ASSIGN",
+  "T_REM_ASSIGN", "T_NUM", "T_ID", "T_STR_LIT", "'='", "'('", "')'", "';'",
+  "'{'", "'}'", "':'", "','", "$accept", "start", "top_statement_list",
   "top_statement", "inner_statement_list", "inner_statement",
   "function_keyword", "statement", "assignment_statement",
   "print_statement", "return_statement", "optional_expression",
   "compound_statement", "expression_statement",
-  "if_statement_without_else", "selection_statement",
+  "if_statement_without_else", "selection_statement", "case_list",
+  "case_clause", "case_label_list", "case_label",
   "function_decl_statement", "optional_parameter_list", "parameter_list",
   "parameter", "optional_argument_list", "argument_list", "argument",
   "expr", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,    60,    62,    45,
-      43,    42,    47,    37,   262,   263,   264,   265,   266,   267,
-     268,   269,   270,   271,   272,   273,   274,   275,    61,    40,
-      41,    59,   123,   125,    44
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -34
+#define YYPACT_NINF (-44)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-34)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -1
+#define YYTABLE_NINF (-1)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     -34,     6,   203,   -34,    64,   -20,   -17,     4,   -34,    64,
-       5,   -34,   -34,   -21,   -34,    64,   -34,   -34,    41,   -34,
-      55,    56,   -34,   -34,   -34,    77,   -34,   -34,    11,   -19,
-      59,    64,    64,    68,    65,   233,    64,   -34,   -34,    64,
-      64,    97,   182,    66,   -34,   -34,    90,    64,    64,    64,
-      64,    64,    64,    64,    64,    64,    64,    64,   -34,   108,
-     136,    69,    67,   -34,   147,   233,    93,    91,   -34,   233,
-     -34,   -34,   -34,   -34,    98,   -34,   124,    70,   161,   240,
-     246,    28,    59,    18,    13,   113,   -34,    90,    90,    64,
-     -34,   -34,    64,   -34,   131,   128,   -34,   -34,   -34,    53,
-     -34,    90,    98,    64,   -34,   -34,   175,    90,   -34
+     -44,     9,   166,   -44,    11,   -33,   -25,   -11,   -44,    11,
+     -10,     6,    13,   -44,    30,   -44,   -20,   -44,    11,   -44,
+     -44,    63,   -44,    59,    64,   -44,   -44,   -44,    93,   -44,
+     -44,   136,   -12,    72,    11,    11,   194,    69,   365,    11,
+     -44,   -44,    11,   -44,   -44,    11,    11,   240,    97,    79,
+     -44,   -44,    74,    11,    11,    11,    11,    11,    11,    11,
+      11,    11,    11,    11,    11,    11,    11,    11,    11,   -44,
+     259,   278,    70,   335,   -44,   297,   316,   365,    95,   103,
+     -44,   365,   -44,   -44,   -44,   -44,    83,   -44,   -44,    72,
+      77,    92,   132,   145,    85,   393,   384,    15,   120,   365,
+     365,   365,   365,   365,    74,    74,    11,   -44,    96,   -44,
+      11,   -44,   117,   115,   -44,   -44,   -44,    65,   -44,   -44,
+      74,    83,   194,     2,   -44,   -44,   121,   204,     4,   118,
+     -44,   -44,    74,    74,   128,   -44,   -44,   -36,   -44,   -44,
+     -44,   -44,   -44,   -44,     4,   166,   166,   -44
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       4,     0,     2,     1,     0,     0,     0,     0,     9,    20,
-       0,    10,    56,    57,    58,     0,     7,     3,     0,     5,
-       0,     0,    15,    12,    13,    26,    14,    11,     0,    57,
-      55,     0,     0,     0,     0,    19,     0,    52,    53,     0,
-      37,     0,     0,     0,    23,    24,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,    22,     0,
-       0,     0,     0,    18,     0,    16,     0,    36,    38,    40,
-      59,    21,     6,     8,    32,    27,    48,    50,    49,    51,
-      45,    46,    42,    41,    43,    44,    47,     0,     0,     0,
-      17,    54,     0,    35,     0,    31,    33,    25,    28,     0,
-      39,     0,     0,     0,    30,    34,     0,     0,    29
+       4,     0,     2,     1,     0,     0,     0,     0,     9,    25,
+       0,     0,     0,    10,     0,    74,    75,    76,     0,     7,
+       3,     0,     5,     0,     0,    15,    12,    13,    31,    14,
+      11,     0,    75,    73,     0,     0,     0,     0,    24,     0,
+      70,    71,     0,    68,    69,     0,    53,     0,     0,     0,
+      28,    29,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    27,
+       0,     0,     0,     0,    23,     0,     0,    16,     0,    52,
+      54,    56,    77,    26,     6,     8,    48,    32,    63,    58,
+      57,    59,    60,    61,    62,    66,    64,    65,    67,    17,
+      18,    19,    20,    21,     0,     0,     0,    22,     0,    72,
+       0,    51,     0,    47,    49,    30,    33,     0,    38,    55,
+       0,     0,     0,     0,    46,    50,     0,     0,     0,     0,
+      36,    37,     0,     0,     0,    43,    45,     0,    41,     7,
+      35,    34,    44,     7,     0,    40,    39,    42
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-     -34,   -34,   -34,   -34,   -34,   -34,   -34,   121,   132,   -34,
-     -34,   -34,   -33,   -34,   -34,   -34,   -34,   -34,   -34,    62,
-     -34,   -34,    83,    -4
+     -44,   -44,   -44,   -44,   -43,   -44,   -44,   160,   -35,   -44,
+     -44,   -44,   -39,   -44,   -44,   -44,   -44,   -44,   -44,    19,
+     -44,   -44,   -44,    48,   -44,   -44,    61,    -4
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,     1,     2,    17,    42,    72,    18,    19,    20,    21,
-      22,    34,    23,    24,    25,    26,    27,    94,    95,    96,
-      66,    67,    68,    28
+       0,     1,     2,    20,    48,    84,    21,    85,    23,    24,
+      25,    37,    26,    27,    28,    29,   123,   131,   137,   138,
+      30,   112,   113,   114,    78,    79,    80,    31
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      30,    37,    38,    37,    38,    35,     3,    39,    40,    31,
-      40,    41,    32,    75,    47,    48,    49,    50,    51,    52,
-      53,    54,    55,    56,    57,    56,    57,    59,    60,    55,
-      56,    57,    64,    33,    36,    65,    69,    53,    54,    55,
-      56,    57,    58,    76,    77,    78,    79,    80,    81,    82,
-      83,    84,    85,    86,    97,    98,    47,    48,    49,    50,
-      51,    52,    53,    54,    55,    56,    57,    43,   104,    54,
-      55,    56,    57,     4,   108,    49,    50,    51,    52,    53,
-      54,    55,    56,    57,   103,    99,    44,    45,    69,    12,
-      29,    14,    46,    15,    61,    74,    63,    39,    89,   106,
-      47,    48,    49,    50,    51,    52,    53,    54,    55,    56,
-      57,    47,    48,    49,    50,    51,    52,    53,    54,    55,
-      56,    57,    16,    91,    93,    92,    57,    70,    48,    49,
-      50,    51,    52,    53,    54,    55,    56,    57,    87,    47,
-      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
-      47,    48,    49,    50,    51,    52,    53,    54,    55,    56,
-      57,   101,   102,    73,   105,    62,    88,    50,    51,    52,
-      53,    54,    55,    56,    57,   100,     0,    90,    47,    48,
-      49,    50,    51,    52,    53,    54,    55,    56,    57,     0,
-       0,     4,     0,     0,     0,     0,     5,     0,     6,     7,
-       8,     9,    10,     0,     0,   107,    11,    12,    13,    14,
-       0,    15,     4,     0,    16,    71,     0,     5,     0,     6,
-       7,     8,     9,    10,     0,     0,     0,    11,    12,    13,
-      14,     0,    15,     0,     0,    16,    47,    48,    49,    50,
-      51,    52,    53,    54,    55,    56,    57,    51,    52,    53,
-      54,    55,    56,    57,    52,    53,    54,    55,    56,    57
+      33,    72,    43,    44,    34,    38,   143,   144,   134,     3,
+      43,    44,    35,    87,    47,     4,    45,    46,    53,    54,
+      55,    56,    57,    58,    59,    46,    36,    39,   128,   129,
+      70,    71,    73,    11,    12,    75,    63,   135,    76,   136,
+      40,    77,    81,   130,    15,    32,    17,    41,    18,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,    98,
+      99,   100,   101,   102,   103,   115,   116,    42,    53,    54,
+      55,    56,    57,    58,    59,    53,    60,    55,    56,    57,
+      53,   124,    61,    56,    57,    62,    63,   126,    53,    54,
+      55,    56,    57,   140,   141,    53,   145,    49,    50,    57,
+     146,     4,   117,    51,   122,    52,    81,     5,    74,   106,
+       6,     7,     8,     9,    19,    10,    86,   111,   127,    11,
+      12,    13,    14,    53,    54,    55,    56,    57,    58,    59,
+      15,    16,    17,   109,    18,    53,   118,    19,    83,    53,
+      54,    55,    56,    57,    58,    59,   110,    60,    53,    54,
+      55,    56,    57,    61,    59,   120,    62,    63,   121,   132,
+     139,   142,    22,   147,    64,    65,    66,    67,    68,   125,
+       4,   119,     0,     0,     0,    69,     5,     0,     0,     6,
+       7,     8,     9,     0,    10,     0,     0,     0,    11,    12,
+      13,    14,     0,     0,     0,     0,     0,     0,     4,    15,
+      16,    17,     0,    18,     0,     0,    19,    53,    54,    55,
+      56,    57,    58,    59,     0,    60,    11,    12,     0,     0,
+       0,    61,     0,     0,    62,    63,     0,    15,    16,    17,
+       0,    18,    64,    65,    66,    67,    68,     0,     0,     0,
+       0,     0,   133,    53,    54,    55,    56,    57,    58,    59,
+       0,    60,     0,     0,     0,     0,     0,    61,     0,     0,
+      62,    63,    53,    54,    55,    56,    57,    58,    59,     0,
+      60,     0,     0,     0,     0,     0,    61,     0,    82,    62,
+      63,    53,    54,    55,    56,    57,    58,    59,     0,    60,
+       0,     0,     0,     0,     0,    61,     0,   104,    62,    63,
+      53,    54,    55,    56,    57,    58,    59,     0,    60,     0,
+       0,     0,     0,     0,    61,     0,   105,    62,    63,    53,
+      54,    55,    56,    57,    58,    59,     0,    60,     0,     0,
+       0,     0,     0,    61,     0,   107,    62,    63,    53,    54,
+      55,    56,    57,    58,    59,     0,    60,     0,     0,     0,
+       0,     0,    61,     0,   108,    62,    63,     0,     0,     0,
+       0,     0,     0,    64,    65,    66,    67,    68,    53,    54,
+      55,    56,    57,    58,    59,     0,    60,     0,     0,     0,
+       0,     0,    61,     0,     0,    62,    63,    53,    54,    55,
+      56,    57,    58,    59,     0,    60,    53,    54,    55,    56,
+      57,    58,    59,     0,    62,    63,     0,     0,     0,     0,
+       0,     0,     0,    62,    63
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       4,    22,    23,    22,    23,     9,     0,    28,    29,    29,
-      29,    15,    29,    46,     3,     4,     5,     6,     7,     8,
-       9,    10,    11,    12,    13,    12,    13,    31,    32,    11,
-      12,    13,    36,    29,    29,    39,    40,     9,    10,    11,
-      12,    13,    31,    47,    48,    49,    50,    51,    52,    53,
-      54,    55,    56,    57,    87,    88,     3,     4,     5,     6,
-       7,     8,     9,    10,    11,    12,    13,    26,   101,    10,
-      11,    12,    13,     9,   107,     5,     6,     7,     8,     9,
-      10,    11,    12,    13,    31,    89,    31,    31,    92,    25,
-      26,    27,    15,    29,    26,    29,    31,    28,    31,   103,
-       3,     4,     5,     6,     7,     8,     9,    10,    11,    12,
-      13,     3,     4,     5,     6,     7,     8,     9,    10,    11,
-      12,    13,    32,    30,    26,    34,    13,    30,     4,     5,
-       6,     7,     8,     9,    10,    11,    12,    13,    30,     3,
-       4,     5,     6,     7,     8,     9,    10,    11,    12,    13,
-       3,     4,     5,     6,     7,     8,     9,    10,    11,    12,
-      13,    30,    34,    42,   102,    33,    30,     6,     7,     8,
-       9,    10,    11,    12,    13,    92,    -1,    30,     3,     4,
-       5,     6,     7,     8,     9,    10,    11,    12,    13,    -1,
-      -1,     9,    -1,    -1,    -1,    -1,    14,    -1,    16,    17,
-      18,    19,    20,    -1,    -1,    30,    24,    25,    26,    27,
-      -1,    29,     9,    -1,    32,    33,    -1,    14,    -1,    16,
-      17,    18,    19,    20,    -1,    -1,    -1,    24,    25,    26,
-      27,    -1,    29,    -1,    -1,    32,     3,     4,     5,     6,
-       7,     8,     9,    10,    11,    12,    13,     7,     8,     9,
-      10,    11,    12,    13,     8,     9,    10,    11,    12,    13
+       4,    36,    22,    23,    37,     9,    42,    43,     4,     0,
+      22,    23,    37,    52,    18,     4,    36,    37,     3,     4,
+       5,     6,     7,     8,     9,    37,    37,    37,    26,    27,
+      34,    35,    36,    22,    23,    39,    21,    33,    42,    35,
+      34,    45,    46,    41,    33,    34,    35,    34,    37,    53,
+      54,    55,    56,    57,    58,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,   104,   105,    37,     3,     4,
+       5,     6,     7,     8,     9,     3,    11,     5,     6,     7,
+       3,   120,    17,     6,     7,    20,    21,   122,     3,     4,
+       5,     6,     7,   132,   133,     3,   139,    34,    39,     7,
+     143,     4,   106,    39,    39,    12,   110,    10,    39,    39,
+      13,    14,    15,    16,    40,    18,    37,    34,   122,    22,
+      23,    24,    25,     3,     4,     5,     6,     7,     8,     9,
+      33,    34,    35,    38,    37,     3,    40,    40,    41,     3,
+       4,     5,     6,     7,     8,     9,    43,    11,     3,     4,
+       5,     6,     7,    17,     9,    38,    20,    21,    43,    38,
+      42,    33,     2,   144,    28,    29,    30,    31,    32,   121,
+       4,   110,    -1,    -1,    -1,    39,    10,    -1,    -1,    13,
+      14,    15,    16,    -1,    18,    -1,    -1,    -1,    22,    23,
+      24,    25,    -1,    -1,    -1,    -1,    -1,    -1,     4,    33,
+      34,    35,    -1,    37,    -1,    -1,    40,     3,     4,     5,
+       6,     7,     8,     9,    -1,    11,    22,    23,    -1,    -1,
+      -1,    17,    -1,    -1,    20,    21,    -1,    33,    34,    35,
+      -1,    37,    28,    29,    30,    31,    32,    -1,    -1,    -1,
+      -1,    -1,    38,     3,     4,     5,     6,     7,     8,     9,
+      -1,    11,    -1,    -1,    -1,    -1,    -1,    17,    -1,    -1,
+      20,    21,     3,     4,     5,     6,     7,     8,     9,    -1,
+      11,    -1,    -1,    -1,    -1,    -1,    17,    -1,    38,    20,
+      21,     3,     4,     5,     6,     7,     8,     9,    -1,    11,
+      -1,    -1,    -1,    -1,    -1,    17,    -1,    38,    20,    21,
+       3,     4,     5,     6,     7,     8,     9,    -1,    11,    -1,
+      -1,    -1,    -1,    -1,    17,    -1,    38,    20,    21,     3,
+       4,     5,     6,     7,     8,     9,    -1,    11,    -1,    -1,
+      -1,    -1,    -1,    17,    -1,    38,    20,    21,     3,     4,
+       5,     6,     7,     8,     9,    -1,    11,    -1,    -1,    -1,
+      -1,    -1,    17,    -1,    38,    20,    21,    -1,    -1,    -1,
+      -1,    -1,    -1,    28,    29,    30,    31,    32,     3,     4,
+       5,     6,     7,     8,     9,    -1,    11,    -1,    -1,    -1,
+      -1,    -1,    17,    -1,    -1,    20,    21,     3,     4,     5,
+       6,     7,     8,     9,    -1,    11,     3,     4,     5,     6,
+       7,     8,     9,    -1,    20,    21,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    20,    21
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       0,    36,    37,     0,     9,    14,    16,    17,    18,    19,
-      20,    24,    25,    26,    27,    29,    32,    38,    41,    42,
-      43,    44,    45,    47,    48,    49,    50,    51,    58,    26,
-      58,    29,    29,    29,    46,    58,    29,    22,    23,    28,
-      29,    58,    39,    26,    31,    31,    15,     3,     4,     5,
-       6,     7,     8,     9,    10,    11,    12,    13,    31,    58,
-      58,    26,    43,    31,    58,    58,    55,    56,    57,    58,
-      30,    33,    40,    42,    29,    47,    58,    58,    58,    58,
-      58,    58,    58,    58,    58,    58,    58,    30,    30,    31,
-      30,    30,    34,    26,    52,    53,    54,    47,    47,    58,
-      57,    30,    34,    31,    47,    54,    58,    30,    47
+       0,    45,    46,     0,     4,    10,    13,    14,    15,    16,
+      18,    22,    23,    24,    25,    33,    34,    35,    37,    40,
+      47,    50,    51,    52,    53,    54,    56,    57,    58,    59,
+      64,    71,    34,    71,    37,    37,    37,    55,    71,    37,
+      34,    34,    37,    22,    23,    36,    37,    71,    48,    34,
+      39,    39,    12,     3,     4,     5,     6,     7,     8,     9,
+      11,    17,    20,    21,    28,    29,    30,    31,    32,    39,
+      71,    71,    52,    71,    39,    71,    71,    71,    68,    69,
+      70,    71,    38,    41,    49,    51,    37,    56,    71,    71,
+      71,    71,    71,    71,    71,    71,    71,    71,    71,    71,
+      71,    71,    71,    71,    38,    38,    39,    38,    38,    38,
+      43,    34,    65,    66,    67,    56,    56,    71,    40,    70,
+      38,    43,    39,    60,    56,    67,    52,    71,    26,    27,
+      41,    61,    38,    38,     4,    33,    35,    62,    63,    42,
+      56,    56,    33,    42,    43,    48,    48,    63
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       0,    35,    36,    37,    37,    38,    39,    39,    40,    41,
-      41,    42,    42,    42,    42,    42,    43,    44,    45,    46,
-      46,    47,    48,    48,    48,    49,    50,    50,    50,    50,
-      51,    52,    52,    53,    53,    54,    55,    55,    56,    56,
-      57,    58,    58,    58,    58,    58,    58,    58,    58,    58,
-      58,    58,    58,    58,    58,    58,    58,    58,    58,    58
+       0,    44,    45,    46,    46,    47,    48,    48,    49,    50,
+      50,    51,    51,    51,    51,    51,    52,    52,    52,    52,
+      52,    52,    53,    54,    55,    55,    56,    57,    57,    57,
+      58,    59,    59,    59,    59,    59,    59,    60,    60,    61,
+      61,    62,    62,    63,    63,    63,    64,    65,    65,    66,
+      66,    67,    68,    68,    69,    69,    70,    71,    71,    71,
+      71,    71,    71,    71,    71,    71,    71,    71,    71,    71,
+      71,    71,    71,    71,    71,    71,    71,    71
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     0,     1,     2,     0,     1,     1,
-       1,     1,     1,     1,     1,     1,     3,     4,     3,     1,
-       0,     3,     2,     2,     2,     5,     1,     3,     5,     9,
-       6,     1,     0,     1,     3,     1,     1,     0,     1,     3,
-       1,     3,     3,     3,     3,     3,     3,     3,     3,     3,
-       3,     3,     2,     2,     4,     2,     1,     1,     1,     3
+       1,     1,     1,     1,     1,     1,     3,     3,     3,     3,
+       3,     3,     4,     3,     1,     0,     3,     2,     2,     2,
+       5,     1,     3,     5,     9,     9,     7,     2,     0,     4,
+       3,     1,     3,     1,     2,     1,     6,     1,     0,     1,
+       3,     1,     1,     0,     1,     3,     1,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     2,     2,
+       2,     2,     4,     2,     1,     1,     1,     3
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (&yylloc, ast, scanner, YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, ast, scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -788,20 +1000,27 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
 YY_ATTRIBUTE_UNUSED
-static unsigned
+static int
 yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
 {
-  unsigned res = 0;
+  int res = 0;
   int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
   if (0 <= yylocp->first_line)
     {
@@ -821,65 +1040,73 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location, ast, scanner); \
+                  Kind, Value, Location, ast, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, ast_node** ast, yyscan_t scanner)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, ast_node** ast, yyscan_t scanner)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
-  YYUSE (yylocationp);
-  YYUSE (ast);
-  YYUSE (scanner);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (ast);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, ast_node** ast, yyscan_t scanner)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, ast_node** ast, yyscan_t scanner)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyoutput, *yylocationp);
-  YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp, ast, scanner);
-  YYFPRINTF (yyoutput, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, ast, scanner);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -888,7 +1115,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYL
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -911,21 +1138,22 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, ast_node** ast, yyscan_t scanner)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, ast_node** ast, yyscan_t scanner)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       , ast, scanner);
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), ast, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -940,8 +1168,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -964,28 +1192,77 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yystrlen (const char *yystr)
 {
-  YYSIZE_T yylen;
+  YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -999,10 +1276,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1010,14 +1287,13 @@ yystpcpy (char *yydest, const char *yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yytnamerr (char *yyres, const char *yystr)
 {
   if (*yystr == '"')
     {
-      YYSIZE_T yyn = 0;
+      YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1028,7 +1304,10 @@ yytnamerr (char *yyres, const char *yystr)
           case '\\':
             if (*++yyp != '\\')
               goto do_not_strip_quotes;
-            /* Fall through.  */
+            else
+              goto append;
+
+          append:
           default:
             if (yyres)
               yyres[yyn] = *yyp;
@@ -1043,36 +1322,20 @@ yytnamerr (char *yyres, const char *yystr)
     do_not_strip_quotes: ;
     }
 
-  if (! yyres)
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
     return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
+  /* Actual size of YYARG. */
   int yycount = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1096,63 +1359,78 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
+    default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
       YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1161,7 +1439,7 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1173,42 +1451,45 @@ yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
         {
-          yyp++;
-          yyformat++;
+          ++yyp;
+          ++yyformat;
         }
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, ast_node** ast, yyscan_t scanner)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, ast_node** ast, yyscan_t scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
-  YYUSE (ast);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (ast);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1216,7 +1497,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 int
 yyparse (ast_node** ast, yyscan_t scanner)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1235,55 +1516,50 @@ static YYLTYPE yyloc_default
 YYLTYPE yylloc = yyloc_default;
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYSIZE_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1291,43 +1567,49 @@ YYLTYPE yylloc = yyloc_default;
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
         YYLTYPE *yyls1 = yyls;
 
         /* Each stack pointer address is followed by the size of the
@@ -1335,32 +1617,29 @@ YYLTYPE yylloc = yyloc_default;
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
-                    &yyls1, yysize * sizeof (*yylsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
                     &yystacksize);
-
-        yyls = yyls1;
         yyss = yyss1;
         yyvs = yyvs1;
+        yyls = yyls1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
@@ -1369,31 +1648,32 @@ YYLTYPE yylloc = yyloc_default;
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
       yylsp = yyls + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1404,18 +1684,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, &yylloc, scanner);
     }
 
-  if (yychar <= YYEOF)
+  if (yychar <= END)
     {
-      yychar = yytoken = YYEOF;
+      yychar = END;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1443,15 +1735,14 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
   *++yylsp = yylloc;
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1466,7 +1757,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1482,386 +1773,527 @@ yyreduce:
      GCC warning that YYVAL may be used uninitialized.  */
   yyval = yyvsp[1-yylen];
 
-  /* Default location.  */
+  /* Default location. */
   YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 117 "parser.y" /* yacc.c:1646  */
-    { *ast = (yyvsp[0].ast); }
-#line 1494 "parser.c" /* yacc.c:1646  */
+  case 2: /* start: top_statement_list  */
+#line 197 "parser.y"
+                    { *ast = (yyvsp[0].ast); }
+#line 1786 "parser.c"
     break;
 
-  case 3:
-#line 121 "parser.y" /* yacc.c:1646  */
-    { ast_node_statement_list_push((yyvsp[-1].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-1].ast); }
-#line 1500 "parser.c" /* yacc.c:1646  */
+  case 3: /* top_statement_list: top_statement_list top_statement  */
+#line 201 "parser.y"
+                                  { 
+	/* With --stream the statement is compiled and executed right away */
+	if(!como_stream_statement((yyvsp[0].ast))) {
+		ast_node_statement_list_push((yyvsp[-1].ast), (yyvsp[0].ast));
+	}
+	(yyval.ast) = (yyvsp[-1].ast); 
+ }
+#line 1798 "parser.c"
     break;
 
-  case 4:
-#line 122 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(0); }
-#line 1506 "parser.c" /* yacc.c:1646  */
+  case 4: /* top_statement_list: %empty  */
+#line 208 "parser.y"
+          { (yyval.ast) = ast_node_create_statement_list(0); }
+#line 1804 "parser.c"
     break;
 
-  case 5:
-#line 126 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1512 "parser.c" /* yacc.c:1646  */
+  case 5: /* top_statement: statement  */
+#line 212 "parser.y"
+           { (yyval.ast) = (yyvsp[0].ast); }
+#line 1810 "parser.c"
     break;
 
-  case 6:
-#line 130 "parser.y" /* yacc.c:1646  */
-    { ast_node_statement_list_push((yyvsp[-1].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-1].ast); }
-#line 1518 "parser.c" /* yacc.c:1646  */
+  case 6: /* inner_statement_list: inner_statement_list inner_statement  */
+#line 216 "parser.y"
+                                      { ast_node_statement_list_push((yyvsp[-1].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-1].ast); }
+#line 1816 "parser.c"
     break;
 
-  case 7:
-#line 131 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(0); }
-#line 1524 "parser.c" /* yacc.c:1646  */
+  case 7: /* inner_statement_list: %empty  */
+#line 217 "parser.y"
+          { (yyval.ast) = ast_node_create_statement_list(0); }
+#line 1822 "parser.c"
     break;
 
-  case 8:
-#line 135 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1530 "parser.c" /* yacc.c:1646  */
+  case 8: /* inner_statement: statement  */
+#line 221 "parser.y"
+           { (yyval.ast) = (yyvsp[0].ast); }
+#line 1828 "parser.c"
     break;
 
-  case 11:
-#line 143 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1536 "parser.c" /* yacc.c:1646  */
+  case 11: /* statement: function_decl_statement  */
+#line 229 "parser.y"
+                         { (yyval.ast) = (yyvsp[0].ast); }
+#line 1834 "parser.c"
     break;
 
-  case 12:
-#line 145 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1542 "parser.c" /* yacc.c:1646  */
+  case 12: /* statement: compound_statement  */
+#line 231 "parser.y"
+                      { (yyval.ast) = (yyvsp[0].ast); }
+#line 1840 "parser.c"
     break;
 
-  case 13:
-#line 147 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1548 "parser.c" /* yacc.c:1646  */
+  case 13: /* statement: expression_statement  */
+#line 233 "parser.y"
+                      { (yyval.ast) = (yyvsp[0].ast); }
+#line 1846 "parser.c"
     break;
 
-  case 14:
-#line 149 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1554 "parser.c" /* yacc.c:1646  */
+  case 14: /* statement: selection_statement  */
+#line 235 "parser.y"
+                      { (yyval.ast) = (yyvsp[0].ast); }
+#line 1852 "parser.c"
     break;
 
-  case 15:
-#line 151 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1560 "parser.c" /* yacc.c:1646  */
+  case 15: /* statement: return_statement  */
+#line 237 "parser.y"
+                  { (yyval.ast) = (yyvsp[0].ast); }
+#line 1858 "parser.c"
     break;
 
-  case 16:
-#line 155 "parser.y" /* yacc.c:1646  */
-    {
+  case 16: /* assignment_statement: T_ID '=' expr  */
+#line 241 "parser.y"
+                      {
  		(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_ASSIGN, ast_node_create_id((yyvsp[-2].id)), (yyvsp[0].ast)); 
  		free((yyvsp[-2].id)); 
 	}
-#line 1569 "parser.c" /* yacc.c:1646  */
+#line 1867 "parser.c"
     break;
 
-  case 17:
-#line 162 "parser.y" /* yacc.c:1646  */
-    {
+  case 17: /* assignment_statement: expr T_ADD_ASSIGN expr  */
+#line 246 "parser.y"
+                               {
+		(yyval.ast) = compound_assignment(&(yylsp[-1]), ast, scanner, AST_BINARY_OP_ADD, (yyvsp[-2].ast), (yyvsp[0].ast));
+	}
+#line 1875 "parser.c"
+    break;
+
+  case 18: /* assignment_statement: expr T_MINUS_ASSIGN expr  */
+#line 250 "parser.y"
+                                 {
+		(yyval.ast) = compound_assignment(&(yylsp[-1]), ast, scanner, AST_BINARY_OP_MINUS, (yyvsp[-2].ast), (yyvsp[0].ast));
+	}
+#line 1883 "parser.c"
+    break;
+
+  case 19: /* assignment_statement: expr T_TIMES_ASSIGN expr  */
+#line 254 "parser.y"
+                                 {
+		(yyval.ast) = compound_assignment(&(yylsp[-1]), ast, scanner, AST_BINARY_OP_TIMES, (yyvsp[-2].ast), (yyvsp[0].ast));
+	}
+#line 1891 "parser.c"
+    break;
+
+  case 20: /* assignment_statement: expr T_DIV_ASSIGN expr  */
+#line 258 "parser.y"
+                               {
+		(yyval.ast) = compound_assignment(&(yylsp[-1]), ast, scanner, AST_BINARY_OP_DIV, (yyvsp[-2].ast), (yyvsp[0].ast));
+	}
+#line 1899 "parser.c"
+    break;
+
+  case 21: /* assignment_statement: expr T_REM_ASSIGN expr  */
+#line 262 "parser.y"
+                               {
+		(yyval.ast) = compound_assignment(&(yylsp[-1]), ast, scanner, AST_BINARY_OP_REM, (yyvsp[-2].ast), (yyvsp[0].ast));
+	}
+#line 1907 "parser.c"
+    break;
+
+  case 22: /* print_statement: T_PRINT '(' expr ')'  */
+#line 268 "parser.y"
+                             {
 		(yyval.ast) = ast_node_create_print((yyvsp[-1].ast));
 	}
-#line 1577 "parser.c" /* yacc.c:1646  */
+#line 1915 "parser.c"
     break;
 
-  case 18:
-#line 168 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_return((yyvsp[-1].ast)); }
-#line 1583 "parser.c" /* yacc.c:1646  */
+  case 23: /* return_statement: T_RETURN optional_expression ';'  */
+#line 274 "parser.y"
+                                  { (yyval.ast) = ast_node_create_return((yyvsp[-1].ast)); }
+#line 1921 "parser.c"
     break;
 
-  case 19:
-#line 172 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1589 "parser.c" /* yacc.c:1646  */
+  case 24: /* optional_expression: expr  */
+#line 278 "parser.y"
+      { (yyval.ast) = (yyvsp[0].ast); }
+#line 1927 "parser.c"
     break;
 
-  case 20:
-#line 173 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = NULL; }
-#line 1595 "parser.c" /* yacc.c:1646  */
+  case 25: /* optional_expression: %empty  */
+#line 279 "parser.y"
+          { (yyval.ast) = NULL; }
+#line 1933 "parser.c"
     break;
 
-  case 21:
-#line 177 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1601 "parser.c" /* yacc.c:1646  */
+  case 26: /* compound_statement: '{' inner_statement_list '}'  */
+#line 283 "parser.y"
+                              { (yyval.ast) = (yyvsp[-1].ast); }
+#line 1939 "parser.c"
     break;
 
-  case 22:
-#line 181 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1607 "parser.c" /* yacc.c:1646  */
+  case 27: /* expression_statement: expr ';'  */
+#line 287 "parser.y"
+          { (yyval.ast) = (yyvsp[-1].ast); }
+#line 1945 "parser.c"
     break;
 
-  case 23:
-#line 183 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1613 "parser.c" /* yacc.c:1646  */
+  case 28: /* expression_statement: assignment_statement ';'  */
+#line 289 "parser.y"
+                          { (yyval.ast) = (yyvsp[-1].ast); }
+#line 1951 "parser.c"
     break;
 
-  case 24:
-#line 185 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1619 "parser.c" /* yacc.c:1646  */
+  case 29: /* expression_statement: print_statement ';'  */
+#line 291 "parser.y"
+                     { (yyval.ast) = (yyvsp[-1].ast); }
+#line 1957 "parser.c"
     break;
 
-  case 25:
-#line 189 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_if((yyvsp[-2].ast), (yyvsp[0].ast), NULL); }
-#line 1625 "parser.c" /* yacc.c:1646  */
+  case 30: /* if_statement_without_else: T_IF '(' expr ')' compound_statement  */
+#line 295 "parser.y"
+                                      { (yyval.ast) = ast_node_create_if((yyvsp[-2].ast), (yyvsp[0].ast), NULL); }
+#line 1963 "parser.c"
     break;
 
-  case 26:
-#line 193 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1631 "parser.c" /* yacc.c:1646  */
+  case 31: /* selection_statement: if_statement_without_else  */
+#line 299 "parser.y"
+                                          { (yyval.ast) = (yyvsp[0].ast); }
+#line 1969 "parser.c"
     break;
 
-  case 27:
-#line 195 "parser.y" /* yacc.c:1646  */
-    { (yyvsp[-2].ast)->u1.if_node.b2 = (yyvsp[0].ast); (yyval.ast) = (yyvsp[-2].ast); }
-#line 1637 "parser.c" /* yacc.c:1646  */
+  case 32: /* selection_statement: if_statement_without_else T_ELSE compound_statement  */
+#line 301 "parser.y"
+                                                     { (yyvsp[-2].ast)->u1.if_node.b2 = (yyvsp[0].ast); (yyval.ast) = (yyvsp[-2].ast); }
+#line 1975 "parser.c"
     break;
 
-  case 28:
-#line 197 "parser.y" /* yacc.c:1646  */
-    {
+  case 33: /* selection_statement: T_WHILE '(' expr ')' compound_statement  */
+#line 303 "parser.y"
+                                         {
  	(yyval.ast) = ast_node_create_while((yyvsp[-2].ast), (yyvsp[0].ast));
  }
-#line 1645 "parser.c" /* yacc.c:1646  */
+#line 1983 "parser.c"
     break;
 
-  case 29:
-#line 201 "parser.y" /* yacc.c:1646  */
-    {
+  case 34: /* selection_statement: T_FOR '(' assignment_statement ';' expr ';' expr ')' compound_statement  */
+#line 307 "parser.y"
+                                                                         {
  	(yyval.ast) = ast_node_create_for((yyvsp[-6].ast), (yyvsp[-4].ast), (yyvsp[-2].ast), (yyvsp[0].ast));
  }
-#line 1653 "parser.c" /* yacc.c:1646  */
+#line 1991 "parser.c"
     break;
 
-  case 30:
-#line 207 "parser.y" /* yacc.c:1646  */
-    {
+  case 35: /* selection_statement: T_FOR '(' assignment_statement ';' expr ';' assignment_statement ')' compound_statement  */
+#line 311 "parser.y"
+                                                                                         {
+ 	(yyval.ast) = ast_node_create_for((yyvsp[-6].ast), (yyvsp[-4].ast), (yyvsp[-2].ast), (yyvsp[0].ast));
+ }
+#line 1999 "parser.c"
+    break;
+
+  case 36: /* selection_statement: T_SWITCH '(' expr ')' '{' case_list '}'  */
+#line 315 "parser.y"
+                                         {
+ 	(yyval.ast) = switch_statement(&(yylsp[-6]), ast, scanner, (yyvsp[-4].ast), (yyvsp[-1].ast));
+ }
+#line 2007 "parser.c"
+    break;
+
+  case 37: /* case_list: case_list case_clause  */
+#line 321 "parser.y"
+                       { ast_node_statement_list_push((yyvsp[-1].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-1].ast); }
+#line 2013 "parser.c"
+    break;
+
+  case 38: /* case_list: %empty  */
+#line 322 "parser.y"
+          { (yyval.ast) = ast_node_create_statement_list(0); }
+#line 2019 "parser.c"
+    break;
+
+  case 39: /* case_clause: T_CASE case_label_list ':' inner_statement_list  */
+#line 326 "parser.y"
+                                                 { 
+ 	(yyval.ast) = ast_node_create_case((yyvsp[-2].ast), (yyvsp[0].ast)); 
+ }
+#line 2027 "parser.c"
+    break;
+
+  case 40: /* case_clause: T_DEFAULT ':' inner_statement_list  */
+#line 330 "parser.y"
+                                    { (yyval.ast) = ast_node_create_case(NULL, (yyvsp[0].ast)); }
+#line 2033 "parser.c"
+    break;
+
+  case 41: /* case_label_list: case_label  */
+#line 334 "parser.y"
+            { (yyval.ast) = ast_node_create_statement_list(1, (yyvsp[0].ast)); }
+#line 2039 "parser.c"
+    break;
+
+  case 42: /* case_label_list: case_label_list ',' case_label  */
+#line 336 "parser.y"
+                                { ast_node_statement_list_push((yyvsp[-2].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-2].ast); }
+#line 2045 "parser.c"
+    break;
+
+  case 43: /* case_label: T_NUM  */
+#line 340 "parser.y"
+                 { (yyval.ast) = ast_node_create_number((yyvsp[0].number)); }
+#line 2051 "parser.c"
+    break;
+
+  case 44: /* case_label: '-' T_NUM  */
+#line 342 "parser.y"
+                 { (yyval.ast) = ast_node_create_number(-(yyvsp[0].number)); }
+#line 2057 "parser.c"
+    break;
+
+  case 45: /* case_label: T_STR_LIT  */
+#line 344 "parser.y"
+                 { (yyval.ast) = ast_node_create_string_literal((yyvsp[0].stringliteral)); free((yyvsp[0].stringliteral)); }
+#line 2063 "parser.c"
+    break;
+
+  case 46: /* function_decl_statement: function_keyword T_ID '(' optional_parameter_list ')' compound_statement  */
+#line 348 "parser.y"
+                                                                        {
 	(yyval.ast) = ast_node_create_function((yyvsp[-4].id), (yyvsp[-2].ast), (yyvsp[0].ast));
 	free((yyvsp[-4].id));
+	/* With --lazy only the location of the body is kept */
+	como_lazy_function((yyval.ast), (yylsp[0]).first_line, (yylsp[0]).first_column, 
+		(yylsp[0]).last_line, (yylsp[0]).last_column);
  }
-#line 1662 "parser.c" /* yacc.c:1646  */
+#line 2075 "parser.c"
     break;
 
-  case 31:
-#line 214 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1668 "parser.c" /* yacc.c:1646  */
+  case 47: /* optional_parameter_list: parameter_list  */
+#line 358 "parser.y"
+                { (yyval.ast) = (yyvsp[0].ast); }
+#line 2081 "parser.c"
     break;
 
-  case 32:
-#line 216 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(0); }
-#line 1674 "parser.c" /* yacc.c:1646  */
+  case 48: /* optional_parameter_list: %empty  */
+#line 360 "parser.y"
+        { (yyval.ast) = ast_node_create_statement_list(0); }
+#line 2087 "parser.c"
     break;
 
-  case 33:
-#line 220 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(1, (yyvsp[0].ast)); }
-#line 1680 "parser.c" /* yacc.c:1646  */
+  case 49: /* parameter_list: parameter  */
+#line 364 "parser.y"
+                              { (yyval.ast) = ast_node_create_statement_list(1, (yyvsp[0].ast)); }
+#line 2093 "parser.c"
     break;
 
-  case 34:
-#line 222 "parser.y" /* yacc.c:1646  */
-    { ast_node_statement_list_push((yyvsp[-2].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-2].ast); }
-#line 1686 "parser.c" /* yacc.c:1646  */
+  case 50: /* parameter_list: parameter_list ',' parameter  */
+#line 366 "parser.y"
+                              { ast_node_statement_list_push((yyvsp[-2].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-2].ast); }
+#line 2099 "parser.c"
     break;
 
-  case 35:
-#line 226 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_id((yyvsp[0].id)); free((yyvsp[0].id)); }
-#line 1692 "parser.c" /* yacc.c:1646  */
+  case 51: /* parameter: T_ID  */
+#line 370 "parser.y"
+      { (yyval.ast) = ast_node_create_id((yyvsp[0].id)); free((yyvsp[0].id)); }
+#line 2105 "parser.c"
     break;
 
-  case 36:
-#line 230 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1698 "parser.c" /* yacc.c:1646  */
+  case 52: /* optional_argument_list: argument_list  */
+#line 374 "parser.y"
+               { (yyval.ast) = (yyvsp[0].ast); }
+#line 2111 "parser.c"
     break;
 
-  case 37:
-#line 232 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(0); }
-#line 1704 "parser.c" /* yacc.c:1646  */
+  case 53: /* optional_argument_list: %empty  */
+#line 376 "parser.y"
+        { (yyval.ast) = ast_node_create_statement_list(0); }
+#line 2117 "parser.c"
     break;
 
-  case 38:
-#line 236 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_statement_list(1, (yyvsp[0].ast)); }
-#line 1710 "parser.c" /* yacc.c:1646  */
+  case 54: /* argument_list: argument  */
+#line 380 "parser.y"
+          { (yyval.ast) = ast_node_create_statement_list(1, (yyvsp[0].ast)); }
+#line 2123 "parser.c"
     break;
 
-  case 39:
-#line 238 "parser.y" /* yacc.c:1646  */
-    { ast_node_statement_list_push((yyvsp[-2].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-2].ast); }
-#line 1716 "parser.c" /* yacc.c:1646  */
+  case 55: /* argument_list: argument_list ',' argument  */
+#line 382 "parser.y"
+                            { ast_node_statement_list_push((yyvsp[-2].ast), (yyvsp[0].ast)); (yyval.ast) = (yyvsp[-2].ast); }
+#line 2129 "parser.c"
     break;
 
-  case 40:
-#line 242 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[0].ast); }
-#line 1722 "parser.c" /* yacc.c:1646  */
+  case 56: /* argument: expr  */
+#line 386 "parser.y"
+      { (yyval.ast) = (yyvsp[0].ast); }
+#line 2135 "parser.c"
     break;
 
-  case 41:
-#line 247 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_ADD, (yyvsp[-2].ast), (yyvsp[0].ast));   }
-#line 1728 "parser.c" /* yacc.c:1646  */
+  case 57: /* expr: expr '+' expr  */
+#line 391 "parser.y"
+                 { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_ADD, (yyvsp[-2].ast), (yyvsp[0].ast));   }
+#line 2141 "parser.c"
     break;
 
-  case 42:
-#line 249 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_MINUS, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1734 "parser.c" /* yacc.c:1646  */
+  case 58: /* expr: expr '-' expr  */
+#line 393 "parser.y"
+                 { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_MINUS, (yyvsp[-2].ast), (yyvsp[0].ast)); }
+#line 2147 "parser.c"
     break;
 
-  case 43:
-#line 251 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_TIMES, (yyvsp[-2].ast), (yyvsp[0].ast)); }
-#line 1740 "parser.c" /* yacc.c:1646  */
+  case 59: /* expr: expr '*' expr  */
+#line 395 "parser.y"
+                 { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_TIMES, (yyvsp[-2].ast), (yyvsp[0].ast)); }
+#line 2153 "parser.c"
     break;
 
-  case 44:
-#line 253 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_DIV, (yyvsp[-2].ast), (yyvsp[0].ast));   }
-#line 1746 "parser.c" /* yacc.c:1646  */
+  case 60: /* expr: expr '/' expr  */
+#line 397 "parser.y"
+                 { (yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_DIV, (yyvsp[-2].ast), (yyvsp[0].ast));   }
+#line 2159 "parser.c"
     break;
 
-  case 45:
-#line 255 "parser.y" /* yacc.c:1646  */
-    {
+  case 61: /* expr: expr '<' expr  */
+#line 399 "parser.y"
+               {
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_LT, (yyvsp[-2].ast), (yyvsp[0].ast));   
  }
-#line 1754 "parser.c" /* yacc.c:1646  */
+#line 2167 "parser.c"
     break;
 
-  case 46:
-#line 259 "parser.y" /* yacc.c:1646  */
-    {
+  case 62: /* expr: expr '>' expr  */
+#line 403 "parser.y"
+               {
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_GT, (yyvsp[-2].ast), (yyvsp[0].ast));   
  }
-#line 1762 "parser.c" /* yacc.c:1646  */
+#line 2175 "parser.c"
     break;
 
-  case 47:
-#line 263 "parser.y" /* yacc.c:1646  */
-    {
+  case 63: /* expr: expr '%' expr  */
+#line 407 "parser.y"
+               {
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_REM, (yyvsp[-2].ast), (yyvsp[0].ast));
  }
-#line 1770 "parser.c" /* yacc.c:1646  */
+#line 2183 "parser.c"
     break;
 
-  case 48:
-#line 267 "parser.y" /* yacc.c:1646  */
-    { 
+  case 64: /* expr: expr T_CMP expr  */
+#line 411 "parser.y"
+                 { 
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_CMP, (yyvsp[-2].ast), (yyvsp[0].ast));   
  }
-#line 1778 "parser.c" /* yacc.c:1646  */
+#line 2191 "parser.c"
     break;
 
-  case 49:
-#line 271 "parser.y" /* yacc.c:1646  */
-    {
+  case 65: /* expr: expr T_NEQ expr  */
+#line 415 "parser.y"
+                 {
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_NEQ, (yyvsp[-2].ast), (yyvsp[0].ast));   
  }
-#line 1786 "parser.c" /* yacc.c:1646  */
+#line 2199 "parser.c"
     break;
 
-  case 50:
-#line 275 "parser.y" /* yacc.c:1646  */
-    {
+  case 66: /* expr: expr T_LTE expr  */
+#line 419 "parser.y"
+                 {
 	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_LTE, (yyvsp[-2].ast), (yyvsp[0].ast));   
  }
-#line 1794 "parser.c" /* yacc.c:1646  */
+#line 2207 "parser.c"
     break;
 
-  case 51:
-#line 279 "parser.y" /* yacc.c:1646  */
-    {
+  case 67: /* expr: expr T_GTE expr  */
+#line 423 "parser.y"
+                 {
  	(yyval.ast) = ast_node_create_binary_op(AST_BINARY_OP_GTE, (yyvsp[-2].ast), (yyvsp[0].ast)); 
  }
-#line 1802 "parser.c" /* yacc.c:1646  */
+#line 2215 "parser.c"
     break;
 
-  case 52:
-#line 283 "parser.y" /* yacc.c:1646  */
-    {
+  case 68: /* expr: T_ID T_INC  */
+#line 427 "parser.y"
+            {
  	(yyval.ast) =ast_node_create_postfix_op(AST_POSTFIX_OP_INC, ast_node_create_id((yyvsp[-1].id)));
   	free((yyvsp[-1].id));
  }
-#line 1811 "parser.c" /* yacc.c:1646  */
+#line 2224 "parser.c"
     break;
 
-  case 53:
-#line 288 "parser.y" /* yacc.c:1646  */
-    {
+  case 69: /* expr: T_ID T_DEC  */
+#line 432 "parser.y"
+            {
  	(yyval.ast) =ast_node_create_postfix_op(AST_POSTFIX_OP_DEC, ast_node_create_id((yyvsp[-1].id)));
   	free((yyvsp[-1].id));
  }
-#line 1820 "parser.c" /* yacc.c:1646  */
+#line 2233 "parser.c"
     break;
 
-  case 54:
-#line 293 "parser.y" /* yacc.c:1646  */
-    {
+  case 70: /* expr: T_INC T_ID  */
+#line 437 "parser.y"
+            {
+ 	(yyval.ast) = ast_node_create_prefix_op(AST_PREFIX_OP_INC, ast_node_create_id((yyvsp[0].id)));
+  	free((yyvsp[0].id));
+ }
+#line 2242 "parser.c"
+    break;
+
+  case 71: /* expr: T_DEC T_ID  */
+#line 442 "parser.y"
+            {
+ 	(yyval.ast) = ast_node_create_prefix_op(AST_PREFIX_OP_DEC, ast_node_create_id((yyvsp[0].id)));
+  	free((yyvsp[0].id));
+ }
+#line 2251 "parser.c"
+    break;
+
+  case 72: /* expr: T_ID '(' optional_argument_list ')'  */
+#line 447 "parser.y"
+                                     {
 	(yyval.ast) = ast_node_create_call(ast_node_create_id((yyvsp[-3].id)), (yyvsp[-1].ast), (yylsp[-3]).first_line, (yylsp[-3]).first_column);
   	free((yyvsp[-3].id));
  }
-#line 1829 "parser.c" /* yacc.c:1646  */
+#line 2260 "parser.c"
     break;
 
-  case 55:
-#line 298 "parser.y" /* yacc.c:1646  */
-    {
+  case 73: /* expr: '-' expr  */
+#line 452 "parser.y"
+          {
  	(yyval.ast) = ast_node_create_unary_op(AST_UNARY_OP_MINUS, (yyvsp[0].ast));
  }
-#line 1837 "parser.c" /* yacc.c:1646  */
+#line 2268 "parser.c"
     break;
 
-  case 56:
-#line 302 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_number((yyvsp[0].number)); }
-#line 1843 "parser.c" /* yacc.c:1646  */
+  case 74: /* expr: T_NUM  */
+#line 456 "parser.y"
+                 { (yyval.ast) = ast_node_create_number((yyvsp[0].number)); }
+#line 2274 "parser.c"
     break;
 
-  case 57:
-#line 304 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_id((yyvsp[0].id));  free((yyvsp[0].id)); }
-#line 1849 "parser.c" /* yacc.c:1646  */
+  case 75: /* expr: T_ID  */
+#line 458 "parser.y"
+                 { (yyval.ast) = ast_node_create_id((yyvsp[0].id));  free((yyvsp[0].id)); }
+#line 2280 "parser.c"
     break;
 
-  case 58:
-#line 306 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = ast_node_create_string_literal((yyvsp[0].stringliteral)); free((yyvsp[0].stringliteral)); }
-#line 1855 "parser.c" /* yacc.c:1646  */
+  case 76: /* expr: T_STR_LIT  */
+#line 460 "parser.y"
+                 { (yyval.ast) = ast_node_create_string_literal((yyvsp[0].stringliteral)); free((yyvsp[0].stringliteral)); }
+#line 2286 "parser.c"
     break;
 
-  case 59:
-#line 308 "parser.y" /* yacc.c:1646  */
-    { (yyval.ast) = (yyvsp[-1].ast); }
-#line 1861 "parser.c" /* yacc.c:1646  */
+  case 77: /* expr: '(' expr ')'  */
+#line 462 "parser.y"
+                 { (yyval.ast) = (yyvsp[-1].ast); }
+#line 2292 "parser.c"
     break;
 
 
-#line 1865 "parser.c" /* yacc.c:1646  */
+#line 2296 "parser.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1875,11 +2307,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -1887,14 +2318,13 @@ yyreduce:
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -1905,59 +2335,54 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (&yylloc, ast, scanner, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (&yylloc, ast, scanner, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
          error, discard it.  */
 
-      if (yychar <= YYEOF)
+      if (yychar <= END)
         {
           /* Return failure if at end of input.  */
-          if (yychar == YYEOF)
+          if (yychar == END)
             YYABORT;
         }
       else
@@ -1977,14 +2402,12 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  yyerror_range[1] = yylsp[1-yylen];
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
@@ -2000,13 +2423,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2020,7 +2444,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp, ast, scanner);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, ast, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2031,13 +2455,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2048,26 +2470,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (&yylloc, ast, scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2083,20 +2509,19 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp, yylsp, ast, scanner);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, ast, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 311 "parser.y" /* yacc.c:1906  */
+
+#line 465 "parser.y"
 
 
 
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_PARSER_H_INCLUDED
 # define YY_YY_PARSER_H_INCLUDED
 /* Debug traces.  */
@@ -40,7 +45,7 @@
 extern int yydebug;
 #endif
 /* "%code requires" blocks.  */
-#line 36 "parser.y" /* yacc.c:1909  */
+#line 107 "parser.y"
 
 
 #ifndef YY_TYPEDEF_YY_SCANNER_T
@@ -49,49 +54,62 @@ typedef void* yyscan_t;
 #endif
 
 
-#line 53 "parser.h" /* yacc.c:1909  */
+#line 58 "parser.h"
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    END = 0,
-    T_CMP = 258,
-    T_LTE = 259,
-    T_NEQ = 260,
-    T_GTE = 261,
-    T_IF = 262,
-    T_ELSE = 263,
-    T_WHILE = 264,
-    T_FOR = 265,
-    T_FUNC = 266,
-    T_RETURN = 267,
-    T_PRINT = 268,
-    T_NOELSE = 269,
-    T_INC = 270,
-    T_DEC = 271,
-    T_FUNCTION = 272,
-    T_NUM = 273,
-    T_ID = 274,
-    T_STR_LIT = 275
+    YYEMPTY = -2,
+    END = 0,                       /* "EOF"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    T_IF = 258,                    /* T_IF  */
+    T_LTE = 259,                   /* T_LTE  */
+    T_ELSE = 260,                  /* T_ELSE  */
+    T_WHILE = 261,                 /* T_WHILE  */
+    T_FOR = 262,                   /* T_FOR  */
+    T_FUNC = 263,                  /* T_FUNC  */
+    T_RETURN = 264,                /* T_RETURN  */
+    T_CMP = 265,                   /* T_CMP  */
+    T_PRINT = 266,                 /* T_PRINT  */
+    T_NOELSE = 267,                /* T_NOELSE  */
+    T_NEQ = 268,                   /* T_NEQ  */
+    T_GTE = 269,                   /* T_GTE  */
+    T_INC = 270,                   /* T_INC  */
+    T_DEC = 271,                   /* T_DEC  */
+    T_FUNCTION = 272,              /* T_FUNCTION  */
+    T_SWITCH = 273,                /* T_SWITCH  */
+    T_CASE = 274,                  /* T_CASE  */
+    T_DEFAULT = 275,               /* T_DEFAULT  */
+    T_ADD_ASSIGN = 276,            /* T_ADD_ASSIGN  */
+    T_MINUS_ASSIGN = 277,          /* T_MINUS_ASSIGN  */
+    T_TIMES_ASSIGN = 278,          /* T_TIMES_ASSIGN  */
+    T_DIV_ASSIGN = 279,            /* T_DIV_ASSIGN  */
+    T_REM_ASSIGN = 280,            /* T_REM_ASSIGN  */
+    T_NUM = 281,                   /* T_NUM  */
+    T_ID = 282,                    /* T_ID  */
+    T_STR_LIT = 283                /* T_STR_LIT  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
 union YYSTYPE
 {
-#line 56 "parser.y" /* yacc.c:1909  */
+#line 127 "parser.y"
 
 	long number;
 	char* id;
 	char* stringliteral;
 	ast_node* ast;
 
-#line 94 "parser.h" /* yacc.c:1909  */
+#line 110 "parser.h"
+
 };
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
@@ -112,6 +130,8 @@ struct YYLTYPE
 
 
 
+
 int yyparse (ast_node** ast, yyscan_t scanner);
 
+
 #endif /* !YY_YY_PARSER_H_INCLUDED  */
@@ -16,10 +16,12 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
 #include "globals.h"
 #include "ast.h"
 #include "parser.h"
 #include "lexer.h"
+#include "como_compiler_ex.h"
 
 #define YYERROR_VERBOSE
 
@@ -31,6 +33,75 @@ int yyerror(YYLTYPE * lvalp, ast_node** ast, yyscan_t scanner, const char* msg)
 	exit(1);
 }
 
+/* 
+ * target op= value, as target = target op value. The expression on the
+ * left of op= is only known to be a name once it is parsed
+ */
+static ast_node *compound_assignment(YYLTYPE *lvalp, ast_node **ast,
+	yyscan_t scanner, ast_binary_op_type type, ast_node *target, 
+	ast_node *value)
+{
+	if(target->type != AST_NODE_TYPE_ID) {
+		yyerror(lvalp, ast, scanner, "syntax error, unexpected '=' after "
+			"an expression that isn't a name");
+	}
+
+	return ast_node_create_binary_op(AST_BINARY_OP_ASSIGN, 
+		ast_node_create_id(AST_NODE_AS_ID(target)), 
+		ast_node_create_binary_op(type, target, value));
+}
+
+static int case_labels_equal(ast_node *a, ast_node *b)
+{
+	if(a->type != b->type) {
+		return 0;
+	}
+
+	if(a->type == AST_NODE_TYPE_NUMBER) {
+		return a->u1.number_value == b->u1.number_value;
+	}
+
+	return strcmp(a->u1.string_value.value, b->u1.string_value.value) == 0;
+}
+
+/* A switch may have one default, and a label only once */
+static ast_node *switch_statement(YYLTYPE *lvalp, ast_node **ast,
+	yyscan_t scanner, ast_node *expr, ast_node *cases)
+{
+	ast_node_statements *list = &cases->u1.statements_node;
+	size_t i, j, k, l, defaults = 0;
+
+	for(i = 0; i < list->count; i++) {
+		ast_node *labels = list->statement_list[i]->u1.case_node.labels;
+
+		if(labels == NULL) {
+			if(++defaults > 1) {
+				yyerror(lvalp, ast, scanner, 
+					"syntax error, more than one default in switch");
+			}
+			continue;
+		}
+
+		for(j = 0; j < labels->u1.statements_node.count; j++) {
+			ast_node *label = labels->u1.statements_node.statement_list[j];
+			for(k = 0; k <= i; k++) {
+				ast_node *other = list->statement_list[k]->u1.case_node.labels;
+				size_t count = other == NULL ? 0 : k < i 
+					? other->u1.statements_node.count : j;
+				for(l = 0; l < count; l++) {
+					if(case_labels_equal(label, 
+							other->u1.statements_node.statement_list[l])) {
+						yyerror(lvalp, ast, scanner, 
+							"syntax error, duplicate case label in switch");
+					}
+				}
+			}
+		}
+	}
+
+	return ast_node_create_switch(expr, cases);
+}
+
 %}
 
 %code requires {
@@ -95,6 +166,14 @@ typedef void* yyscan_t;
 %token T_INC
 %token T_DEC
 %token T_FUNCTION
+%token T_SWITCH
+%token T_CASE
+%token T_DEFAULT
+%token T_ADD_ASSIGN
+%token T_MINUS_ASSIGN
+%token T_TIMES_ASSIGN
+%token T_DIV_ASSIGN
+%token T_REM_ASSIGN
 
 %token <number> T_NUM
 %token <id> T_ID
@@ -110,6 +189,7 @@ typedef void* yyscan_t;
 %type <ast> optional_argument_list argument_list argument
 %type <ast> return_statement optional_expression
 %type <ast> assignment_statement print_statement
+%type <ast> case_list case_clause case_label_list case_label
 
 %%
 
@@ -118,7 +198,13 @@ start:
 ;
 
 top_statement_list:
- top_statement_list top_statement { ast_node_statement_list_push($1, $2); $$ = $1; }
+ top_statement_list top_statement { 
+	/* With --stream the statement is compiled and executed right away */
+	if(!como_stream_statement($2)) {
+		ast_node_statement_list_push($1, $2);
+	}
+	$$ = $1; 
+ }
  | %empty { $$ = ast_node_create_statement_list(0); }
 ;
 
@@ -156,6 +242,26 @@ assignment_statement:
  		$$ = ast_node_create_binary_op(AST_BINARY_OP_ASSIGN, ast_node_create_id($1), $3); 
  		free($1); 
 	}
+	|
+	expr T_ADD_ASSIGN expr {
+		$$ = compound_assignment(&@2, ast, scanner, AST_BINARY_OP_ADD, $1, $3);
+	}
+	|
+	expr T_MINUS_ASSIGN expr {
+		$$ = compound_assignment(&@2, ast, scanner, AST_BINARY_OP_MINUS, $1, $3);
+	}
+	|
+	expr T_TIMES_ASSIGN expr {
+		$$ = compound_assignment(&@2, ast, scanner, AST_BINARY_OP_TIMES, $1, $3);
+	}
+	|
+	expr T_DIV_ASSIGN expr {
+		$$ = compound_assignment(&@2, ast, scanner, AST_BINARY_OP_DIV, $1, $3);
+	}
+	|
+	expr T_REM_ASSIGN expr {
+		$$ = compound_assignment(&@2, ast, scanner, AST_BINARY_OP_REM, $1, $3);
+	}
 ;
 
 print_statement:
@@ -201,12 +307,50 @@ selection_statement:
  T_FOR '(' assignment_statement ';' expr ';' expr ')' compound_statement {
  	$$ = ast_node_create_for($3, $5, $7, $9);
  }
+ |
+ T_FOR '(' assignment_statement ';' expr ';' assignment_statement ')' compound_statement {
+ 	$$ = ast_node_create_for($3, $5, $7, $9);
+ }
+ |
+ T_SWITCH '(' expr ')' '{' case_list '}' {
+ 	$$ = switch_statement(&@1, ast, scanner, $3, $6);
+ }
+;
+
+case_list:
+ case_list case_clause { ast_node_statement_list_push($1, $2); $$ = $1; }
+ | %empty { $$ = ast_node_create_statement_list(0); }
+;
+
+case_clause:
+ T_CASE case_label_list ':' inner_statement_list { 
+ 	$$ = ast_node_create_case($2, $4); 
+ }
+ |
+ T_DEFAULT ':' inner_statement_list { $$ = ast_node_create_case(NULL, $3); }
+;
+
+case_label_list:
+ case_label { $$ = ast_node_create_statement_list(1, $1); }
+ |
+ case_label_list ',' case_label { ast_node_statement_list_push($1, $3); $$ = $1; }
+;
+
+case_label:
+ T_NUM           { $$ = ast_node_create_number($1); }
+ |
+ '-' T_NUM       { $$ = ast_node_create_number(-$2); }
+ |
+ T_STR_LIT       { $$ = ast_node_create_string_literal($1); free($1); }
 ;
 
 function_decl_statement:
  function_keyword T_ID '('optional_parameter_list')' compound_statement {
 	$$ = ast_node_create_function($2, $4, $6);
 	free($2);
+	/* With --lazy only the location of the body is kept */
+	como_lazy_function($$, @6.first_line, @6.first_column, 
+		@6.last_line, @6.last_column);
  }
 ;
 
@@ -290,6 +434,16 @@ expr:
   	free($1);
  }
  |
+ T_INC T_ID {
+ 	$$ = ast_node_create_prefix_op(AST_PREFIX_OP_INC, ast_node_create_id($2));
+  	free($2);
+ }
+ |
+ T_DEC T_ID {
+ 	$$ = ast_node_create_prefix_op(AST_PREFIX_OP_DEC, ast_node_create_id($2));
+  	free($2);
+ }
+ |
  T_ID '(' optional_argument_list ')' {
 	$$ = ast_node_create_call(ast_node_create_id($1), $3, @1.first_line, @1.first_column);
   	free($1);